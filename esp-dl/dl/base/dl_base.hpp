@@ -29,7 +29,8 @@ struct ArgsType {
     int filter_height;                  /*!< 13 */
     int filter_width;                   /*!< 14 */
     int filter_y_offset;                /*!< 15 filter_width * input_channel */
-    int mac_shift;                      /*!< 16 mac_shift = output.exponent - filter.exponent - input.exponent */
+    int mac_shift;                      /*!< 16 mac_shift = output.exponent - filter.exponent - input.exponent,
+                                           INT_MIN if per-channel */
                                         //
     const void *bias_element;           /*!< 17 */
                                         //
@@ -60,7 +61,7 @@ struct ArgsType {
     int n_remainder;                   /*!< 35 */
     int filter_n_offset;               /*!< 36 filter_height * filter_width * input_channel */
     int filter_w_rs1_1;                /*!< 37 (filter_width >> 1) - 1 */
-    int16_t *filter_channel_factor;    /*!< 38 */
+    int16_t *filter_channel_factor;    /*!< 38 per-channel mac_shift if mac_shift == INT_MIN */
     int input_channel_with_padding;    /*!< 39 */
 
     int filter_y_offset_unaligned;        /*!< 40 */
@@ -91,6 +92,9 @@ struct ArgsType {
     int input_height;  /*!< 61 */
     void *debug_value; /*!< 62 It will malloc 16 bytes memory if malloc_debug_memory = true */
     bool auto_split;
+    const void *winograd_filter_element; /*!< [N, 16, C] filter of conv2d_winograd, NULL if not transformed */
+    bool filter_int4;                    /*!< filter is DATA_TYPE_INT4 in sequence [N, 1, 1, C], 1x1 without pads */
+    const void *sparse_filter_element;   /*!< block-sparse 1x1 filter of conv2d_sparse, NULL if dense */
 };
 
 typedef void (*c_impl_func_s16_t)(DL_S16_BUFFER_TYPE *, int16_t *, const ArgsType<int16_t> &);
@@ -152,6 +156,9 @@ std::vector<ArgsType<feature_t>> get_conv_operation_args(TensorBase *output,
     args.input_element = (feature_t *)input->get_element_ptr();
     args.output_element = (feature_t *)output->get_element_ptr();
     args.filter_element = filter->get_element_ptr();
+    args.filter_int4 = filter->dtype == DATA_TYPE_INT4;
+    // 1 < group < input_channel is grouped conv, its filter is [H, W, C / group, N] like conv
+    bool is_depthwise = group > 1 && group == input->shape.back();
 
     if (input->shape.size() == 3) {
         args.input_height = 1;
@@ -168,7 +175,7 @@ std::vector<ArgsType<feature_t>> get_conv_operation_args(TensorBase *output,
 
         args.filter_height = 1;
         args.filter_width = filter->shape[0];
-        if (group == 1) {
+        if (!is_depthwise) {
             // conv
             args.filter_y_offset = 0;
             args.filter_c = filter->shape[1]; // dw: filter->shape[2]. conv: filter->shape[1].
@@ -199,7 +206,7 @@ std::vector<ArgsType<feature_t>> get_conv_operation_args(TensorBase *output,
 
         args.filter_height = filter->shape[0];
         args.filter_width = filter->shape[1];
-        if (group == 1) {
+        if (!is_depthwise) {
             // conv
             args.filter_y_offset = 0;
             args.filter_c = filter->shape[2]; // dw: filter->shape[3]. conv: filter->shape[2].
@@ -291,7 +298,7 @@ std::vector<ArgsType<feature_t>> get_conv_operation_args(TensorBase *output,
         ? ((feature_t *)args.filter_element + args.n_div_x * args.filter_height * args.filter_width * args.filter_c * u)
         : args.filter_element;
 
-    if (group > 1) {
+    if (is_depthwise) {
         args.filter_w_rs1_1 = (args.filter_width >> 1) - 1;
         args.tie_depth2d_dilation_x_offset = args.dilation_w * args.input_channel * sizeof(feature_t);
         args.tie_depth2d_dilation_y_offset_stable = args.dilation_h * args.input_channel * args.input_width;
@@ -303,6 +310,10 @@ std::vector<ArgsType<feature_t>> get_conv_operation_args(TensorBase *output,
             (args.filter_width - 1) * args.dilation_w + (args.filter_height - 1) * args.dilation_h * args.input_width;
         args.tie_depth2d_next_hwx1 = 16 - args.tie_depth2d_next_hwx1 * args.input_channel * sizeof(feature_t);
     }
+    args.tie_filter_channel_factor = nullptr;
+    args.filter_channel_factor = nullptr;
+    args.winograd_filter_element = nullptr;
+    args.sparse_filter_element = nullptr;
     args.debug_value = nullptr;
     if (malloc_debug_memory) {
         args.debug_value = tool::calloc_aligned(16, 16, 1, MALLOC_CAP_DEFAULT);
@@ -336,6 +347,36 @@ std::vector<ArgsType<feature_t>> get_conv_operation_args(TensorBase *output,
     return m_args;
 }
 
+/**
+ * @brief Switch the args of get_conv_operation_args() to per-channel quantization. The filter has one exponent per
+ * output channel and the bias of channel n is quantized with exponent input.exponent + filter_exponents[n].
+ * NOTE: C/C++ targets only. The ISA kernels of ESP32-S3 and ESP32-P4 take one mac_shift and read the filter in their
+ * own layout.
+ *
+ * @tparam feature_t
+ * @param m_args            args of all tasks
+ * @param output
+ * @param input
+ * @param filter_exponents  exponent of every output channel of filter
+ * @param channel_shift     output.exponent - filter_exponents[n] - input.exponent, must live as long as m_args
+ */
+template <typename feature_t>
+void set_conv_per_channel_args(std::vector<ArgsType<feature_t>> &m_args,
+                               TensorBase *output,
+                               TensorBase *input,
+                               const std::vector<int> &filter_exponents,
+                               std::vector<int16_t> &channel_shift)
+{
+    channel_shift.resize(filter_exponents.size());
+    for (size_t n = 0; n < filter_exponents.size(); n++) {
+        channel_shift[n] = output->exponent - filter_exponents[n] - input->exponent;
+    }
+    for (ArgsType<feature_t> &args : m_args) {
+        args.mac_shift = INT_MIN;
+        args.filter_channel_factor = channel_shift.data();
+    }
+}
+
 template <typename feature_t, typename buffer_t>
 void conv_operation_shell(ArgsType<feature_t> &args,
                           ImplFunc_t<feature_t, feature_t> i_impl_func,
@@ -891,7 +932,7 @@ void conv_operation_shell(ArgsType<feature_t> &args,
             feature_t *input_x_real;
             feature_t *filter_ptr_y;
             feature_t *output_yx = output_ptr;
-            int filter_c_n_offset = args.input_channel;
+            int filter_c_n_offset = args.filter_c; // input_channel / group for grouped conv
             int filter_c_n_ptr_offset = filter_c_n_offset;
 
             for (size_t output_y = 0; output_y < n_h_head; output_y++) {
@@ -1136,11 +1177,6 @@ void conv_operation_shell(ArgsType<feature_t> &args,
         }
     }
 
-    if (args.mac_shift == INT_MIN) {
-        heap_caps_free(args.tie_filter_channel_factor);
-        heap_caps_free(args.filter_channel_factor);
-    }
-
     if (args.debug_value) {
         heap_caps_free(args.debug_value);
         args.debug_value = nullptr;
@@ -2043,11 +2079,6 @@ void dwconv_operation_shell(ArgsType<feature_t> &args,
         }
     }
 
-    if (args.mac_shift == INT_MIN) {
-        heap_caps_free(args.tie_filter_channel_factor);
-        heap_caps_free(args.filter_channel_factor);
-    }
-
     if (args.debug_value) {
         heap_caps_free(args.debug_value);
         args.debug_value = nullptr;
@@ -2726,7 +2757,7 @@ struct resizeArgsType {
     int align_corners;   /*!< 17 */
     float scale_h_inv;   /*!< 18 */
     float scale_w_inv;   /*!< 19 */
-    float *cache;        /*!< 20 */
+    void *cache;         /*!< 20 */
     int input_exponent;  /*!< 21 */
     int output_exponent; /*!< 22 */
 };
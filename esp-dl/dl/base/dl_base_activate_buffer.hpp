@@ -14,12 +14,10 @@ inline void buffer_bias_linear(feature_t *output_ptr, buffer_t *buffer_ptr, cons
     if (args.mac_shift == INT_MIN) // per-channel
     {
         for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
-            // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], 4);
             // Bias
             buffer_ptr[output_c] += bias_ptr[output_c];
             // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], args.filter_channel_factor[output_c] - 4);
+            buffer_ptr[output_c] = tool::shift_and_round(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
 
             tool::truncate(output_ptr[output_c], buffer_ptr[output_c]);
             buffer_ptr[output_c] = 0;
@@ -44,12 +42,10 @@ inline void buffer_bias_relu(feature_t *output_ptr, buffer_t *buffer_ptr, const
     if (args.mac_shift == INT_MIN) // per-channel
     {
         for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
-            // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], 4);
             // Bias
             buffer_ptr[output_c] += bias_ptr[output_c];
             // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], args.filter_channel_factor[output_c] - 4);
+            buffer_ptr[output_c] = tool::shift_and_round(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
             // Activation
             if (buffer_ptr[output_c] < 0)
                 buffer_ptr[output_c] = 0;
@@ -80,12 +76,10 @@ inline void buffer_bias_leakyrelu(feature_t *output_ptr, buffer_t *buffer_ptr, c
     if (args.mac_shift == INT_MIN) // per-channel
     {
         for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
-            // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], 4);
             // Bias
             buffer_ptr[output_c] += bias_ptr[output_c];
             // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], args.filter_channel_factor[output_c] - 4);
+            buffer_ptr[output_c] = tool::shift_and_round(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
             // Activation
             if (buffer_ptr[output_c] < 0) {
                 buffer_ptr[output_c] *= args.activation_alpha;
@@ -121,12 +115,10 @@ inline void buffer_bias_prelu(feature_t *output_ptr, buffer_t *buffer_ptr, const
     if (args.mac_shift == INT_MIN) // per-channel
     {
         for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
-            // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], 4);
             // Bias
             buffer_ptr[output_c] += bias_ptr[output_c];
             // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], args.filter_channel_factor[output_c] - 4);
+            buffer_ptr[output_c] = tool::shift_and_round(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
 
             // Activation
             if (buffer_ptr[output_c] < 0) {
@@ -166,7 +158,7 @@ inline void buffer_0000_linear(feature_t *output_ptr, buffer_t *buffer_ptr, cons
     {
         for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
             // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
+            buffer_ptr[output_c] = tool::shift_and_round(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
 
             tool::truncate(output_ptr[output_c], buffer_ptr[output_c]);
             buffer_ptr[output_c] = 0;
@@ -189,7 +181,7 @@ inline void buffer_0000_relu(feature_t *output_ptr, buffer_t *buffer_ptr, const
     {
         for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
             // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
+            buffer_ptr[output_c] = tool::shift_and_round(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
             // Activation
             if (buffer_ptr[output_c] < 0)
                 buffer_ptr[output_c] = 0;
@@ -218,7 +210,7 @@ inline void buffer_0000_leakyrelu(feature_t *output_ptr, buffer_t *buffer_ptr, c
     {
         for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
             // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
+            buffer_ptr[output_c] = tool::shift_and_round(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
             // Activation
             if (buffer_ptr[output_c] < 0) {
                 buffer_ptr[output_c] *= args.activation_alpha;
@@ -252,7 +244,7 @@ inline void buffer_0000_prelu(feature_t *output_ptr, buffer_t *buffer_ptr, const
     {
         for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
             // right shift
-            buffer_ptr[output_c] = DL_RIGHT_SHIFT(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
+            buffer_ptr[output_c] = tool::shift_and_round(buffer_ptr[output_c], args.filter_channel_factor[output_c]);
             // Activation
             if (buffer_ptr[output_c] < 0) {
                 buffer_ptr[output_c] *= alpha_ptr[output_c];
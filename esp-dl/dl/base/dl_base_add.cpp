@@ -119,6 +119,14 @@ void elemwise_add(elemwiseArgsType<int8_t> *args)
         } else {
             elemwise_func = dl_tie728_s8_add_w1_16_w2_16_unaligned;
         }
+#elif CONFIG_PORTABLE_BOOST
+        if (args->input1_d0 == 1) {
+            elemwise_func = dl_portable_s8_add_n_1;
+        } else if (args->input0_d0 == 1) {
+            elemwise_func = dl_portable_s8_add_1_n;
+        } else {
+            elemwise_func = dl_portable_s8_add_n_n;
+        }
 #else
         if (args->input1_d0 == 1) {
             elemwise_func = c_impl_add_n_1<int8_t>;
@@ -194,6 +202,14 @@ void elemwise_add(elemwiseArgsType<int16_t> *args)
         } else {
             elemwise_func = dl_tie728_s16_add_w1_8_w2_8_unaligned;
         }
+#elif CONFIG_PORTABLE_BOOST
+        if (args->input1_d0 == 1) {
+            elemwise_func = dl_portable_s16_add_n_1;
+        } else if (args->input0_d0 == 1) {
+            elemwise_func = dl_portable_s16_add_1_n;
+        } else {
+            elemwise_func = dl_portable_s16_add_n_n;
+        }
 #else
         if (args->input1_d0 == 1) {
             elemwise_func = c_impl_add_n_1<int16_t>;
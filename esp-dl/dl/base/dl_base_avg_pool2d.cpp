@@ -32,7 +32,8 @@ inline void avgpool2d_hwc(buffer_t *buffer_ptr,
                           PoolArgsType<feature_t> &args)
 {
     float avg_pool_area_inv = 1.f / args.avg_pool_area;
-    float scale = DL_SCALE(args.input_exponent) * avg_pool_area_inv * DL_RESCALE(args.output_exponent);
+    tool::requant_t requant =
+        tool::get_requant(DL_SCALE(args.input_exponent) * avg_pool_area_inv * DL_RESCALE(args.output_exponent));
 
 #if CONFIG_ESP32P4_BOOST
     if constexpr (std::is_same_v<feature_t, int8_t>) {
@@ -49,7 +50,7 @@ inline void avgpool2d_hwc(buffer_t *buffer_ptr,
 #endif
 
     for (size_t output_c = 0; output_c < args.output_channel; output_c++) {
-        tool::truncate(output_ptr[output_c], tool::round(buffer_ptr[output_c] * scale));
+        output_ptr[output_c] = tool::requantize<feature_t>(buffer_ptr[output_c], requant);
         buffer_ptr[output_c] = 0;
     }
 }
@@ -32,6 +32,34 @@ inline void conv2d_11cn(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsTy
     }
 }
 
+template <typename feature_t, typename buffer_t>
+inline void conv2d_11cn_int4(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    // filter in sequence [N, 1, 1, C] of DATA_TYPE_INT4, element i in byte i / 2
+    const uint8_t *filter_element = (const uint8_t *)args.filter_element;
+    for (size_t output_c = 0; output_c < args.output_channel; output_c++) // N
+    {
+        int filter_i = output_c * args.input_channel;
+        const uint8_t *filter_ptr = filter_element + (filter_i >> 1);
+        size_t input_c = 0;
+        buffer_t acc = 0;
+        if (filter_i & 1) { // the filter starts in the high nibble when C is odd
+            acc += input_ptr[0] * ((int8_t)(*filter_ptr++) >> 4);
+            input_c = 1;
+        }
+        for (; input_c + 1 < args.input_channel; input_c += 2) // C
+        {
+            int8_t low, high;
+            tool::unpack_int4(*filter_ptr++, low, high);
+            acc += input_ptr[input_c] * low + input_ptr[input_c + 1] * high;
+        }
+        if (input_c < args.input_channel) {
+            acc += input_ptr[input_c] * tool::get_int4(filter_ptr, 0);
+        }
+        buffer_ptr[output_c] = acc;
+    }
+}
+
 template <typename feature_t, typename buffer_t>
 inline void conv2d_33cn(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
 {
@@ -353,7 +381,11 @@ inline void load_conv2d_11cn_s16(ImplFunc_t<int16_t, int16_t> &i_impl_func,
     return;
 
 #else // C/C++ implementation
+#if CONFIG_PORTABLE_BOOST
+    c_impl_func_sp = dl_portable_s16_conv2d_11cn;
+#else
     c_impl_func_sp = conv2d_11cn<int16_t, DL_S16_BUFFER_TYPE>;
+#endif
     c_impl_func = c_impl_func_sp;
     if (args.bias_element) {
         switch (args.activation_type) {
@@ -615,8 +647,13 @@ inline void load_conv2d_33cn_s16(ImplFunc_t<int16_t, int16_t> &i_impl_func,
     return;
 
 #else // C/C++ implementation
+#if CONFIG_PORTABLE_BOOST
+    c_impl_func_sp = dl_portable_s16_conv2d_33cn;
+    c_impl_func = dl_portable_s16_conv2d_hwcn;
+#else
     c_impl_func_sp = conv2d_33cn<int16_t, DL_S16_BUFFER_TYPE>;
     c_impl_func = conv2d_hwcn<int16_t, DL_S16_BUFFER_TYPE>;
+#endif
     if (args.bias_element) {
         switch (args.activation_type) {
         case Linear:
@@ -840,7 +877,11 @@ inline void load_conv2d_hwcn_s16(ImplFunc_t<int16_t, int16_t> &i_impl_func,
     return;
 
 #else // C/C++ implement
+#if CONFIG_PORTABLE_BOOST
+    c_impl_func_sp = dl_portable_s16_conv2d_hwcn;
+#else
     c_impl_func_sp = conv2d_hwcn<int16_t, DL_S16_BUFFER_TYPE>;
+#endif
     c_impl_func = c_impl_func_sp;
     if (args.bias_element) {
         switch (args.activation_type) {
@@ -1216,6 +1257,21 @@ inline void load_conv2d_s8_per_tensor_c_func(c_impl_func_s8_t &c_impl_func,
                                              n_wise_func_s8_t &n_wise_func,
                                              const ArgsType<int8_t> &args)
 {
+#if CONFIG_PORTABLE_BOOST
+    if (args.filter_height == 1 && args.filter_width == 1) // Filter shape = [1, 1, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_conv2d_11cn;
+        c_impl_func = c_impl_func_sp;
+    } else if (args.filter_height == 3 && args.filter_width == 3) // Filter shape = [3, 3, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_conv2d_33cn;
+        c_impl_func = dl_portable_s8_conv2d_hwcn;
+    } else // Filter shape = [H, W, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_conv2d_hwcn;
+        c_impl_func = c_impl_func_sp;
+    }
+#else
     if (args.filter_height == 1 && args.filter_width == 1) // Filter shape = [1, 1, C, N]
     {
         c_impl_func_sp = conv2d_11cn<int8_t, int32_t>;
@@ -1229,6 +1285,7 @@ inline void load_conv2d_s8_per_tensor_c_func(c_impl_func_s8_t &c_impl_func,
         c_impl_func_sp = conv2d_hwcn<int8_t, int32_t>;
         c_impl_func = c_impl_func_sp;
     }
+#endif
     if (args.bias_element) {
         switch (args.activation_type) {
         case Linear:
@@ -1267,6 +1324,21 @@ inline void load_conv2d_s8_per_channel_c_func(c_impl_func_s8_t &c_impl_func,
                                               n_wise_func_s8_t &n_wise_func,
                                               const ArgsType<int8_t> &args)
 {
+#if CONFIG_PORTABLE_BOOST
+    if (args.filter_height == 1 && args.filter_width == 1) // Filter shape = [1, 1, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_conv2d_11cn;
+        c_impl_func = c_impl_func_sp;
+    } else if (args.filter_height == 3 && args.filter_width == 3) // Filter shape = [3, 3, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_conv2d_33cn;
+        c_impl_func = dl_portable_s8_conv2d_hwcn;
+    } else // Filter shape = [H, W, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_conv2d_hwcn;
+        c_impl_func = c_impl_func_sp;
+    }
+#else
     if (args.filter_height == 1 && args.filter_width == 1) // Filter shape = [1, 1, C, N]
     {
         c_impl_func_sp = conv2d_11cn<int8_t, int32_t>;
@@ -1280,19 +1352,20 @@ inline void load_conv2d_s8_per_channel_c_func(c_impl_func_s8_t &c_impl_func,
         c_impl_func_sp = conv2d_hwcn<int8_t, int32_t>;
         c_impl_func = c_impl_func_sp;
     }
+#endif
     if (args.bias_element) {
         switch (args.activation_type) {
         case Linear:
-            n_wise_func = buffer_bias_linear<int8_t, int16_t, int32_t>;
+            n_wise_func = buffer_bias_linear<int8_t, int32_t, int32_t>;
             break;
         case ReLU:
-            n_wise_func = buffer_bias_relu<int8_t, int16_t, int32_t>;
+            n_wise_func = buffer_bias_relu<int8_t, int32_t, int32_t>;
             break;
         case LeakyReLU:
-            n_wise_func = buffer_bias_leakyrelu<int8_t, int16_t, int32_t>;
+            // n_wise_func = buffer_bias_leakyrelu<int8_t, int8_t, int32_t>;
             break;
         case PReLU:
-            n_wise_func = buffer_bias_prelu<int8_t, int8_t, int32_t>;
+            // n_wise_func = buffer_bias_prelu<int8_t, int8_t, int32_t>;
             break;
         }
     } else {
@@ -1304,10 +1377,51 @@ inline void load_conv2d_s8_per_channel_c_func(c_impl_func_s8_t &c_impl_func,
             n_wise_func = buffer_0000_relu<int8_t, int32_t>;
             break;
         case LeakyReLU:
-            n_wise_func = buffer_0000_leakyrelu<int8_t, int32_t>;
+            // n_wise_func = buffer_0000_leakyrelu<int8_t, int32_t>;
             break;
         case PReLU:
-            n_wise_func = buffer_0000_prelu<int8_t, int32_t>;
+            // n_wise_func = buffer_0000_prelu<int8_t, int32_t>;
+            break;
+        }
+    }
+}
+
+inline void load_conv2d_s8_int4_c_func(c_impl_func_s8_t &c_impl_func,
+                                      c_impl_func_s8_t &c_impl_func_sp,
+                                      n_wise_func_s8_t &n_wise_func,
+                                      const ArgsType<int8_t> &args)
+{
+    c_impl_func_sp = conv2d_11cn_int4<int8_t, int32_t>; // Filter shape = [1, 1, C, N]
+    c_impl_func = c_impl_func_sp;
+    // per-tensor and per-channel share the tails
+    if (args.bias_element) {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_bias_linear<int8_t, int32_t, int32_t>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_bias_relu<int8_t, int32_t, int32_t>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_bias_leakyrelu<int8_t, int32_t, int32_t>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_bias_prelu<int8_t, int32_t, int32_t>;
+            break;
+        }
+    } else {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_0000_linear<int8_t, int32_t>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_0000_relu<int8_t, int32_t>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_0000_leakyrelu<int8_t, int32_t>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_0000_prelu<int8_t, int32_t>;
             break;
         }
     }
@@ -1328,16 +1442,23 @@ void conv2d<int8_t, int32_t, int32_t>(void *args_ptr)
     dl_esp32p4_cfg_round(ROUND_MODE_HALF_EVEN);
 #endif
 
-    if (args.filter_height == 1 && args.filter_width == 1) {
-        load_conv2d_11cn_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [1, 1, C, N]
-    } else if (args.filter_height == 3 && args.filter_width == 3) {
-        load_conv2d_33cn_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [3, 3, C, N]
+    if (args.filter_int4) {
+        load_conv2d_s8_int4_c_func(c_impl_func, c_impl_func_sp, n_wise_func, args);
+    } else if (args.mac_shift == INT_MIN) {
+        // per-channel layers are only built on C/C++ targets, see set_conv_per_channel_args()
+        load_conv2d_s8_per_channel_c_func(c_impl_func, c_impl_func_sp, n_wise_func, args);
     } else {
-        load_conv2d_hwcn_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [H, W, C, N]
-    }
+        if (args.filter_height == 1 && args.filter_width == 1) {
+            load_conv2d_11cn_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [1, 1, C, N]
+        } else if (args.filter_height == 3 && args.filter_width == 3) {
+            load_conv2d_33cn_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [3, 3, C, N]
+        } else {
+            load_conv2d_hwcn_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [H, W, C, N]
+        }
 
-    if (!i_impl_func || !i_impl_func_sp) {
-        load_conv2d_s8_per_tensor_c_func(c_impl_func, c_impl_func_sp, n_wise_func, args);
+        if (!i_impl_func || !i_impl_func_sp) {
+            load_conv2d_s8_per_tensor_c_func(c_impl_func, c_impl_func_sp, n_wise_func, args);
+        }
     }
 
     conv_operation_shell<int8_t, int32_t>(args, i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func);
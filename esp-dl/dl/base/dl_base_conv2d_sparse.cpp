@@ -0,0 +1,240 @@
+#include "dl_base_conv2d_sparse.hpp"
+
+#include "dl_base_activate_buffer.hpp"
+#include "dl_base_activate_output.hpp"
+#include "dl_base_isa.hpp"
+#include "esp_log.h"
+
+namespace dl {
+namespace base {
+static const char *TAG = "conv2d_sparse";
+
+template <typename feature_t>
+sparse_filter_t *conv2d_sparse_pack_filter(
+    const feature_t *filter_element, int output_channel, int input_channel, float min_sparsity, uint32_t caps)
+{
+    const int block_size = 16 / sizeof(feature_t);
+    const int blocks = (input_channel + block_size - 1) / block_size;
+    const int bitmap_words = (blocks + 31) / 32;
+
+    int nonzero_blocks = 0;
+    for (int n = 0; n < output_channel; n++) {
+        const feature_t *filter_n = filter_element + n * input_channel;
+        for (int c = 0; c < input_channel; c += block_size) {
+            for (int i = c; i < DL_MIN(c + block_size, input_channel); i++) {
+                if (filter_n[i]) {
+                    nonzero_blocks++;
+                    break;
+                }
+            }
+        }
+    }
+    if (output_channel * blocks - nonzero_blocks < min_sparsity * output_channel * blocks) {
+        return nullptr;
+    }
+
+    // header, bitmap and kept blocks in one allocation, every part is 16 bytes aligned
+    size_t header_size = (sizeof(sparse_filter_t) + 15) & ~15;
+    size_t bitmap_size = (output_channel * bitmap_words * sizeof(uint32_t) + 15) & ~15;
+    size_t size = header_size + bitmap_size + nonzero_blocks * 16;
+    int8_t *memory = (int8_t *)tool::calloc_aligned(16, size, 1, caps);
+    if (!memory) {
+        ESP_LOGE(TAG, "Failed to allocate %d bytes", (int)size);
+        return nullptr;
+    }
+    sparse_filter_t *sparse = (sparse_filter_t *)memory;
+    uint32_t *bitmap = (uint32_t *)(memory + header_size);
+    feature_t *elements = (feature_t *)(memory + header_size + bitmap_size);
+    sparse->output_channel = output_channel;
+    sparse->input_channel = input_channel;
+    sparse->block_size = block_size;
+    sparse->bitmap_words = bitmap_words;
+    sparse->nonzero_blocks = nonzero_blocks;
+    sparse->bitmap = bitmap;
+    sparse->elements = elements;
+
+    for (int n = 0; n < output_channel; n++) {
+        const feature_t *filter_n = filter_element + n * input_channel;
+        uint32_t *bitmap_n = bitmap + n * bitmap_words;
+        for (int b = 0; b < blocks; b++) {
+            int c = b * block_size;
+            int length = DL_MIN(block_size, input_channel - c);
+            bool nonzero = false;
+            for (int i = 0; i < length; i++) {
+                nonzero |= filter_n[c + i] != 0;
+            }
+            if (nonzero) {
+                bitmap_n[b >> 5] |= 1u << (b & 31);
+                for (int i = 0; i < length; i++) {
+                    elements[i] = filter_n[c + i];
+                }
+                elements += block_size;
+            }
+        }
+    }
+    return sparse;
+}
+
+template sparse_filter_t *conv2d_sparse_pack_filter<int8_t>(const int8_t *, int, int, float, uint32_t);
+template sparse_filter_t *conv2d_sparse_pack_filter<int16_t>(const int16_t *, int, int, float, uint32_t);
+
+template <typename feature_t, typename buffer_t>
+inline void conv2d_11cn_sparse(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    // kept blocks in sequence [N, blocks of C], bitmap in sequence [N, bitmap_words]
+    const sparse_filter_t *sparse = (const sparse_filter_t *)args.sparse_filter_element;
+    const feature_t *filter_element = (const feature_t *)sparse->elements;
+    const uint32_t *bitmap = sparse->bitmap;
+    const int block_size = sparse->block_size;
+    const int full_blocks = args.input_channel / block_size;
+
+    for (int output_c = 0; output_c < args.output_channel; output_c++) // N
+    {
+        buffer_t acc = 0;
+        for (int w = 0; w < sparse->bitmap_words; w++) {
+            uint32_t bits = *bitmap++;
+            while (bits) {
+                int b = (w << 5) + __builtin_ctz(bits);
+                bits &= bits - 1;
+                const feature_t *input_b = input_ptr + b * block_size;
+                if (b < full_blocks) {
+                    for (int i = 0; i < 16 / (int)sizeof(feature_t); i++) {
+                        acc += input_b[i] * filter_element[i];
+                    }
+                } else {
+                    for (int i = 0; i < args.input_channel - b * block_size; i++) {
+                        acc += input_b[i] * filter_element[i];
+                    }
+                }
+                filter_element += block_size;
+            }
+        }
+        *buffer_ptr++ = acc;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// specialize conv2d_sparse<int16_t, int32_t, DL_S16_BUFFER_TYPE>
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline void load_conv2d_sparse_s16(ImplFunc_t<int16_t, int16_t> &i_impl_func,
+                                   ImplFunc_t<int16_t, int16_t> &i_impl_func_sp,
+                                   c_impl_func_s16_t &c_impl_func,
+                                   c_impl_func_s16_t &c_impl_func_sp,
+                                   n_wise_func_s16_t &n_wise_func,
+                                   const ArgsType<int16_t> &args)
+{
+    // C/C++ implementation
+    c_impl_func_sp = conv2d_11cn_sparse<int16_t, DL_S16_BUFFER_TYPE>;
+    c_impl_func = c_impl_func_sp;
+    if (args.bias_element) {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_bias_linear<int16_t, DL_S16_BUFFER_TYPE, DL_S16_BUFFER_TYPE>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_bias_relu<int16_t, DL_S16_BUFFER_TYPE, DL_S16_BUFFER_TYPE>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_bias_leakyrelu<int16_t, int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_bias_prelu<int16_t, int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        }
+    } else {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_0000_linear<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_0000_relu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_0000_leakyrelu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_0000_prelu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        }
+    }
+}
+
+template <>
+void conv2d_sparse<int16_t, int32_t, int64_t>(void *const args_ptr)
+{
+    ArgsType<int16_t> &args = *((ArgsType<int16_t> *)args_ptr);
+
+    ImplFunc_t<int16_t, int16_t> i_impl_func;
+    ImplFunc_t<int16_t, int16_t> i_impl_func_sp;
+    c_impl_func_s16_t c_impl_func = NULL;
+    c_impl_func_s16_t c_impl_func_sp = NULL;
+    n_wise_func_s16_t n_wise_func = NULL;
+
+    load_conv2d_sparse_s16(i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func, args);
+
+    conv_operation_shell<int16_t, int64_t>(args, i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// specialize conv2d_sparse<int8_t, int32_t, int32_t>
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline void load_conv2d_sparse_s8(ImplFunc_t<int8_t, int8_t> &i_impl_func,
+                                  ImplFunc_t<int8_t, int8_t> &i_impl_func_sp,
+                                  c_impl_func_s8_t &c_impl_func,
+                                  c_impl_func_s8_t &c_impl_func_sp,
+                                  n_wise_func_s8_t &n_wise_func,
+                                  const ArgsType<int8_t> &args)
+{
+    // C/C++ implementation
+    c_impl_func_sp = conv2d_11cn_sparse<int8_t, int32_t>;
+    c_impl_func = c_impl_func_sp;
+    if (args.bias_element) {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_bias_linear<int8_t, int32_t, int32_t>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_bias_relu<int8_t, int32_t, int32_t>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_bias_leakyrelu<int8_t, int8_t, int32_t>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_bias_prelu<int8_t, int8_t, int32_t>;
+            break;
+        }
+    } else {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_0000_linear<int8_t, int32_t>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_0000_relu<int8_t, int32_t>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_0000_leakyrelu<int8_t, int32_t>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_0000_prelu<int8_t, int32_t>;
+            break;
+        }
+    }
+}
+
+template <>
+void conv2d_sparse<int8_t, int32_t, int32_t>(void *const args_ptr)
+{
+    ArgsType<int8_t> &args = *((ArgsType<int8_t> *)args_ptr);
+
+    ImplFunc_t<int8_t, int8_t> i_impl_func;
+    ImplFunc_t<int8_t, int8_t> i_impl_func_sp;
+    c_impl_func_s8_t c_impl_func = NULL;
+    c_impl_func_s8_t c_impl_func_sp = NULL;
+    n_wise_func_s8_t n_wise_func = NULL;
+
+    load_conv2d_sparse_s8(i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func, args);
+
+    conv_operation_shell<int8_t, int32_t>(args, i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func);
+}
+} // namespace base
+} // namespace dl
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "dl_base.hpp"
+
+#ifndef DL_CONV_SPARSE_MIN_SPARSITY
+#define DL_CONV_SPARSE_MIN_SPARSITY 0.5f /*!< min ratio of zero blocks to use conv2d_sparse, > 1 disables it */
+#endif
+
+namespace dl {
+namespace base {
+/**
+ * @brief Block-sparse filter of 1x1 conv2d. Every output channel is split along C into blocks of 16 bytes, the width
+ * of the vector registers, and only the blocks with nonzero elements are kept.
+ */
+typedef struct {
+    int output_channel;     /*!< N */
+    int input_channel;      /*!< C */
+    int block_size;         /*!< elements in a block, 16 / sizeof(feature_t) */
+    int bitmap_words;       /*!< uint32_t words of the bitmap of one output channel */
+    int nonzero_blocks;     /*!< number of blocks kept in elements */
+    const uint32_t *bitmap; /*!< [N, bitmap_words], bit b is set if block b of the channel is kept */
+    const void *elements;   /*!< kept blocks in sequence of N and C, the last block of a channel is padded with 0 */
+} sparse_filter_t;
+
+/**
+ * @brief Pack the filter of 1x1 conv2d into block-sparse format if enough blocks are zero.
+ * NOTE: filter in sequence [N, 1, 1, C], the layout of C/C++ implementation.
+ *
+ * @tparam feature_t       int8_t or int16_t
+ * @param filter_element   filter of conv2d
+ * @param output_channel   N
+ * @param input_channel    C
+ * @param min_sparsity     min ratio of zero blocks, the filter is not packed if it is denser
+ * @param caps             bitwise OR of MALLOC_CAP_* flags indicating the type of memory to be returned
+ * @return sparse_filter_t with bitmap and elements in the same allocation, free it by heap_caps_free(). NULL if the
+ * filter is too dense, then the dense conv2d() should be used.
+ */
+template <typename feature_t>
+sparse_filter_t *conv2d_sparse_pack_filter(const feature_t *filter_element,
+                                           int output_channel,
+                                           int input_channel,
+                                           float min_sparsity = DL_CONV_SPARSE_MIN_SPARSITY,
+                                           uint32_t caps = MALLOC_CAP_DEFAULT);
+
+/**
+ * @brief 1x1 conv2d with block-sparse filter, the MACs of zero blocks are skipped. The output is the same as
+ * conv2d().
+ * NOTE: args.sparse_filter_element must be the output of conv2d_sparse_pack_filter().
+ *
+ * @tparam feature_t
+ * @tparam bias_t
+ * @tparam buffer_t
+ * @param args_ptr
+ */
+template <typename feature_t, typename bias_t, typename buffer_t>
+void conv2d_sparse(void *const args_ptr);
+} // namespace base
+} // namespace dl
@@ -0,0 +1,263 @@
+#include "dl_base_conv2d_winograd.hpp"
+
+#include "dl_base_activate_buffer.hpp"
+#include "dl_base_activate_output.hpp"
+#include "esp_log.h"
+
+namespace dl {
+namespace base {
+static const char *TAG = "conv2d_winograd";
+
+template <typename feature_t>
+struct winograd_type {};
+
+template <>
+struct winograd_type<int8_t> {
+    typedef int16_t filter_t;    // |U| <= 9 * 128
+    typedef int16_t transform_t; // |V| <= 4 * 128
+    typedef int32_t buffer_t;
+};
+
+template <>
+struct winograd_type<int16_t> {
+    typedef int32_t filter_t;    // |U| <= 9 * 32768
+    typedef int32_t transform_t; // |V| <= 4 * 32768
+    typedef DL_S16_BUFFER_TYPE buffer_t;
+};
+
+template <typename feature_t>
+void *conv2d_winograd_transform_filter(const feature_t *filter_element,
+                                       int output_channel,
+                                       int input_channel,
+                                       uint32_t caps)
+{
+    typedef typename winograd_type<feature_t>::filter_t filter_t;
+    typedef typename winograd_type<feature_t>::buffer_t buffer_t;
+
+    filter_t *winograd_filter =
+        (filter_t *)tool::malloc_aligned(16, output_channel * 16 * input_channel * sizeof(filter_t), caps);
+    if (!winograd_filter) {
+        ESP_LOGE(TAG, "Failed to allocate %d bytes", (int)(output_channel * 16 * input_channel * sizeof(filter_t)));
+        return nullptr;
+    }
+
+    int max_u = 0;
+    for (int n = 0; n < output_channel; n++) {
+        const feature_t *g = filter_element + n * 9 * input_channel;
+        filter_t *u = winograd_filter + n * 16 * input_channel;
+        for (int c = 0; c < input_channel; c++) {
+            // t = G * g, rows of G are [2, 0, 0], [1, 1, 1], [1, -1, 1], [0, 0, 2]
+            int t[12];
+            for (int j = 0; j < 3; j++) {
+                int g0 = g[j * input_channel + c];
+                int g1 = g[(3 + j) * input_channel + c];
+                int g2 = g[(6 + j) * input_channel + c];
+                t[j] = 2 * g0;
+                t[3 + j] = g0 + g1 + g2;
+                t[6 + j] = g0 - g1 + g2;
+                t[9 + j] = 2 * g2;
+            }
+            // U = t * G^T
+            for (int i = 0; i < 4; i++) {
+                int *t_i = t + 3 * i;
+                int u_i[4] = {2 * t_i[0], t_i[0] + t_i[1] + t_i[2], t_i[0] - t_i[1] + t_i[2], 2 * t_i[2]};
+                for (int j = 0; j < 4; j++) {
+                    u[(4 * i + j) * input_channel + c] = u_i[j];
+                    max_u = DL_MAX(max_u, DL_ABS(u_i[j]));
+                }
+            }
+        }
+    }
+
+    // |sum(U * V)| <= C * max(|U|) * 4 * max(|input|) must fit in buffer_t
+    int64_t max_acc = (int64_t)input_channel * max_u * 4 * (1 << (sizeof(feature_t) * 8 - 1));
+    if (sizeof(buffer_t) == 4 && max_acc > INT32_MAX) {
+        ESP_LOGW(TAG, "Accumulator may overflow, fall back to conv2d");
+        heap_caps_free(winograd_filter);
+        return nullptr;
+    }
+    return winograd_filter;
+}
+
+template void *conv2d_winograd_transform_filter<int8_t>(const int8_t *, int, int, uint32_t);
+template void *conv2d_winograd_transform_filter<int16_t>(const int16_t *, int, int, uint32_t);
+
+template <typename feature_t, typename buffer_t>
+void conv2d_winograd_shell(ArgsType<feature_t> &args,
+                           void (*n_wise_tail)(feature_t *, buffer_t *, const ArgsType<feature_t> &))
+{
+    typedef typename winograd_type<feature_t>::filter_t filter_t;
+    typedef typename winograd_type<feature_t>::transform_t transform_t;
+
+    const int c_num = args.input_channel;
+    const int n_num = args.output_channel;
+    const feature_t *input_ptr = args.input_element;
+    const filter_t *filter_ptr = (const filter_t *)args.winograd_filter_element;
+
+    // [4, N] buffer of one 2x2 tile, [16, C] input transform of one tile, [C] zeros for padding
+    size_t scratch_size = 4 * n_num * sizeof(buffer_t) + 16 * c_num * sizeof(transform_t) + c_num * sizeof(feature_t);
+    int8_t *scratch = (int8_t *)heap_caps_calloc(1, scratch_size, MALLOC_CAP_INTERNAL);
+    if (!scratch) {
+        scratch = (int8_t *)heap_caps_calloc(1, scratch_size, MALLOC_CAP_DEFAULT);
+    }
+    buffer_t *buffer = (buffer_t *)scratch;
+    transform_t *v = (transform_t *)(buffer + 4 * n_num);
+    feature_t *zeros = (feature_t *)(v + 16 * c_num);
+
+    for (int output_y = 0; output_y < args.output_height; output_y += 2) {
+        for (int output_x = 0; output_x < args.output_width; output_x += 2) {
+            // 4x4 input tile, pixels in padding or out of this task are zeros
+            const feature_t *d[16];
+            for (int i = 0; i < 4; i++) {
+                int input_y = output_y + i - args.padding_h_head;
+                for (int j = 0; j < 4; j++) {
+                    int input_x = output_x + j - args.padding_w_head;
+                    bool inside = input_y >= 0 && input_y < args.input_height && input_x >= 0 &&
+                        input_x < args.input_width;
+                    d[4 * i + j] = inside ? input_ptr + input_y * args.input_y_offset + input_x * c_num : zeros;
+                }
+            }
+
+            // V = B^T * d * B, rows of B^T are [1, 0, -1, 0], [0, 1, 1, 0], [0, -1, 1, 0], [0, 1, 0, -1]
+            for (int c = 0; c < c_num; c++) {
+                transform_t t[16];
+                for (int j = 0; j < 4; j++) {
+                    transform_t d0 = d[j][c];
+                    transform_t d1 = d[4 + j][c];
+                    transform_t d2 = d[8 + j][c];
+                    transform_t d3 = d[12 + j][c];
+                    t[j] = d0 - d2;
+                    t[4 + j] = d1 + d2;
+                    t[8 + j] = d2 - d1;
+                    t[12 + j] = d1 - d3;
+                }
+                for (int i = 0; i < 4; i++) {
+                    transform_t *t_i = t + 4 * i;
+                    v[(4 * i) * c_num + c] = t_i[0] - t_i[2];
+                    v[(4 * i + 1) * c_num + c] = t_i[1] + t_i[2];
+                    v[(4 * i + 2) * c_num + c] = t_i[2] - t_i[1];
+                    v[(4 * i + 3) * c_num + c] = t_i[1] - t_i[3];
+                }
+            }
+
+            // M = sum(U * V) over C, Y = A^T * M * A / 4, rows of A^T are [1, 1, 1, 0], [0, 1, -1, -1]
+            for (int n = 0; n < n_num; n++) {
+                const filter_t *u = filter_ptr + n * 16 * c_num;
+                buffer_t m[16];
+                for (int k = 0; k < 16; k++) {
+                    const filter_t *u_k = u + k * c_num;
+                    const transform_t *v_k = v + k * c_num;
+                    buffer_t acc = 0;
+                    for (int c = 0; c < c_num; c++) {
+                        acc += (buffer_t)u_k[c] * v_k[c];
+                    }
+                    m[k] = acc;
+                }
+                buffer_t s[8];
+                for (int j = 0; j < 4; j++) {
+                    s[j] = m[j] + m[4 + j] + m[8 + j];
+                    s[4 + j] = m[4 + j] - m[8 + j] - m[12 + j];
+                }
+                buffer[n] = (s[0] + s[1] + s[2]) >> 2;
+                buffer[n_num + n] = (s[1] - s[2] - s[3]) >> 2;
+                buffer[2 * n_num + n] = (s[4] + s[5] + s[6]) >> 2;
+                buffer[3 * n_num + n] = (s[5] - s[6] - s[7]) >> 2;
+            }
+
+            // bias, shift and activation of the valid outputs in this tile
+            for (int i = 0; i < 2 && output_y + i < args.output_height; i++) {
+                for (int j = 0; j < 2 && output_x + j < args.output_width; j++) {
+                    feature_t *output_yx = args.output_element + (output_y + i) * args.output_y_offset +
+                        (output_x + j) * args.output_x_offset;
+                    n_wise_tail(output_yx, buffer + (2 * i + j) * n_num, args);
+                }
+            }
+        }
+    }
+
+    heap_caps_free(scratch);
+}
+
+template <>
+void conv2d_winograd<int16_t, int32_t, int64_t>(void *const args_ptr)
+{
+    ArgsType<int16_t> &args = *((ArgsType<int16_t> *)args_ptr);
+    n_wise_func_s16_t n_wise_func = NULL;
+
+    if (args.bias_element) {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_bias_linear<int16_t, DL_S16_BUFFER_TYPE, DL_S16_BUFFER_TYPE>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_bias_relu<int16_t, DL_S16_BUFFER_TYPE, DL_S16_BUFFER_TYPE>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_bias_leakyrelu<int16_t, int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_bias_prelu<int16_t, int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        }
+    } else {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_0000_linear<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_0000_relu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_0000_leakyrelu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_0000_prelu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        }
+    }
+
+    conv2d_winograd_shell<int16_t, DL_S16_BUFFER_TYPE>(args, n_wise_func);
+}
+
+template <>
+void conv2d_winograd<int8_t, int32_t, int32_t>(void *const args_ptr)
+{
+    ArgsType<int8_t> &args = *((ArgsType<int8_t> *)args_ptr);
+    n_wise_func_s8_t n_wise_func = NULL;
+
+    if (args.bias_element) {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_bias_linear<int8_t, int32_t, int32_t>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_bias_relu<int8_t, int32_t, int32_t>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_bias_leakyrelu<int8_t, int8_t, int32_t>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_bias_prelu<int8_t, int8_t, int32_t>;
+            break;
+        }
+    } else {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_0000_linear<int8_t, int32_t>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_0000_relu<int8_t, int32_t>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_0000_leakyrelu<int8_t, int32_t>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_0000_prelu<int8_t, int32_t>;
+            break;
+        }
+    }
+
+    conv2d_winograd_shell<int8_t, int32_t>(args, n_wise_func);
+}
+} // namespace base
+} // namespace dl
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "dl_base.hpp"
+
+namespace dl {
+namespace base {
+/**
+ * @brief Transform the filter of 3x3 conv2d to Winograd F(2x2, 3x3) domain, U = G * g * G^T. G is scaled by 2 so
+ * that U is 4 times of the real one and exact in integer, conv2d_winograd() shifts the result back.
+ * NOTE: filter in sequence [N, 3, 3, C], the layout of C/C++ implementation.
+ *
+ * @tparam feature_t       int8_t or int16_t
+ * @param filter_element   filter of conv2d
+ * @param output_channel   N
+ * @param input_channel    C
+ * @param caps             bitwise OR of MALLOC_CAP_* flags indicating the type of memory to be returned
+ * @return [N, 16, C] of int16_t if feature_t is int8_t, int32_t if feature_t is int16_t. NULL if the accumulator of
+ * conv2d_winograd() may overflow, then the direct conv2d() should be used.
+ */
+template <typename feature_t>
+void *conv2d_winograd_transform_filter(const feature_t *filter_element,
+                                       int output_channel,
+                                       int input_channel,
+                                       uint32_t caps = MALLOC_CAP_DEFAULT);
+
+/**
+ * @brief 3x3, stride 1, dilation 1 conv2d by Winograd F(2x2, 3x3), 16 MACs for every 2x2 outputs instead of 36. All
+ * transforms are exact in integer, so the output is the same as conv2d(). The input transform of one tile of all
+ * channels is kept in internal RAM.
+ * NOTE: args.winograd_filter_element must be the output of conv2d_winograd_transform_filter().
+ *
+ * @tparam feature_t
+ * @tparam bias_t
+ * @tparam buffer_t
+ * @param args_ptr
+ */
+template <typename feature_t, typename bias_t, typename buffer_t>
+void conv2d_winograd(void *const args_ptr);
+} // namespace base
+} // namespace dl
@@ -241,8 +241,13 @@ inline void load_depthwise_conv2d_33c1_s16(ImplFunc_t<int16_t, int16_t> &i_impl_
         }
     }
 #else // C/C++ implementation
+#if CONFIG_PORTABLE_BOOST
+    c_impl_func_sp = dl_portable_s16_depthwise_conv2d_33c1;
+    c_impl_func = dl_portable_s16_depthwise_conv2d_hwc1;
+#else
     c_impl_func_sp = depthwise_conv2d_33c1<int16_t, DL_S16_BUFFER_TYPE>;
     c_impl_func = depthwise_conv2d_hwc1<int16_t, DL_S16_BUFFER_TYPE>;
+#endif
     if (args.bias_element) {
         switch (args.activation_type) {
         case Linear:
@@ -423,7 +428,11 @@ inline void load_depthwise_conv2d_hwc1_s16(ImplFunc_t<int16_t, int16_t> &i_impl_
 
     i_impl_func = i_impl_func_sp;
 #else // C/C++ implementation
+#if CONFIG_PORTABLE_BOOST
+    c_impl_func_sp = dl_portable_s16_depthwise_conv2d_hwc1;
+#else
     c_impl_func_sp = depthwise_conv2d_hwc1<int16_t, DL_S16_BUFFER_TYPE>;
+#endif
     c_impl_func = c_impl_func_sp;
     if (args.bias_element) {
         switch (args.activation_type) {
@@ -698,6 +707,17 @@ inline void load_depthwise_conv2d_s8_per_tensor_c_func(c_impl_func_s8_t &c_impl_
                                                        n_wise_func_s8_t &n_wise_func,
                                                        const ArgsType<int8_t> &args)
 {
+#if CONFIG_PORTABLE_BOOST
+    if (args.filter_height == 3 && args.filter_width == 3) // Filter shape = [3, 3, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_depthwise_conv2d_33c1;
+        c_impl_func = dl_portable_s8_depthwise_conv2d_hwc1;
+    } else // Filter shape = [H, W, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_depthwise_conv2d_hwc1;
+        c_impl_func = c_impl_func_sp;
+    }
+#else
     if (args.filter_height == 3 && args.filter_width == 3) // Filter shape = [3, 3, C, N]
     {
         c_impl_func_sp = depthwise_conv2d_33c1<int8_t, int32_t>;
@@ -707,6 +727,7 @@ inline void load_depthwise_conv2d_s8_per_tensor_c_func(c_impl_func_s8_t &c_impl_
         c_impl_func_sp = depthwise_conv2d_hwc1<int8_t, int32_t>;
         c_impl_func = c_impl_func_sp;
     }
+#endif
     if (args.bias_element) {
         switch (args.activation_type) {
         case Linear:
@@ -745,6 +766,17 @@ inline void load_depthwise_conv2d_s8_per_channel_c_func(c_impl_func_s8_t &c_impl
                                                         n_wise_func_s8_t &n_wise_func,
                                                         const ArgsType<int8_t> &args)
 {
+#if CONFIG_PORTABLE_BOOST
+    if (args.filter_height == 3 && args.filter_width == 3) // Filter shape = [3, 3, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_depthwise_conv2d_33c1;
+        c_impl_func = dl_portable_s8_depthwise_conv2d_hwc1;
+    } else // Filter shape = [H, W, C, N]
+    {
+        c_impl_func_sp = dl_portable_s8_depthwise_conv2d_hwc1;
+        c_impl_func = c_impl_func_sp;
+    }
+#else
     if (args.filter_height == 3 && args.filter_width == 3) // Filter shape = [3, 3, C, N]
     {
         c_impl_func_sp = depthwise_conv2d_33c1<int8_t, int32_t>;
@@ -754,19 +786,20 @@ inline void load_depthwise_conv2d_s8_per_channel_c_func(c_impl_func_s8_t &c_impl
         c_impl_func_sp = depthwise_conv2d_hwc1<int8_t, int32_t>;
         c_impl_func = c_impl_func_sp;
     }
+#endif
     if (args.bias_element) {
         switch (args.activation_type) {
         case Linear:
-            n_wise_func = buffer_bias_linear<int8_t, int16_t, int32_t>;
+            n_wise_func = buffer_bias_linear<int8_t, int32_t, int32_t>;
             break;
         case ReLU:
-            n_wise_func = buffer_bias_relu<int8_t, int16_t, int32_t>;
+            n_wise_func = buffer_bias_relu<int8_t, int32_t, int32_t>;
             break;
         case LeakyReLU:
-            n_wise_func = buffer_bias_leakyrelu<int8_t, int16_t, int32_t>;
+            // n_wise_func = buffer_bias_leakyrelu<int8_t, int32_t, int32_t>;
             break;
         case PReLU:
-            n_wise_func = buffer_bias_prelu<int8_t, int16_t, int32_t>;
+            // n_wise_func = buffer_bias_prelu<int8_t, int32_t, int32_t>;
             break;
         }
     } else {
@@ -778,10 +811,10 @@ inline void load_depthwise_conv2d_s8_per_channel_c_func(c_impl_func_s8_t &c_impl
             n_wise_func = buffer_0000_relu<int8_t, int32_t>;
             break;
         case LeakyReLU:
-            n_wise_func = buffer_0000_leakyrelu<int8_t, int32_t>;
+            // n_wise_func = buffer_0000_leakyrelu<int8_t, int32_t>;
             break;
         case PReLU:
-            n_wise_func = buffer_0000_prelu<int8_t, int32_t>;
+            // n_wise_func = buffer_0000_prelu<int8_t, int32_t>;
             break;
         }
     }
@@ -802,14 +835,19 @@ void depthwise_conv2d<int8_t, int32_t, int32_t>(void *args_ptr)
     dl_esp32p4_cfg_round(ROUND_MODE_HALF_EVEN);
 #endif
 
-    if (args.filter_height == 3 && args.filter_width == 3) {
-        load_depthwise_conv2d_33c1_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [3, 3, C, N]
+    if (args.mac_shift == INT_MIN) {
+        // per-channel layers are only built on C/C++ targets, see set_conv_per_channel_args()
+        load_depthwise_conv2d_s8_per_channel_c_func(c_impl_func, c_impl_func_sp, n_wise_func, args);
     } else {
-        load_depthwise_conv2d_hwc1_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [H, W, C, N]
-    }
+        if (args.filter_height == 3 && args.filter_width == 3) {
+            load_depthwise_conv2d_33c1_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [3, 3, C, N]
+        } else {
+            load_depthwise_conv2d_hwc1_s8(i_impl_func, i_impl_func_sp, args); // Filter shape = [H, W, C, N]
+        }
 
-    if (!i_impl_func || !i_impl_func_sp) {
-        load_depthwise_conv2d_s8_per_tensor_c_func(c_impl_func, c_impl_func_sp, n_wise_func, args);
+        if (!i_impl_func || !i_impl_func_sp) {
+            load_depthwise_conv2d_s8_per_tensor_c_func(c_impl_func, c_impl_func_sp, n_wise_func, args);
+        }
     }
     dwconv_operation_shell<int8_t, int32_t>(
         args, i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func);
@@ -9,37 +9,52 @@ namespace base {
 void dotprod_c(int8_t *input0_ptr, int8_t *input1_ptr, int16_t *output_ptr, int length, int shift)
 {
     int32_t result = 0;
-    float scale = DL_RESCALE(shift);
 
     for (int i = 0; i < length; i++) {
         result += (int32_t)input0_ptr[i] * (int32_t)input1_ptr[i];
     }
 
-    dl::tool::truncate(*output_ptr, tool::round(result * scale));
+    *output_ptr = tool::requantize<int16_t>(result, {1, shift});
 }
 
 void dotprod_c(int8_t *input0_ptr, int16_t *input1_ptr, int16_t *output_ptr, int length, int shift)
 {
     int32_t result = 0;
-    float scale = DL_RESCALE(shift);
 
     for (int i = 0; i < length; i++) {
         result += (int32_t)input0_ptr[i] * (int32_t)input1_ptr[i];
     }
 
-    dl::tool::truncate(*output_ptr, tool::round(result * scale));
+    *output_ptr = tool::requantize<int16_t>(result, {1, shift});
 }
 
 void dotprod_c(int16_t *input0_ptr, int16_t *input1_ptr, int16_t *output_ptr, int length, int shift)
 {
     int64_t result = 0;
-    float scale = DL_RESCALE(shift);
 
     for (int i = 0; i < length; i++) {
         result += (int32_t)input0_ptr[i] * (int32_t)input1_ptr[i];
     }
 
-    dl::tool::truncate(*output_ptr, tool::round(result * scale));
+    *output_ptr = tool::requantize<int16_t>(result, {1, shift});
+}
+
+template <typename T>
+int32_t dotprod_int4_c(const uint8_t *input0_ptr, T *input1_ptr, int length)
+{
+    int32_t result = 0;
+    int i = 0;
+
+    for (; i + 1 < length; i += 2) {
+        int8_t low, high;
+        tool::unpack_int4(*input0_ptr++, low, high);
+        result += (int32_t)low * (int32_t)input1_ptr[i] + (int32_t)high * (int32_t)input1_ptr[i + 1];
+    }
+    if (i < length) {
+        result += (int32_t)tool::get_int4(input0_ptr, 0) * (int32_t)input1_ptr[i];
+    }
+
+    return result;
 }
 
 void dotprod(int8_t *input0_ptr, int8_t *input1_ptr, int16_t *output_ptr, int length, int shift)
@@ -101,10 +116,123 @@ void dotprod(int16_t *input0_ptr, int16_t *input1_ptr, int16_t *output_ptr, int
     }
 }
 
+void dotprod_int4(const uint8_t *input0_ptr, int8_t *input1_ptr, int16_t *output_ptr, int length, int shift)
+{
+    *output_ptr = tool::requantize<int16_t>(dotprod_int4_c(input0_ptr, input1_ptr, length), {1, shift});
+}
+
+void dotprod_int4(const uint8_t *input0_ptr, int16_t *input1_ptr, int16_t *output_ptr, int length, int shift)
+{
+    *output_ptr = tool::requantize<int16_t>(dotprod_int4_c(input0_ptr, input1_ptr, length), {1, shift});
+}
+
 void dotprod(float *input0_ptr, float *input1_ptr, float *output_ptr, int length, int shift)
 {
     dsps_dotprod_f32(input0_ptr, input1_ptr, output_ptr, length);
 }
 
+/**
+ * @brief Tile of R rows x V vectors of mat_mat_dotprod(), the accumulators are kept in registers.
+ */
+template <typename TM, typename TV, typename buffer_t, int R, int V>
+inline void mat_mat_dotprod_tile(TM *matrix, TV *vectors, int16_t *result, int rows, int cols, int shift)
+{
+    buffer_t acc[R][V] = {};
+    for (int k = 0; k < cols; k++) {
+        for (int r = 0; r < R; r++) {
+            buffer_t m = matrix[r * cols + k];
+            for (int v = 0; v < V; v++) {
+                acc[r][v] += m * vectors[v * cols + k];
+            }
+        }
+    }
+    for (int v = 0; v < V; v++) {
+        for (int r = 0; r < R; r++) {
+            result[v * rows + r] = tool::requantize<int16_t>(acc[r][v], {1, shift});
+        }
+    }
+}
+
+template <typename TM, typename TV, typename buffer_t>
+void mat_mat_dotprod_c(TM *matrix, TV *vectors, int16_t *result, int rows, int cols, int num_vectors, int shift)
+{
+    int v = 0;
+    for (; v + 4 <= num_vectors; v += 4) {
+        int i = 0;
+        for (; i + 2 <= rows; i += 2) {
+            mat_mat_dotprod_tile<TM, TV, buffer_t, 2, 4>(
+                matrix + i * cols, vectors + v * cols, result + v * rows + i, rows, cols, shift);
+        }
+        for (; i < rows; i++) {
+            mat_mat_dotprod_tile<TM, TV, buffer_t, 1, 4>(
+                matrix + i * cols, vectors + v * cols, result + v * rows + i, rows, cols, shift);
+        }
+    }
+    for (; v < num_vectors; v++) {
+        int i = 0;
+        for (; i + 2 <= rows; i += 2) {
+            mat_mat_dotprod_tile<TM, TV, buffer_t, 2, 1>(
+                matrix + i * cols, vectors + v * cols, result + v * rows + i, rows, cols, shift);
+        }
+        for (; i < rows; i++) {
+            mat_mat_dotprod_tile<TM, TV, buffer_t, 1, 1>(
+                matrix + i * cols, vectors + v * cols, result + v * rows + i, rows, cols, shift);
+        }
+    }
+}
+
+/**
+ * @brief mat_mat_dotprod() by the dotprod() of every row and vector, for float and the lengths supported by the ISA
+ * dotprod kernels.
+ */
+template <typename TM, typename TV, typename TO>
+void mat_mat_dotprod_rows(TM *matrix, TV *vectors, TO *result, int rows, int cols, int num_vectors, int shift)
+{
+    for (int i = 0; i < rows; i++) {
+        TM *matrix_row = matrix + i * cols;
+        for (int v = 0; v < num_vectors; v++) {
+            dotprod(matrix_row, vectors + v * cols, result + v * rows + i, cols, shift);
+        }
+    }
+}
+
+void mat_mat_dotprod(int8_t *matrix, int8_t *vectors, int16_t *result, int rows, int cols, int num_vectors, int shift)
+{
+#if CONFIG_ESP32P4_BOOST || CONFIG_TIE728_BOOST
+    if (cols % 16 == 0 && shift >= 0) {
+        mat_mat_dotprod_rows(matrix, vectors, result, rows, cols, num_vectors, shift);
+        return;
+    }
+#endif
+    mat_mat_dotprod_c<int8_t, int8_t, int32_t>(matrix, vectors, result, rows, cols, num_vectors, shift);
+}
+
+void mat_mat_dotprod(int8_t *matrix, int16_t *vectors, int16_t *result, int rows, int cols, int num_vectors, int shift)
+{
+#if CONFIG_ESP32P4_BOOST
+    if (cols % 8 == 0 && shift >= 0) {
+        mat_mat_dotprod_rows(matrix, vectors, result, rows, cols, num_vectors, shift);
+        return;
+    }
+#endif
+    mat_mat_dotprod_c<int8_t, int16_t, int32_t>(matrix, vectors, result, rows, cols, num_vectors, shift);
+}
+
+void mat_mat_dotprod(int16_t *matrix, int16_t *vectors, int16_t *result, int rows, int cols, int num_vectors, int shift)
+{
+#if CONFIG_ESP32P4_BOOST || CONFIG_TIE728_BOOST
+    if (cols % 8 == 0 && shift >= 0) {
+        mat_mat_dotprod_rows(matrix, vectors, result, rows, cols, num_vectors, shift);
+        return;
+    }
+#endif
+    mat_mat_dotprod_c<int16_t, int16_t, int64_t>(matrix, vectors, result, rows, cols, num_vectors, shift);
+}
+
+void mat_mat_dotprod(float *matrix, float *vectors, float *result, int rows, int cols, int num_vectors, int shift)
+{
+    mat_mat_dotprod_rows(matrix, vectors, result, rows, cols, num_vectors, shift);
+}
+
 } // namespace base
 } // namespace dl
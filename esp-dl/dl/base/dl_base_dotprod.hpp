@@ -21,6 +21,19 @@ void dotprod(int8_t *input0_ptr, int16_t *input1_ptr, int16_t *output_ptr, int l
 void dotprod(int16_t *input0_ptr, int16_t *input1_ptr, int16_t *output_ptr, int length, int shift = 0);
 void dotprod(float *input0_ptr, float *input1_ptr, float *output_ptr, int length, int shift = 0);
 
+/**
+ * @brief Computes the dot product of a DATA_TYPE_INT4 array and an int8_t or int16_t array. The int4 elements are
+ * unpacked to int8_t in the inner loop, so the packed array is read only once at half of the int8_t bandwidth.
+ *
+ * @param input0_ptr Pointer to the packed int4 array, element 2k in the low nibble of byte k.
+ * @param input1_ptr Pointer to the second input array.
+ * @param output_ptr Pointer to the output array to store the computed result.
+ * @param length Length of the input arrays (number of elements).
+ * @param shift Number of bits to right-shift the result for precision or range adjustment.
+ */
+void dotprod_int4(const uint8_t *input0_ptr, int8_t *input1_ptr, int16_t *output_ptr, int length, int shift = 0);
+void dotprod_int4(const uint8_t *input0_ptr, int16_t *input1_ptr, int16_t *output_ptr, int length, int shift = 0);
+
 /**
  * @brief Performs matrix-vector dot product operation.
  *
@@ -45,5 +58,27 @@ template void mat_vec_dotprod(int8_t *matrix, int8_t *vector, int16_t *result, i
 template void mat_vec_dotprod(int8_t *matrix, int16_t *vector, int16_t *result, int rows, int cols, int shift);
 template void mat_vec_dotprod(int16_t *matrix, int16_t *vector, int16_t *result, int rows, int cols, int shift);
 template void mat_vec_dotprod(float *matrix, float *vector, float *result, int rows, int cols, int shift);
+
+/**
+ * @brief Performs matrix-matrix dot product operation, i.e. the GEMM result = vectors * matrix^T, result[v * rows + i]
+ * = matrix[i] · vectors[v]. The integer versions compute tiles of 2 rows x 4 vectors in registers, every element loaded
+ * is used 2 or 4 times, so it's much faster than calling mat_vec_dotprod() for every vector. The result is the same as
+ * mat_vec_dotprod().
+ *
+ * @param matrix Pointer to the input matrix stored in row-major order.
+ * @param vectors Pointer to the input vectors, num_vectors x cols in row-major order.
+ * @param result Pointer to the output vectors, num_vectors x rows in row-major order.
+ * @param rows The number of rows in the matrix.
+ * @param cols The number of columns in the matrix.
+ * @param num_vectors The number of input vectors.
+ * @param shift Optional parameter to apply a shift to the result (default is 0).
+ */
+void mat_mat_dotprod(
+    int8_t *matrix, int8_t *vectors, int16_t *result, int rows, int cols, int num_vectors, int shift = 0);
+void mat_mat_dotprod(
+    int8_t *matrix, int16_t *vectors, int16_t *result, int rows, int cols, int num_vectors, int shift = 0);
+void mat_mat_dotprod(
+    int16_t *matrix, int16_t *vectors, int16_t *result, int rows, int cols, int num_vectors, int shift = 0);
+void mat_mat_dotprod(float *matrix, float *vectors, float *result, int rows, int cols, int num_vectors, int shift = 0);
 } // namespace base
 } // namespace dl
@@ -0,0 +1,203 @@
+#include "dl_base_grouped_conv2d.hpp"
+
+#include "dl_base_activate_buffer.hpp"
+#include "dl_base_activate_output.hpp"
+#include "dl_base_isa.hpp"
+
+namespace dl {
+namespace base {
+template <typename feature_t, typename buffer_t>
+inline void grouped_conv2d_11cn(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    // filter in sequence [N, 1, 1, C / group]
+    const feature_t *filter_element = (const feature_t *)args.filter_element;
+    int group = args.input_channel / args.filter_c;
+    int group_n = args.output_channel / group;
+    for (size_t g = 0; g < group; g++) // G
+    {
+        feature_t *input_g = input_ptr + g * args.filter_c;
+        for (size_t output_c = 0; output_c < group_n; output_c++) // N / G
+        {
+            buffer_t acc = 0;
+            for (size_t input_c = 0; input_c < args.filter_c; input_c++) // C / G
+            {
+                acc += input_g[input_c] * (*filter_element++);
+            }
+            *buffer_ptr++ = acc;
+        }
+    }
+}
+
+template <typename feature_t, typename buffer_t>
+inline void grouped_conv2d_hwcn(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    // filter in sequence [N, H, W, C / group], filter_y_offset and filter_n_offset are in units of C / group
+    const feature_t *filter_element = (const feature_t *)args.filter_element;
+    int group = args.input_channel / args.filter_c;
+    int group_n = args.output_channel / group;
+    for (size_t g = 0; g < group; g++) // G
+    {
+        feature_t *input_g = input_ptr + g * args.filter_c;
+        for (size_t output_c = 0; output_c < group_n; output_c++) // N / G
+        {
+            feature_t *input_syx_dy = input_g;
+            buffer_t acc = 0;
+            for (size_t filter_y = 0; filter_y < args.filter_height; filter_y++) // H
+            {
+                feature_t *input_syx_dyx = input_syx_dy;
+                for (size_t filter_x = 0; filter_x < args.filter_width; filter_x++) // W
+                {
+                    for (size_t input_c = 0; input_c < args.filter_c; input_c++) // C / G
+                    {
+                        acc += input_syx_dyx[input_c] * (*filter_element++);
+                    }
+                    input_syx_dyx += args.input_dilation_x_offset;
+                }
+                filter_element += args.filter_y_offset;
+                input_syx_dy += args.input_dilation_y_offset;
+            }
+            filter_element += args.filter_n_offset;
+            *buffer_ptr++ = acc;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// specialize grouped_conv2d<int16_t, int32_t, DL_S16_BUFFER_TYPE>
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline void load_grouped_conv2d_s16(ImplFunc_t<int16_t, int16_t> &i_impl_func,
+                                    ImplFunc_t<int16_t, int16_t> &i_impl_func_sp,
+                                    c_impl_func_s16_t &c_impl_func,
+                                    c_impl_func_s16_t &c_impl_func_sp,
+                                    n_wise_func_s16_t &n_wise_func,
+                                    const ArgsType<int16_t> &args)
+{
+    // C/C++ implementation
+    if (args.filter_height == 1 && args.filter_width == 1) // Filter shape = [1, 1, C / group, N]
+    {
+        c_impl_func_sp = grouped_conv2d_11cn<int16_t, DL_S16_BUFFER_TYPE>;
+        c_impl_func = c_impl_func_sp;
+    } else // Filter shape = [H, W, C / group, N]
+    {
+        c_impl_func_sp = grouped_conv2d_hwcn<int16_t, DL_S16_BUFFER_TYPE>;
+        c_impl_func = c_impl_func_sp;
+    }
+    if (args.bias_element) {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_bias_linear<int16_t, DL_S16_BUFFER_TYPE, DL_S16_BUFFER_TYPE>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_bias_relu<int16_t, DL_S16_BUFFER_TYPE, DL_S16_BUFFER_TYPE>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_bias_leakyrelu<int16_t, int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_bias_prelu<int16_t, int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        }
+    } else {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_0000_linear<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_0000_relu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_0000_leakyrelu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_0000_prelu<int16_t, DL_S16_BUFFER_TYPE>;
+            break;
+        }
+    }
+}
+
+template <>
+void grouped_conv2d<int16_t, int32_t, int64_t>(void *const args_ptr)
+{
+    ArgsType<int16_t> &args = *((ArgsType<int16_t> *)args_ptr);
+
+    ImplFunc_t<int16_t, int16_t> i_impl_func;
+    ImplFunc_t<int16_t, int16_t> i_impl_func_sp;
+    c_impl_func_s16_t c_impl_func = NULL;
+    c_impl_func_s16_t c_impl_func_sp = NULL;
+    n_wise_func_s16_t n_wise_func = NULL;
+
+    load_grouped_conv2d_s16(i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func, args);
+
+    conv_operation_shell<int16_t, int64_t>(args, i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// specialize grouped_conv2d<int8_t, int32_t, int32_t>
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+inline void load_grouped_conv2d_s8(ImplFunc_t<int8_t, int8_t> &i_impl_func,
+                                   ImplFunc_t<int8_t, int8_t> &i_impl_func_sp,
+                                   c_impl_func_s8_t &c_impl_func,
+                                   c_impl_func_s8_t &c_impl_func_sp,
+                                   n_wise_func_s8_t &n_wise_func,
+                                   const ArgsType<int8_t> &args)
+{
+    // C/C++ implementation
+    if (args.filter_height == 1 && args.filter_width == 1) // Filter shape = [1, 1, C / group, N]
+    {
+        c_impl_func_sp = grouped_conv2d_11cn<int8_t, int32_t>;
+        c_impl_func = c_impl_func_sp;
+    } else // Filter shape = [H, W, C / group, N]
+    {
+        c_impl_func_sp = grouped_conv2d_hwcn<int8_t, int32_t>;
+        c_impl_func = c_impl_func_sp;
+    }
+    if (args.bias_element) {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_bias_linear<int8_t, int32_t, int32_t>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_bias_relu<int8_t, int32_t, int32_t>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_bias_leakyrelu<int8_t, int8_t, int32_t>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_bias_prelu<int8_t, int8_t, int32_t>;
+            break;
+        }
+    } else {
+        switch (args.activation_type) {
+        case Linear:
+            n_wise_func = buffer_0000_linear<int8_t, int32_t>;
+            break;
+        case ReLU:
+            n_wise_func = buffer_0000_relu<int8_t, int32_t>;
+            break;
+        case LeakyReLU:
+            // n_wise_func = buffer_0000_leakyrelu<int8_t, int32_t>;
+            break;
+        case PReLU:
+            // n_wise_func = buffer_0000_prelu<int8_t, int32_t>;
+            break;
+        }
+    }
+}
+
+template <>
+void grouped_conv2d<int8_t, int32_t, int32_t>(void *const args_ptr)
+{
+    ArgsType<int8_t> &args = *((ArgsType<int8_t> *)args_ptr);
+
+    ImplFunc_t<int8_t, int8_t> i_impl_func;
+    ImplFunc_t<int8_t, int8_t> i_impl_func_sp;
+    c_impl_func_s8_t c_impl_func = NULL;
+    c_impl_func_s8_t c_impl_func_sp = NULL;
+    n_wise_func_s8_t n_wise_func = NULL;
+
+    load_grouped_conv2d_s8(i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func, args);
+
+    conv_operation_shell<int8_t, int32_t>(args, i_impl_func, i_impl_func_sp, c_impl_func, c_impl_func_sp, n_wise_func);
+}
+} // namespace base
+} // namespace dl
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "dl_base.hpp"
+
+namespace dl {
+namespace base {
+/**
+ * @brief grouped conv2d, 1 < group < input_channel. All groups are computed in one call and written into the
+ * interleaved output channels, there is no Split or Concat.
+ * NOTE: filter in sequence [N, H, W, C / group], the N / group filters of one group are adjacent. The bias is not
+ * reset to the layout of ISA.
+ *
+ * @tparam feature_t
+ * @tparam bias_t
+ * @tparam buffer_t
+ * @param args_ptr
+ */
+template <typename feature_t, typename bias_t, typename buffer_t>
+void grouped_conv2d(void *const args_ptr);
+} // namespace base
+} // namespace dl
@@ -11,10 +11,10 @@ void c_impl_mul_n_1(feature_t *output_ptr, feature_t *input0_ptr, feature_t *inp
 {
     elemwiseArgsType<feature_t> *elem_args = static_cast<elemwiseArgsType<feature_t> *>(args);
     int32_t length = elem_args->output_d0;
-    float scale = input1_ptr[0] * elem_args->output_rescale;
+    tool::requant_t requant = tool::get_requant(elem_args->output_rescale);
+    int32_t input1 = input1_ptr[0];
     for (int i = 0; i < length; i++) {
-        float out = input0_ptr[i] * scale;
-        tool::truncate<int32_t>(output_ptr[i], tool::round(out));
+        output_ptr[i] = tool::requantize<feature_t>(input0_ptr[i] * input1, requant);
     }
 }
 
@@ -24,10 +24,10 @@ void c_impl_mul_1_n(feature_t *output_ptr, feature_t *input0_ptr, feature_t *inp
 {
     elemwiseArgsType<feature_t> *elem_args = static_cast<elemwiseArgsType<feature_t> *>(args);
     int32_t length = elem_args->output_d0;
-    float scale = input0_ptr[0] * elem_args->output_rescale;
+    tool::requant_t requant = tool::get_requant(elem_args->output_rescale);
+    int32_t input0 = input0_ptr[0];
     for (int i = 0; i < length; i++) {
-        float out = input1_ptr[i] * scale;
-        tool::truncate<int32_t>(output_ptr[i], tool::round(out));
+        output_ptr[i] = tool::requantize<feature_t>(input0 * input1_ptr[i], requant);
     }
 }
 
@@ -37,11 +37,10 @@ void c_impl_mul_n_n(feature_t *output_ptr, feature_t *input0_ptr, feature_t *inp
 {
     elemwiseArgsType<feature_t> *elem_args = static_cast<elemwiseArgsType<feature_t> *>(args);
     int32_t length = elem_args->output_d0;
-    float scale = elem_args->output_rescale;
+    tool::requant_t requant = tool::get_requant(elem_args->output_rescale);
     for (int i = 0; i < length; i++) {
-        int temp = input0_ptr[i] * input1_ptr[i];
-        float out = temp * scale;
-        tool::truncate<int32_t>(output_ptr[i], tool::round(out));
+        int32_t temp = input0_ptr[i] * input1_ptr[i];
+        output_ptr[i] = tool::requantize<feature_t>(temp, requant);
     }
 }
 
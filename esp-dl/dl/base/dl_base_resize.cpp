@@ -13,9 +13,9 @@ inline void resize_nearest_2x2_c1(feature_t *output_ptr, feature_t *input_ptr, v
     feature_t *output_ptr_1_0 = output_ptr + args_ptr_t->output_y_offset;
     feature_t *output_ptr_1_1 = output_ptr_1_0 + args_ptr_t->output_x_offset;
 
+    tool::requant_t requant = {args_ptr_t->output_scale, args_ptr_t->output_shift};
     for (int i = 0; i < args_ptr_t->input_channel; i++) {
-        feature_t output_value =
-            tool::round((float)(*input_ptr++) * args_ptr_t->output_scale / (1 << args_ptr_t->output_shift));
+        feature_t output_value = tool::requantize<feature_t>(*input_ptr++, requant);
         *(output_ptr_0_0++) = output_value;
         *(output_ptr_0_1++) = output_value;
         *(output_ptr_1_0++) = output_value;
@@ -27,9 +27,13 @@ template <typename feature_t>
 inline void resize_nearest_c1(feature_t *output_ptr, feature_t *input_ptr, void *args_ptr)
 {
     resizeArgsType<feature_t> *args_ptr_t = reinterpret_cast<resizeArgsType<feature_t> *>(args_ptr);
+    if (args_ptr_t->output_scale == 1 && args_ptr_t->output_shift == 0) {
+        memcpy(output_ptr, input_ptr, args_ptr_t->input_channel * sizeof(feature_t));
+        return;
+    }
+    tool::requant_t requant = {args_ptr_t->output_scale, args_ptr_t->output_shift};
     for (int i = 0; i < args_ptr_t->input_channel; i++) {
-        *(output_ptr++) =
-            tool::round((float)(*input_ptr++) * args_ptr_t->output_scale / (1 << args_ptr_t->output_shift));
+        *(output_ptr++) = tool::requantize<feature_t>(*input_ptr++, requant);
     }
 }
 
@@ -49,6 +53,8 @@ inline void load_resize_nearest_2x2_c1_s8(ImplFunc_t<int8_t, int8_t> &impl_func,
     } else {
         impl_func = dl_tie728_s8_unaligned_resize_nearest_2x2_c1;
     }
+#elif CONFIG_PORTABLE_BOOST
+    impl_func = dl_portable_s8_resize_nearest_2x2_c1;
 #else
     impl_func = resize_nearest_2x2_c1<int8_t>;
 #endif
@@ -70,171 +76,281 @@ inline void load_resize_nearest_c1_s8(ImplFunc_t<int8_t, int8_t> &impl_func, con
     } else {
         impl_func = dl_tie728_s8_unaligned_resize_nearest_c1;
     }
+#elif CONFIG_PORTABLE_BOOST
+    impl_func = dl_portable_s8_resize_nearest_c1;
 #else
     impl_func = resize_nearest_c1<int8_t>;
 #endif
 }
 
-// It's for non cache.
+inline void load_resize_nearest_2x2_c1_s16(ImplFunc_t<int16_t, int16_t> &impl_func,
+                                           const resizeArgsType<int16_t> &args)
+{
+    impl_func = resize_nearest_2x2_c1<int16_t>;
+}
+
+inline void load_resize_nearest_c1_s16(ImplFunc_t<int16_t, int16_t> &impl_func, const resizeArgsType<int16_t> &args)
+{
+    impl_func = resize_nearest_c1<int16_t>;
+}
+
+template <typename feature_t>
+struct resize_linear_type {};
+
+template <>
+struct resize_linear_type<int8_t> {
+    typedef int32_t buffer_t;
+    static const int weight_bits = DL_RESIZE_LINEAR_WEIGHT_BITS_S8;
+};
+
+template <>
+struct resize_linear_type<int16_t> {
+    typedef int64_t buffer_t;
+    static const int weight_bits = DL_RESIZE_LINEAR_WEIGHT_BITS_S16;
+};
+
+/**
+ * Input coordinates and fixed-point weights of 1 axis. Aligned with PyTorch, the `coordinate_transformation_mode` of
+ * `linear` is "half_pixel" if not align_corners. The coordinates out of the input are clamped to the border.
+ */
 void linear_coeffs(
-    int out_x, int &in_x, float &ratio_0, float &ratio_1, int in_length, float scale_inv, int align_corners)
+    int out_length, int in_length, int32_t *in_xp, int32_t *weight, float scale_inv, int align_corners, int weight_bits)
 {
-    float fx = 0.f;
-    if (align_corners) {
-        fx = out_x * scale_inv;
-    } else {
-        // Aligned with PyTorch, the `coordinate_transformation_mode` of `linear` is "half_pixel".
-        fx = (out_x + 0.5f) * scale_inv - 0.5f;
+    for (int out_x = 0; out_x < out_length; out_x++) {
+        float fx = align_corners ? out_x * scale_inv : (out_x + 0.5f) * scale_inv - 0.5f;
+        int in_x = static_cast<int>(floorf(fx));
+        fx -= in_x;
+        if (in_x < 0) {
+            in_x = 0;
+            fx = 0.f;
+        }
+        if (in_x >= in_length - 1) {
+            in_x = in_length - 1;
+            fx = 0.f;
+        }
+        int32_t weight_1 = tool::round(fx * (1 << weight_bits));
+        in_xp[out_x * 2] = in_x;
+        in_xp[out_x * 2 + 1] = DL_MIN(in_x + 1, in_length - 1);
+        weight[out_x * 2] = (1 << weight_bits) - weight_1;
+        weight[out_x * 2 + 1] = weight_1;
     }
+}
 
-    in_x = static_cast<int>(floorf(fx));
-    fx -= in_x;
+template <typename feature_t>
+void *resize_cache_init(const resizeArgsType<feature_t> &args)
+{
+    int len = 0;
+    if (args.resize_mode == RESIZE_NEAREST) {
+        if (args.scale_h == 2 && args.scale_w == 2) {
+            return nullptr;
+        }
+        len = args.output_width + args.output_height;
+    } else if (args.resize_mode == RESIZE_LINEAR) {
+        if (is_resize_linear_2x(args)) {
+            if (args.dims == 3) {
+                return nullptr;
+            }
+            len = args.input_width * args.input_channel;
+        } else {
+            len = args.output_width * 4 + args.output_height * 4;
+            if (args.dims == 4) {
+                len += args.output_width * args.input_channel * 2;
+            }
+        }
+    } else {
+        return nullptr;
+    }
 
-    if (in_x < 0) {
-        in_x = 0;
-        fx = 0.f;
+    int32_t *cache = static_cast<int32_t *>(tool::calloc_aligned(16, len, sizeof(int32_t), MALLOC_CAP_DEFAULT));
+    if (!cache) {
+        ESP_LOGE("resize", "Failed to allocate %d bytes of cache", (int)(len * sizeof(int32_t)));
+        return nullptr;
     }
-    if (in_x >= in_length - 1) {
-        in_x = in_length - 2;
-        fx = 1.f;
+
+    if (args.resize_mode == RESIZE_NEAREST) {
+        // Aligned with PyTorch, the `coordinate_transformation_mode` of `nearest` is "asymmetric".
+        int32_t *in_xp = cache;
+        int32_t *in_yp = cache + args.output_width;
+        for (int x = 0; x < args.output_width; x++) {
+            in_xp[x] = std::min((int)(x * args.scale_w_inv), (args.input_width - 1)) * args.input_channel;
+        }
+        for (int y = 0; y < args.output_height; y++) {
+            in_yp[y] = std::min((int)(y * args.scale_h_inv), (args.input_height - 1));
+        }
+    } else if (!is_resize_linear_2x(args)) {
+        int weight_bits = resize_linear_type<feature_t>::weight_bits;
+        int32_t *in_xp = cache;
+        int32_t *in_yp = cache + args.output_width * 4;
+        linear_coeffs(args.output_width,
+                      args.input_width,
+                      in_xp,
+                      in_xp + args.output_width * 2,
+                      args.scale_w_inv,
+                      args.align_corners,
+                      weight_bits);
+        linear_coeffs(args.output_height,
+                      args.input_height,
+                      in_yp,
+                      in_yp + args.output_height * 2,
+                      args.scale_h_inv,
+                      args.align_corners,
+                      weight_bits);
+        for (int x = 0; x < args.output_width * 2; x++) {
+            in_xp[x] *= args.input_channel;
+        }
     }
-    ratio_0 = 1.f - fx;
-    ratio_1 = fx;
+    return cache;
 }
 
-// It's for cache in_x coordinates + in_x ratio.
-void linear_coeffs(int out_length, int in_length, int *in_xp, float *ratio, float scale_inv, int align_corners)
+template void *resize_cache_init<int8_t>(const resizeArgsType<int8_t> &args);
+template void *resize_cache_init<int16_t>(const resizeArgsType<int16_t> &args);
+
+template <typename feature_t>
+inline void resize_linear_hresize(int32_t *row, const feature_t *input_y, const int32_t *in_xp, const int32_t *weight,
+                                  int output_width, int channel)
 {
-    int in_x;
-    float ratio_0, ratio_1;
-    for (int out_x = 0; out_x < out_length; out_x++) {
-        linear_coeffs(out_x, in_x, ratio_0, ratio_1, in_length, scale_inv, align_corners);
-        in_xp[out_x] = in_x;
-        ratio[out_x * 2] = ratio_0;
-        ratio[out_x * 2 + 1] = ratio_1;
+    for (int x = 0; x < output_width; x++) {
+        const feature_t *input_x0 = input_y + in_xp[x * 2];
+        const feature_t *input_x1 = input_y + in_xp[x * 2 + 1];
+        int32_t weight_0 = weight[x * 2];
+        int32_t weight_1 = weight[x * 2 + 1];
+        for (int c = 0; c < channel; c++) {
+            row[c] = input_x0[c] * weight_0 + input_x1[c] * weight_1;
+        }
+        row += channel;
     }
 }
 
 template <typename feature_t>
-inline void resize_linear_c1(const resizeArgsType<feature_t> &args)
+void resize_linear_c1(const resizeArgsType<feature_t> &args)
 {
-    int in_x, in_y;
-    float x_ratio_0, x_ratio_1, y_ratio_0, y_ratio_1;
-    float input_scale = DL_SCALE(args.input_exponent);
-    float output_inv_scale = DL_RESCALE(args.output_exponent);
+    typedef typename resize_linear_type<feature_t>::buffer_t buffer_t;
+    const int weight_bits = resize_linear_type<feature_t>::weight_bits;
+    const int max_shift = sizeof(buffer_t) * 8 - 2;
+    const int channel = args.input_channel;
+    const int row_size = args.output_width * channel;
+    const int32_t *in_xp = static_cast<int32_t *>(args.cache);
+    const int32_t *x_weight = in_xp + args.output_width * 2;
 
     if (args.dims == 3) {
         // 1d linear resize
-        int prev_in_x = -2;
-        float *cols0 = args.cache;
-        float *cols1 = cols0 + args.input_channel;
-
+        int shift = DL_MIN(weight_bits + args.output_exponent - args.input_exponent, max_shift);
+        feature_t *output_x = args.output_element;
         for (int x = 0; x < args.output_width; x++) {
-            linear_coeffs(x, in_x, x_ratio_0, x_ratio_1, args.input_width, args.scale_w_inv, args.align_corners);
-
-            if (in_x == prev_in_x) {
-                // reuse all cols
-            } else if (in_x == prev_in_x + 1) {
-                // wresize one col
-                float *cols0_use = cols0;
-                cols0 = cols1;
-                cols1 = cols0_use;
-
-                feature_t *input_x1 = args.input_element + (in_x + 1) * args.input_channel;
-                for (int c = 0; c < args.input_channel; c++) {
-                    cols1[c] = dequantize(input_x1[c], input_scale);
-                }
-            } else {
-                // wresize two cols
-                feature_t *input_x0 = args.input_element + in_x * args.input_channel;
-                feature_t *input_x1 = args.input_element + (in_x + 1) * args.input_channel;
-
-                for (int c = 0; c < args.input_channel; c++) {
-                    cols0[c] = dequantize(input_x0[c], input_scale);
-                    cols1[c] = dequantize(input_x1[c], input_scale);
-                }
-            }
-            prev_in_x = in_x;
-
-            feature_t *output_x = args.output_element + x * args.input_channel;
-            for (int c = 0; c < args.input_channel; c++) {
-                output_x[c] = quantize<feature_t>(cols0[c] * x_ratio_0 + cols1[c] * x_ratio_1, output_inv_scale);
+            const feature_t *input_x0 = args.input_element + in_xp[x * 2];
+            const feature_t *input_x1 = args.input_element + in_xp[x * 2 + 1];
+            int32_t weight_0 = x_weight[x * 2];
+            int32_t weight_1 = x_weight[x * 2 + 1];
+            for (int c = 0; c < channel; c++) {
+                int32_t acc = input_x0[c] * weight_0 + input_x1[c] * weight_1;
+                tool::truncate(output_x[c], tool::shift_and_round(acc, shift));
             }
+            output_x += channel;
         }
-    } else if (args.dims == 4) {
-        // 2d linear resize
-        int prev_in_y = -2;
-        int *in_xp = reinterpret_cast<int *>(args.cache);
-        float *ratio = args.cache + args.output_width;
-        float *rows0 = args.cache + args.output_width + args.output_width * 2;
-        float *rows1 = rows0 + args.output_width * args.input_channel;
-        // Cache the calculation results of the width in advance to avoid repeated calculations.
-        linear_coeffs(args.output_width, args.input_width, in_xp, ratio, args.scale_w_inv, args.align_corners);
+        return;
+    }
 
-        for (int y = 0; y < args.output_height; y++) {
-            linear_coeffs(y, in_y, y_ratio_0, y_ratio_1, args.input_height, args.scale_h_inv, args.align_corners);
+    // 2d linear resize, 2 horizontally resized rows are cached and reused by the next output rows
+    int shift = DL_MIN(weight_bits * 2 + args.output_exponent - args.input_exponent, max_shift);
+    const int32_t *in_yp = in_xp + args.output_width * 4;
+    const int32_t *y_weight = in_yp + args.output_height * 2;
+    int32_t *rows0 = const_cast<int32_t *>(in_yp) + args.output_height * 4;
+    int32_t *rows1 = rows0 + row_size;
+    int rows0_y = -1, rows1_y = -1;
+    const int input_y_offset = args.input_width * channel;
 
-            if (in_y == prev_in_y) {
-                // reuse all rows
-            } else if (in_y == prev_in_y + 1) {
-                // hresize one row
-                float *rows0_use = rows0;
-                rows0 = rows1;
-                rows1 = rows0_use;
+    for (int y = 0; y < args.output_height; y++) {
+        int in_y0 = in_yp[y * 2];
+        int in_y1 = in_yp[y * 2 + 1];
+        buffer_t weight_0 = y_weight[y * 2];
+        buffer_t weight_1 = y_weight[y * 2 + 1];
 
-                feature_t *input_y1 = args.input_element + (in_y + 1) * args.input_width * args.input_channel;
-                for (int x = 0; x < args.output_width; x++) {
-                    in_x = in_xp[x];
-                    x_ratio_0 = ratio[x * 2];
-                    x_ratio_1 = ratio[x * 2 + 1];
-                    feature_t *input_x0_y1 = input_y1 + in_x * args.input_channel;
-                    feature_t *input_x1_y1 = input_y1 + (in_x + 1) * args.input_channel;
-                    float *rows1_tmp = rows1 + x * args.input_channel;
-
-                    for (int c = 0; c < args.input_channel; c++) {
-                        rows1_tmp[c] = dequantize(input_x0_y1[c], input_scale) * x_ratio_0 +
-                            dequantize(input_x1_y1[c], input_scale) * x_ratio_1;
-                    }
-                }
+        if (in_y0 != rows0_y) {
+            if (in_y0 == rows1_y) {
+                std::swap(rows0, rows1);
+                std::swap(rows0_y, rows1_y);
             } else {
-                // hresize two rows
-                feature_t *input_y0 = args.input_element + in_y * args.input_width * args.input_channel;
-                feature_t *input_y1 = args.input_element + (in_y + 1) * args.input_width * args.input_channel;
-                for (int x = 0; x < args.output_width; x++) {
-                    in_x = in_xp[x];
-                    x_ratio_0 = ratio[x * 2];
-                    x_ratio_1 = ratio[x * 2 + 1];
-                    feature_t *input_x0_y0 = input_y0 + in_x * args.input_channel;
-                    feature_t *input_x1_y0 = input_y0 + (in_x + 1) * args.input_channel;
-                    feature_t *input_x0_y1 = input_y1 + in_x * args.input_channel;
-                    feature_t *input_x1_y1 = input_y1 + (in_x + 1) * args.input_channel;
-                    float *rows0_tmp = rows0 + x * args.input_channel;
-                    float *rows1_tmp = rows1 + x * args.input_channel;
-
-                    for (int c = 0; c < args.input_channel; c++) {
-                        rows0_tmp[c] = dequantize(input_x0_y0[c], input_scale) * x_ratio_0 +
-                            dequantize(input_x1_y0[c], input_scale) * x_ratio_1;
-                        rows1_tmp[c] = dequantize(input_x0_y1[c], input_scale) * x_ratio_0 +
-                            dequantize(input_x1_y1[c], input_scale) * x_ratio_1;
-                    }
-                }
+                resize_linear_hresize(rows0,
+                                      args.input_element + in_y0 * input_y_offset,
+                                      in_xp,
+                                      x_weight,
+                                      args.output_width,
+                                      channel);
+                rows0_y = in_y0;
             }
-            prev_in_y = in_y;
-
-            feature_t *output_y = args.output_element + y * args.output_width * args.input_channel;
-            for (int x = 0; x < args.output_width; x++) {
-                feature_t *output_x_y = output_y + x * args.input_channel;
-                float *rows0_tmp = rows0 + x * args.input_channel;
-                float *rows1_tmp = rows1 + x * args.input_channel;
-                for (int c = 0; c < args.input_channel; c++) {
-                    output_x_y[c] =
-                        quantize<feature_t>(rows0_tmp[c] * y_ratio_0 + rows1_tmp[c] * y_ratio_1, output_inv_scale);
-                }
+        }
+        if (weight_1 && in_y1 != rows1_y) {
+            resize_linear_hresize(
+                rows1, args.input_element + in_y1 * input_y_offset, in_xp, x_weight, args.output_width, channel);
+            rows1_y = in_y1;
+        }
+
+        feature_t *output_y = args.output_element + y * row_size;
+        if (weight_1) {
+            for (int i = 0; i < row_size; i++) {
+                buffer_t acc = rows0[i] * weight_0 + rows1[i] * weight_1;
+                tool::truncate(output_y[i], tool::shift_and_round(acc, shift));
+            }
+        } else {
+            for (int i = 0; i < row_size; i++) {
+                tool::truncate(output_y[i], tool::shift_and_round(rows0[i] * weight_0, shift));
             }
         }
     }
 }
 
+/**
+ * half_pixel 2x upsample, out[2i] = (in[i - 1] + 3 * in[i]) / 4 and out[2i + 1] = (3 * in[i] + in[i + 1]) / 4 on both
+ * axes with the border clamped. The weights are exact, so the output is the same as resize_linear_c1().
+ */
+template <typename feature_t, typename row_t>
+inline void resize_linear_2x_hresize(feature_t *output_ptr, const row_t *row, int input_width, int channel, int shift)
+{
+    for (int x = 0; x < input_width; x++) {
+        const row_t *row_l = row + DL_MAX(x - 1, 0) * channel;
+        const row_t *row_x = row + x * channel;
+        const row_t *row_r = row + DL_MIN(x + 1, input_width - 1) * channel;
+        feature_t *output_r = output_ptr + channel;
+        for (int c = 0; c < channel; c++) {
+            int32_t x3 = row_x[c] * 3;
+            tool::truncate(output_ptr[c], tool::shift_and_round<int32_t>(row_l[c] + x3, shift));
+            tool::truncate(output_r[c], tool::shift_and_round<int32_t>(x3 + row_r[c], shift));
+        }
+        output_ptr += channel * 2;
+    }
+}
+
+template <typename feature_t>
+void resize_linear_2x_c1(const resizeArgsType<feature_t> &args)
+{
+    const int channel = args.input_channel;
+    const int row_size = args.input_width * channel;
+
+    if (args.dims == 3) {
+        int shift = DL_MIN(2 + args.output_exponent - args.input_exponent, 30);
+        resize_linear_2x_hresize(args.output_element, args.input_element, args.input_width, channel, shift);
+        return;
+    }
+
+    // the vertically resized input row is cached, then resized horizontally to the output row
+    int shift = DL_MIN(4 + args.output_exponent - args.input_exponent, 30);
+    int32_t *row = static_cast<int32_t *>(args.cache);
+    for (int y = 0; y < args.output_height; y++) {
+        int in_y = y >> 1;
+        const feature_t *input_y = args.input_element + in_y * row_size;
+        const feature_t *input_n = args.input_element +
+            (y & 1 ? DL_MIN(in_y + 1, args.input_height - 1) : DL_MAX(in_y - 1, 0)) * row_size;
+        for (int i = 0; i < row_size; i++) {
+            row[i] = input_y[i] * 3 + input_n[i];
+        }
+        resize_linear_2x_hresize(args.output_element + y * args.output_width * channel,
+                                 row,
+                                 args.input_width,
+                                 channel,
+                                 shift);
+    }
+}
+
 template <typename feature_t>
 void resize_operation_shell(const resizeArgsType<feature_t> &args, ImplFunc_t<feature_t, feature_t> resize_impl_func)
 {
@@ -252,25 +368,29 @@ void resize_operation_shell(const resizeArgsType<feature_t> &args, ImplFunc_t<fe
                 output_ptr += args.input_channel * 2 * args.input_width;
             }
         } else {
-            // support 1d/2d nearest mode
-            float scale_h_inv = args.scale_h_inv;
-            float scale_w_inv = args.scale_w_inv;
-            // Aligned with PyTorch, the `coordinate_transformation_mode` of `nearest` is "asymmetric".
+            // support 1d/2d nearest mode, the output rows from the same input row are copied
+            const int32_t *in_xp = static_cast<int32_t *>(args.cache);
+            const int32_t *in_yp = in_xp + args.output_width;
+            const int row_size = args.output_width * args.input_channel;
             for (int y = 0; y < args.output_height; y++) {
-                int in_y = std::min((int)(y * scale_h_inv), (args.input_height - 1));
-                feature_t *input_y_ptr = input_ptr + in_y * args.input_width * args.input_channel;
-                feature_t *out_y_ptr = output_ptr + y * args.output_width * args.input_channel;
-
+                feature_t *out_y_ptr = output_ptr + y * row_size;
+                if (y > 0 && in_yp[y] == in_yp[y - 1]) {
+                    tool::copy_memory(out_y_ptr, out_y_ptr - row_size, row_size * sizeof(feature_t));
+                    continue;
+                }
+                feature_t *input_y_ptr = input_ptr + in_yp[y] * args.input_width * args.input_channel;
                 for (int x = 0; x < args.output_width; x++) {
-                    int in_x = std::min((int)(x * scale_w_inv), (args.input_width - 1));
-                    resize_impl_func(
-                        out_y_ptr + x * args.input_channel, input_y_ptr + in_x * args.input_channel, (void *)(&args));
+                    resize_impl_func(out_y_ptr + x * args.input_channel, input_y_ptr + in_xp[x], (void *)(&args));
                 }
             }
         }
     } else if (args.resize_mode == RESIZE_LINEAR) {
-        // Linear does not support instruction acceleration.
-        resize_linear_c1(args);
+        // Linear does not support instruction acceleration, it's fixed-point C/C++ implementation.
+        if (is_resize_linear_2x(args)) {
+            resize_linear_2x_c1(args);
+        } else {
+            resize_linear_c1(args);
+        }
     } else {
         ESP_LOGE("resize", "Don't support this mode: %d.", args.resize_mode);
     }
@@ -297,15 +417,17 @@ void resize<int8_t>(void *args_ptr)
 template <>
 void resize<int16_t>(void *args_ptr)
 {
-    // const resizeArgsType<int16_t> &args = *((resizeArgsType<int16_t> *)args_ptr);
-    // if (args.resize_mode == RESIZE_NEAREST){
-    //     if (args.scale_h == 2 && args.scale_w == 2){
-    //         ImplFunc_t<int16_t, int16_t> impl_func;
-    //         resize_c_impl_func_s16_t c_impl_func = NULL;
-    //         load_resize_nearest_2x2_c1_s16(impl_func, c_impl_func, args);
-    //         resize_operation_shell<int16_t>(args, impl_func, c_impl_func);
-    //     }
-    // }
+    const resizeArgsType<int16_t> &args = *((resizeArgsType<int16_t> *)args_ptr);
+    ImplFunc_t<int16_t, int16_t> impl_func;
+    if (args.resize_mode == RESIZE_NEAREST) {
+        if (args.scale_h == 2 && args.scale_w == 2) {
+            load_resize_nearest_2x2_c1_s16(impl_func, args);
+        } else {
+            // 3d or other 4d
+            load_resize_nearest_c1_s16(impl_func, args);
+        }
+    }
+    resize_operation_shell<int16_t>(args, impl_func);
 }
 
 } // namespace base
@@ -4,6 +4,46 @@
 
 namespace dl {
 namespace base {
+/**
+ * @brief Number of fractional bits of the fixed-point linear weights. The horizontal pass keeps x * w in int32 and the
+ * vertical pass accumulates in int32 for int8 and in int64 for int16.
+ */
+#define DL_RESIZE_LINEAR_WEIGHT_BITS_S8 (11)
+#define DL_RESIZE_LINEAR_WEIGHT_BITS_S16 (16)
+
+/**
+ * @brief Whether the linear resize is the half_pixel 2x upsample, whose weights are always 1/4 and 3/4.
+ *
+ * @tparam feature_t
+ * @param args
+ * @return true if resize() takes the 2x fast path
+ */
+template <typename feature_t>
+inline bool is_resize_linear_2x(const resizeArgsType<feature_t> &args)
+{
+    return args.resize_mode == RESIZE_LINEAR && !args.align_corners && args.scale_w == 2 &&
+        args.output_width == args.input_width * 2 &&
+        (args.dims == 3 || (args.scale_h == 2 && args.output_height == args.input_height * 2));
+}
+
+/**
+ * @brief Allocate and fill the cache of resize(). Everything that only depends on the shapes and scales is computed
+ * here once instead of for every pixel of every inference. All items are int32_t.
+ * RESIZE_NEAREST:       x offset of the input pixel [output_width], y of the input row [output_height].
+ * RESIZE_LINEAR:        x offsets of the 2 input pixels [output_width, 2], x weights [output_width, 2],
+ *                       y of the 2 input rows [output_height, 2], y weights [output_height, 2],
+ *                       2 horizontally resized rows [2, output_width, channel] for 2d resize.
+ * RESIZE_LINEAR 2x:     1 vertically resized input row [input_width, channel] for 2d resize.
+ * The weights are fixed-point with DL_RESIZE_LINEAR_WEIGHT_BITS_S8/S16 fractional bits and the 2 weights of a pixel
+ * sum to exactly 1.
+ *
+ * @tparam feature_t
+ * @param args
+ * @return the cache, NULL if there is nothing to cache
+ */
+template <typename feature_t>
+void *resize_cache_init(const resizeArgsType<feature_t> &args);
+
 
 /**
  * @brief Get the resize operation args object
@@ -13,6 +53,9 @@ namespace base {
  * @param input
  * @param resize_mode
  * @param scales
+ * @param align_corners
+ * @param cache         coordinates and weights of resize_cache_init(), built on the first call and kept by the caller.
+ *                      The caller must free and reset it to NULL when the input or output shape changes.
  * @param runtime_mode
  * @return std::vector<resizeArgsType<feature_t>>
  */
@@ -22,7 +65,7 @@ std::vector<resizeArgsType<feature_t>> get_resize_operation_args(TensorBase *out
                                                                  resize_mode_t resize_mode,
                                                                  const std::vector<float> &scales,
                                                                  const bool align_corners,
-                                                                 float *&cache,
+                                                                 void *&cache,
                                                                  const runtime_mode_t runtime_mode = RUNTIME_MODE_AUTO)
 {
     // input/output shape: NWC/NHWC, scales/sizes shape: NCW/NCHW
@@ -64,16 +107,8 @@ std::vector<resizeArgsType<feature_t>> get_resize_operation_args(TensorBase *out
         args.scale_w_inv = 1 / args.scale_w;
     }
 
-    if (!cache && args.resize_mode == RESIZE_LINEAR) {
-        int len = 0;
-        if (args.dims == 3) {
-            // in_x dequantize
-            len = args.input_channel * 2;
-        } else if (args.dims == 4) {
-            // in_x coordinates + in_x ratio + x linear
-            len = args.output_width + args.output_width * 2 + args.output_width * args.input_channel * 2;
-        }
-        cache = static_cast<float *>(tool::calloc_aligned(16, len, sizeof(float), MALLOC_CAP_DEFAULT));
+    if (!cache) {
+        cache = resize_cache_init(args);
     }
     args.cache = cache;
 
@@ -105,7 +140,8 @@ std::vector<resizeArgsType<feature_t>> get_resize_operation_args(TensorBase *out
 }
 
 /**
- * @brief
+ * @brief Nearest or linear resize of int8/int16 NWC/NHWC feature. The linear resize is computed in fixed point with
+ * the cached coordinates and weights, the output is rounded in the same way as tool::shift_and_round().
  *
  * @tparam feature_t
  * @param args_ptr
@@ -118,6 +118,14 @@ void elemwise_sub(elemwiseArgsType<int8_t> *args)
         } else {
             elemwise_func = dl_tie728_s8_sub_w1_16_w2_16_unaligned;
         }
+#elif CONFIG_PORTABLE_BOOST
+        if (args->input1_d0 == 1) {
+            elemwise_func = dl_portable_s8_sub_n_1;
+        } else if (args->input0_d0 == 1) {
+            elemwise_func = dl_portable_s8_sub_1_n;
+        } else {
+            elemwise_func = dl_portable_s8_sub_n_n;
+        }
 #else
         if (args->input1_d0 == 1) {
             elemwise_func = c_impl_sub_n_1<int8_t>;
@@ -193,6 +201,14 @@ void elemwise_sub(elemwiseArgsType<int16_t> *args)
         } else {
             elemwise_func = dl_tie728_s16_sub_w1_8_w2_8_unaligned;
         }
+#elif CONFIG_PORTABLE_BOOST
+        if (args->input1_d0 == 1) {
+            elemwise_func = dl_portable_s16_sub_n_1;
+        } else if (args->input0_d0 == 1) {
+            elemwise_func = dl_portable_s16_sub_1_n;
+        } else {
+            elemwise_func = dl_portable_s16_sub_n_n;
+        }
 #else
         if (args->input1_d0 == 1) {
             elemwise_func = c_impl_sub_n_1<int16_t>;
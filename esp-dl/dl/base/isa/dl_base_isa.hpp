@@ -14,3 +14,7 @@ extern "C" {
 #include "dl_base_esp32p4.h"
 #endif // CONFIG_IDF_TARGET_ESP32P4
 }
+
+#if CONFIG_PORTABLE_BOOST
+#include "dl_base_portable.hpp"
+#endif
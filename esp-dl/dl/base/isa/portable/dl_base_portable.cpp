@@ -0,0 +1,368 @@
+#include "dl_base_portable.hpp"
+
+#if CONFIG_PORTABLE_BOOST
+#include "dl_base_elemwise.hpp"
+#include "dl_base_resize.hpp"
+#include <limits>
+#include <string.h>
+
+namespace dl {
+namespace base {
+namespace portable {
+/**
+ * One 128-bit register of feature_t, and the same number of lanes widened to product_t and acc_t.
+ * s8:  int8 x 16 -> int16 x 16 product -> int32 x 16 accumulator
+ * s16: int16 x 8 -> int32 x 8 product  -> int64 x 8 accumulator
+ */
+template <typename feature_t>
+struct vec_traits;
+
+template <>
+struct vec_traits<int8_t> {
+    static const int lanes = 16;
+    typedef int16_t product_t;
+    typedef int32_t acc_t;
+    typedef int8_t feature_v __attribute__((vector_size(16)));
+    typedef int16_t product_v __attribute__((vector_size(32)));
+    typedef int32_t acc_v __attribute__((vector_size(64)));
+};
+
+template <>
+struct vec_traits<int16_t> {
+    static const int lanes = 8;
+    typedef int32_t product_t;
+    typedef int64_t acc_t;
+    typedef int16_t feature_v __attribute__((vector_size(16)));
+    typedef int32_t product_v __attribute__((vector_size(32)));
+    typedef int64_t acc_v __attribute__((vector_size(64)));
+};
+
+template <typename vector_t, typename element_t>
+inline vector_t load(const element_t *ptr)
+{
+    vector_t v;
+    memcpy(&v, ptr, sizeof(v)); // unaligned load
+    return v;
+}
+
+template <typename vector_t, typename element_t>
+inline void store(element_t *ptr, const vector_t &v)
+{
+    memcpy(ptr, &v, sizeof(v)); // unaligned store
+}
+
+template <typename feature_t>
+inline typename vec_traits<feature_t>::acc_v mul_wide(const feature_t *a, const feature_t *b)
+{
+    typedef vec_traits<feature_t> T;
+    typename T::product_v a_w = __builtin_convertvector(load<typename T::feature_v>(a), typename T::product_v);
+    typename T::product_v b_w = __builtin_convertvector(load<typename T::feature_v>(b), typename T::product_v);
+    return __builtin_convertvector(a_w * b_w, typename T::acc_v);
+}
+
+template <typename feature_t>
+inline typename vec_traits<feature_t>::acc_t reduce(const typename vec_traits<feature_t>::acc_v &v)
+{
+    typename vec_traits<feature_t>::acc_t sum = 0;
+    for (int i = 0; i < vec_traits<feature_t>::lanes; i++) {
+        sum += v[i];
+    }
+    return sum;
+}
+
+// sum(a[i] * b[i]), i in [0, length)
+template <typename feature_t>
+inline typename vec_traits<feature_t>::acc_t dotprod(const feature_t *a, const feature_t *b, int length)
+{
+    typedef vec_traits<feature_t> T;
+    typename T::acc_v acc_v = {};
+    int i = 0;
+    for (; i + T::lanes <= length; i += T::lanes) {
+        acc_v += mul_wide(a + i, b + i);
+    }
+    typename T::acc_t acc = reduce<feature_t>(acc_v);
+    for (; i < length; i++) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+// buffer[i] += a[i] * b[i], i in [0, length)
+template <typename feature_t, typename buffer_t>
+inline void mac(buffer_t *buffer_ptr, const feature_t *a, const feature_t *b, int length)
+{
+    typedef vec_traits<feature_t> T;
+    typedef buffer_t buffer_v __attribute__((vector_size(sizeof(buffer_t) * T::lanes)));
+    int i = 0;
+    for (; i + T::lanes <= length; i += T::lanes) {
+        buffer_v acc = load<buffer_v>(buffer_ptr + i);
+        acc += __builtin_convertvector(mul_wide(a + i, b + i), buffer_v);
+        store(buffer_ptr + i, acc);
+    }
+    for (; i < length; i++) {
+        buffer_ptr[i] += a[i] * b[i];
+    }
+}
+
+template <typename feature_t, typename buffer_t>
+inline void conv2d_11cn(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    const feature_t *filter_element = (const feature_t *)args.filter_element;
+    for (int output_c = 0; output_c < args.output_channel; output_c++) {
+        buffer_ptr[output_c] = dotprod(input_ptr, filter_element, args.input_channel);
+        filter_element += args.input_channel;
+    }
+}
+
+template <typename feature_t, typename buffer_t>
+inline void conv2d_33cn(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    const feature_t *input[9];
+    int filter_offset[9];
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 3; x++) {
+            input[y * 3 + x] = input_ptr + y * args.input_dilation_y_offset + x * args.input_dilation_x_offset;
+            filter_offset[y * 3 + x] = y * args.filter_y_offset_c + x * args.input_channel;
+        }
+    }
+
+    const feature_t *filter_element = (const feature_t *)args.filter_element;
+    for (int output_c = 0; output_c < args.output_channel; output_c++) {
+        typename vec_traits<feature_t>::acc_t acc = 0;
+        for (int i = 0; i < 9; i++) {
+            acc += dotprod(input[i], filter_element + filter_offset[i], args.input_channel);
+        }
+        buffer_ptr[output_c] = acc;
+        filter_element += args.filter_n_offset_c;
+    }
+}
+
+template <typename feature_t, typename buffer_t>
+inline void conv2d_hwcn(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    const feature_t *filter_element = (const feature_t *)args.filter_element;
+    for (int output_c = 0; output_c < args.output_channel; output_c++) {
+        typename vec_traits<feature_t>::acc_t acc = 0;
+        const feature_t *input_syx_dy = input_ptr;
+        for (int filter_y = 0; filter_y < args.filter_height; filter_y++) {
+            const feature_t *input_syx_dyx = input_syx_dy;
+            for (int filter_x = 0; filter_x < args.filter_width; filter_x++) {
+                acc += dotprod(input_syx_dyx, filter_element, args.input_channel);
+                filter_element += args.input_channel;
+                input_syx_dyx += args.input_dilation_x_offset;
+            }
+            filter_element += args.filter_y_offset;
+            input_syx_dy += args.input_dilation_y_offset;
+        }
+        filter_element += args.filter_n_offset;
+        buffer_ptr[output_c] = acc;
+    }
+}
+
+template <typename feature_t, typename buffer_t>
+inline void depthwise_conv2d_33c1(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    const feature_t *filter_r0 = (const feature_t *)args.filter_element;
+    const feature_t *filter_r1 = filter_r0 + args.filter_y_offset_c;
+    const feature_t *filter_r2 = filter_r1 + args.filter_y_offset_c;
+    const feature_t *input_row_0 = input_ptr;
+
+    for (int filter_x = 0; filter_x < 3; filter_x++) {
+        const feature_t *input_row_1 = input_row_0 + args.input_dilation_y_offset;
+        const feature_t *input_row_2 = input_row_1 + args.input_dilation_y_offset;
+        mac(buffer_ptr, input_row_0, filter_r0, args.input_channel);
+        mac(buffer_ptr, input_row_1, filter_r1, args.input_channel);
+        mac(buffer_ptr, input_row_2, filter_r2, args.input_channel);
+        filter_r0 += args.input_channel;
+        filter_r1 += args.input_channel;
+        filter_r2 += args.input_channel;
+        input_row_0 += args.input_dilation_x_offset;
+    }
+}
+
+template <typename feature_t, typename buffer_t>
+inline void depthwise_conv2d_hwc1(buffer_t *buffer_ptr, feature_t *input_ptr, const ArgsType<feature_t> &args)
+{
+    const feature_t *filter_element = (const feature_t *)args.filter_element;
+    for (int filter_y = 0; filter_y < args.filter_height; filter_y++) {
+        const feature_t *input_yx = input_ptr;
+        for (int filter_x = 0; filter_x < args.filter_width; filter_x++) {
+            mac(buffer_ptr, input_yx, filter_element, args.input_channel);
+            filter_element += args.input_channel;
+            input_yx += args.input_dilation_x_offset;
+        }
+        filter_element += args.filter_y_offset;
+        input_ptr += args.input_dilation_y_offset;
+    }
+}
+
+/**
+ * output = (input * output_scale) >> output_shift, rounding half up and saturated. Same as
+ * tool::round((float)input * output_scale / (1 << output_shift)) on the targets without ESP32-P4 instructions.
+ */
+inline void resize_rescale(int8_t *output_ptr, const int8_t *input_ptr, int length, int scale, int shift)
+{
+    typedef int8_t s8_v __attribute__((vector_size(16)));
+    typedef int32_t s32_v __attribute__((vector_size(64)));
+    int32_t half = shift > 0 ? 1 << (shift - 1) : 0;
+    int i = 0;
+    for (; i + 16 <= length; i += 16) {
+        s32_v x = __builtin_convertvector(load<s8_v>(input_ptr + i), s32_v);
+        x = (x * scale + half) >> shift;
+        x = x > INT8_MAX ? INT8_MAX : x;
+        x = x < INT8_MIN ? INT8_MIN : x;
+        store(output_ptr + i, __builtin_convertvector(x, s8_v));
+    }
+    for (; i < length; i++) {
+        tool::truncate(output_ptr[i], (input_ptr[i] * scale + half) >> shift);
+    }
+}
+
+template <typename feature_t, bool is_sub>
+inline void saturate_arith(feature_t *output_ptr, const feature_t *input0_ptr, const feature_t *input1_ptr, int length)
+{
+    typedef vec_traits<feature_t> T;
+    typedef typename T::feature_v feature_v;
+    typedef typename T::product_v product_v;
+    const typename T::product_t max = std::numeric_limits<feature_t>::max();
+    const typename T::product_t min = std::numeric_limits<feature_t>::min();
+    int i = 0;
+    for (; i + T::lanes <= length; i += T::lanes) {
+        product_v a = __builtin_convertvector(load<feature_v>(input0_ptr + i), product_v);
+        product_v b = __builtin_convertvector(load<feature_v>(input1_ptr + i), product_v);
+        product_v out = is_sub ? a - b : a + b;
+        out = out > max ? max : out;
+        out = out < min ? min : out;
+        store(output_ptr + i, __builtin_convertvector(out, feature_v));
+    }
+    for (; i < length; i++) {
+        int32_t out = is_sub ? input0_ptr[i] - input1_ptr[i] : input0_ptr[i] + input1_ptr[i];
+        tool::truncate<int32_t>(output_ptr[i], out);
+    }
+}
+
+template <typename feature_t, bool is_sub>
+inline void saturate_arith_scalar(
+    feature_t *output_ptr, const feature_t *input_ptr, feature_t scalar, bool scalar_first, int length)
+{
+    const int lanes = vec_traits<feature_t>::lanes;
+    feature_t scalar_vector[lanes];
+    for (int i = 0; i < lanes; i++) {
+        scalar_vector[i] = scalar;
+    }
+
+    int i = 0;
+    for (; i + lanes <= length; i += lanes) {
+        if (scalar_first) {
+            saturate_arith<feature_t, is_sub>(output_ptr + i, scalar_vector, input_ptr + i, lanes);
+        } else {
+            saturate_arith<feature_t, is_sub>(output_ptr + i, input_ptr + i, scalar_vector, lanes);
+        }
+    }
+    for (; i < length; i++) {
+        int32_t a = scalar_first ? scalar : input_ptr[i];
+        int32_t b = scalar_first ? input_ptr[i] : scalar;
+        tool::truncate<int32_t>(output_ptr[i], is_sub ? a - b : a + b);
+    }
+}
+} // namespace portable
+} // namespace base
+} // namespace dl
+
+using namespace dl::base;
+
+void dl_portable_s8_conv2d_11cn(int32_t *buffer_ptr, int8_t *input_ptr, const ArgsType<int8_t> &args)
+{
+    portable::conv2d_11cn(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s8_conv2d_33cn(int32_t *buffer_ptr, int8_t *input_ptr, const ArgsType<int8_t> &args)
+{
+    portable::conv2d_33cn(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s8_conv2d_hwcn(int32_t *buffer_ptr, int8_t *input_ptr, const ArgsType<int8_t> &args)
+{
+    portable::conv2d_hwcn(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s16_conv2d_11cn(DL_S16_BUFFER_TYPE *buffer_ptr, int16_t *input_ptr, const ArgsType<int16_t> &args)
+{
+    portable::conv2d_11cn(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s16_conv2d_33cn(DL_S16_BUFFER_TYPE *buffer_ptr, int16_t *input_ptr, const ArgsType<int16_t> &args)
+{
+    portable::conv2d_33cn(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s16_conv2d_hwcn(DL_S16_BUFFER_TYPE *buffer_ptr, int16_t *input_ptr, const ArgsType<int16_t> &args)
+{
+    portable::conv2d_hwcn(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s8_depthwise_conv2d_33c1(int32_t *buffer_ptr, int8_t *input_ptr, const ArgsType<int8_t> &args)
+{
+    portable::depthwise_conv2d_33c1(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s8_depthwise_conv2d_hwc1(int32_t *buffer_ptr, int8_t *input_ptr, const ArgsType<int8_t> &args)
+{
+    portable::depthwise_conv2d_hwc1(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s16_depthwise_conv2d_33c1(DL_S16_BUFFER_TYPE *buffer_ptr,
+                                           int16_t *input_ptr,
+                                           const ArgsType<int16_t> &args)
+{
+    portable::depthwise_conv2d_33c1(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s16_depthwise_conv2d_hwc1(DL_S16_BUFFER_TYPE *buffer_ptr,
+                                           int16_t *input_ptr,
+                                           const ArgsType<int16_t> &args)
+{
+    portable::depthwise_conv2d_hwc1(buffer_ptr, input_ptr, args);
+}
+
+void dl_portable_s8_resize_nearest_c1(int8_t *output_ptr, int8_t *input_ptr, void *args_ptr)
+{
+    resizeArgsType<int8_t> *args = (resizeArgsType<int8_t> *)args_ptr;
+    portable::resize_rescale(output_ptr, input_ptr, args->input_channel, args->output_scale, args->output_shift);
+}
+
+void dl_portable_s8_resize_nearest_2x2_c1(int8_t *output_ptr, int8_t *input_ptr, void *args_ptr)
+{
+    resizeArgsType<int8_t> *args = (resizeArgsType<int8_t> *)args_ptr;
+    int8_t *output_ptr_0_1 = output_ptr + args->output_x_offset;
+    int8_t *output_ptr_1_0 = output_ptr + args->output_y_offset;
+    int8_t *output_ptr_1_1 = output_ptr_1_0 + args->output_x_offset;
+
+    portable::resize_rescale(output_ptr, input_ptr, args->input_channel, args->output_scale, args->output_shift);
+    memcpy(output_ptr_0_1, output_ptr, args->input_channel);
+    memcpy(output_ptr_1_0, output_ptr, args->input_channel);
+    memcpy(output_ptr_1_1, output_ptr, args->input_channel);
+}
+
+#define DL_PORTABLE_ARITH(name, feature_t, is_sub)                                                                 \
+    void dl_portable_##name##_n_n(feature_t *output_ptr, feature_t *input0_ptr, feature_t *input1_ptr, void *args) \
+    {                                                                                                              \
+        int length = ((elemwiseArgsType<feature_t> *)args)->output_d0;                                             \
+        portable::saturate_arith<feature_t, is_sub>(output_ptr, input0_ptr, input1_ptr, length);                   \
+    }                                                                                                              \
+    void dl_portable_##name##_n_1(feature_t *output_ptr, feature_t *input0_ptr, feature_t *input1_ptr, void *args) \
+    {                                                                                                              \
+        int length = ((elemwiseArgsType<feature_t> *)args)->output_d0;                                             \
+        portable::saturate_arith_scalar<feature_t, is_sub>(output_ptr, input0_ptr, input1_ptr[0], false, length);  \
+    }                                                                                                              \
+    void dl_portable_##name##_1_n(feature_t *output_ptr, feature_t *input0_ptr, feature_t *input1_ptr, void *args) \
+    {                                                                                                              \
+        int length = ((elemwiseArgsType<feature_t> *)args)->output_d0;                                             \
+        portable::saturate_arith_scalar<feature_t, is_sub>(output_ptr, input1_ptr, input0_ptr[0], true, length);   \
+    }
+
+DL_PORTABLE_ARITH(s8_add, int8_t, false)
+DL_PORTABLE_ARITH(s16_add, int16_t, false)
+DL_PORTABLE_ARITH(s8_sub, int8_t, true)
+DL_PORTABLE_ARITH(s16_sub, int16_t, true)
+#endif // CONFIG_PORTABLE_BOOST
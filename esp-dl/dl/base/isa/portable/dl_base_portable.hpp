@@ -0,0 +1,58 @@
+#pragma once
+
+#include "dl_base.hpp"
+
+#if CONFIG_PORTABLE_BOOST
+/**
+ * @brief Kernels written with GCC/Clang vector extensions. They are selected by the load_* functions instead of the
+ * generic C/C++ implementation when the target has no ESP32-P4/TIE728 instructions but the compiler reports a 128-bit
+ * SIMD unit(SSE2, NEON, WASM SIMD), e.g. linux target or host simulation.
+ * The signatures are the same as the C/C++ implementation they replace, and so are the results.
+ */
+
+// conv2d, filter in sequence [N, H, W, C]
+void dl_portable_s8_conv2d_11cn(int32_t *buffer_ptr, int8_t *input_ptr, const dl::base::ArgsType<int8_t> &args);
+void dl_portable_s8_conv2d_33cn(int32_t *buffer_ptr, int8_t *input_ptr, const dl::base::ArgsType<int8_t> &args);
+void dl_portable_s8_conv2d_hwcn(int32_t *buffer_ptr, int8_t *input_ptr, const dl::base::ArgsType<int8_t> &args);
+void dl_portable_s16_conv2d_11cn(DL_S16_BUFFER_TYPE *buffer_ptr,
+                                 int16_t *input_ptr,
+                                 const dl::base::ArgsType<int16_t> &args);
+void dl_portable_s16_conv2d_33cn(DL_S16_BUFFER_TYPE *buffer_ptr,
+                                 int16_t *input_ptr,
+                                 const dl::base::ArgsType<int16_t> &args);
+void dl_portable_s16_conv2d_hwcn(DL_S16_BUFFER_TYPE *buffer_ptr,
+                                 int16_t *input_ptr,
+                                 const dl::base::ArgsType<int16_t> &args);
+
+// depthwise_conv2d, accumulate into a zeroed buffer
+void dl_portable_s8_depthwise_conv2d_33c1(int32_t *buffer_ptr,
+                                          int8_t *input_ptr,
+                                          const dl::base::ArgsType<int8_t> &args);
+void dl_portable_s8_depthwise_conv2d_hwc1(int32_t *buffer_ptr,
+                                          int8_t *input_ptr,
+                                          const dl::base::ArgsType<int8_t> &args);
+void dl_portable_s16_depthwise_conv2d_33c1(DL_S16_BUFFER_TYPE *buffer_ptr,
+                                           int16_t *input_ptr,
+                                           const dl::base::ArgsType<int16_t> &args);
+void dl_portable_s16_depthwise_conv2d_hwc1(DL_S16_BUFFER_TYPE *buffer_ptr,
+                                           int16_t *input_ptr,
+                                           const dl::base::ArgsType<int16_t> &args);
+
+// resize, args_ptr is resizeArgsType<int8_t>. Rescale in integer: (x * output_scale + half) >> output_shift
+void dl_portable_s8_resize_nearest_c1(int8_t *output_ptr, int8_t *input_ptr, void *args_ptr);
+void dl_portable_s8_resize_nearest_2x2_c1(int8_t *output_ptr, int8_t *input_ptr, void *args_ptr);
+
+// elementwise, args is elemwiseArgsType<feature_t>. Saturating.
+void dl_portable_s8_add_n_n(int8_t *output_ptr, int8_t *input0_ptr, int8_t *input1_ptr, void *args);
+void dl_portable_s8_add_n_1(int8_t *output_ptr, int8_t *input0_ptr, int8_t *input1_ptr, void *args);
+void dl_portable_s8_add_1_n(int8_t *output_ptr, int8_t *input0_ptr, int8_t *input1_ptr, void *args);
+void dl_portable_s16_add_n_n(int16_t *output_ptr, int16_t *input0_ptr, int16_t *input1_ptr, void *args);
+void dl_portable_s16_add_n_1(int16_t *output_ptr, int16_t *input0_ptr, int16_t *input1_ptr, void *args);
+void dl_portable_s16_add_1_n(int16_t *output_ptr, int16_t *input0_ptr, int16_t *input1_ptr, void *args);
+void dl_portable_s8_sub_n_n(int8_t *output_ptr, int8_t *input0_ptr, int8_t *input1_ptr, void *args);
+void dl_portable_s8_sub_n_1(int8_t *output_ptr, int8_t *input0_ptr, int8_t *input1_ptr, void *args);
+void dl_portable_s8_sub_1_n(int8_t *output_ptr, int8_t *input0_ptr, int8_t *input1_ptr, void *args);
+void dl_portable_s16_sub_n_n(int16_t *output_ptr, int16_t *input0_ptr, int16_t *input1_ptr, void *args);
+void dl_portable_s16_sub_n_1(int16_t *output_ptr, int16_t *input0_ptr, int16_t *input1_ptr, void *args);
+void dl_portable_s16_sub_1_n(int16_t *output_ptr, int16_t *input0_ptr, int16_t *input1_ptr, void *args);
+#endif
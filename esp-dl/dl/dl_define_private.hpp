@@ -36,4 +36,11 @@
 #define CONFIG_ESP32P4_BOOST 0
 #endif
 
+#if !CONFIG_ESP32P4_BOOST && !CONFIG_TIE728_BOOST && defined(__GNUC__) &&                                        \
+    (defined(__SSE2__) || defined(__ARM_NEON) || defined(__wasm_simd128__))
+#define CONFIG_PORTABLE_BOOST 1 /*!< 128-bit SIMD through compiler vector extensions, e.g. linux target */
+#else
+#define CONFIG_PORTABLE_BOOST 0
+#endif
+
 #define CONFIG_ACCURATE_INFER 1
@@ -3,8 +3,11 @@
 #include "dl_define.hpp"
 #include "dl_tool.hpp"
 #include <cmath>
+#include <cstring>
 #include <functional>
 
+#define DL_SOFTMAX_TILE 16 /*!< Max number of softmaxes computed together by math::softmax() */
+
 namespace dl {
 
 /**
@@ -193,6 +196,104 @@ inline float exp_fast(float x, int steps = 8)
     return x;
 }
 
+/**
+ * @brief e^x with range reduction x = n * ln2 + r, |r| <= ln2 / 2, and a degree 7 polynomial of e^r. 2^n is written
+ * into the exponent bits. x is clamped to [-87.3, 88], relative error is below 2e-7 in this range. There is no table
+ * and no libm call except fmaf(), which is one instruction on FPUs with fused multiply-add, so loops of it can be
+ * unrolled and vectorized.
+ *
+ * @param x exponent
+ * @return e^x
+ */
+inline float exp_poly(float x)
+{
+    x = DL_CLIP(x, -87.3f, 88.f);
+    int n = (int)(x * 1.44269504f + (x >= 0 ? 0.5f : -0.5f));
+    // ln2 is split to two floats so that n * ln2 is exact, fmaf() keeps -ffast-math from merging them back
+    float r = fmaf(-n, 0.693359375f, x);
+    r = fmaf(n, 2.12194440e-4f, r);
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.f;
+    int32_t bits = (n + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(float));
+    return p * scale;
+}
+
+/**
+ * @brief 1/sqrt(x) with the initial guess of fast_inv_sqrt() and three Newton steps. Relative error is below 2e-7 for
+ * positive normal x.
+ *
+ * @param x as a base
+ * @return 1/sqrt(x)
+ */
+inline float rsqrt(float x)
+{
+    float xhalf = 0.5f * x;
+    int32_t i;
+    memcpy(&i, &x, sizeof(float));
+    i = 0x5f375a86 - (i >> 1);
+    float y;
+    memcpy(&y, &i, sizeof(float));
+    y = y * (1.5f - xhalf * y * y);
+    y = y * (1.5f - xhalf * y * y);
+    y = y * (1.5f - xhalf * y * y);
+    return y;
+}
+
+/**
+ * @brief Softmax of cols vectors stored as the columns of [len, stride] data, element i of vector k is at
+ * i * stride + k. The columns are read row by row, so a softmax along a non-last axis reads contiguous memory instead
+ * of one element every stride. The first pass finds the max and the sum together, the sum is rescaled when the max
+ * grows (online softmax). The second pass writes exp(x - max) / sum.
+ *
+ * @tparam T      float, or int16_t/int8_t for quantized input
+ * @param input   Input
+ * @param output  Output, can be the same as input when T is float
+ * @param len     Length of every softmax
+ * @param stride  Distance between two elements of one softmax, 1 for the last axis
+ * @param cols    Number of softmaxes, at most DL_SOFTMAX_TILE
+ * @param scale   Scale of quantized input, 1 for float
+ */
+template <typename T>
+void softmax(const T *input, float *output, int len, int stride, int cols, float scale = 1.f)
+{
+    float max[DL_SOFTMAX_TILE];
+    float sum[DL_SOFTMAX_TILE];
+    for (int k = 0; k < cols; k++) {
+        max[k] = input[k] * scale;
+        sum[k] = 1.f;
+    }
+    for (int i = 1; i < len; i++) {
+        const T *row = input + i * stride;
+        for (int k = 0; k < cols; k++) {
+            float x = row[k] * scale;
+            if (x > max[k]) {
+                sum[k] = sum[k] * exp_poly(max[k] - x) + 1.f;
+                max[k] = x;
+            } else {
+                sum[k] += exp_poly(x - max[k]);
+            }
+        }
+    }
+
+    for (int k = 0; k < cols; k++) {
+        sum[k] = 1.f / sum[k];
+    }
+    for (int i = 0; i < len; i++) {
+        const T *row = input + i * stride;
+        float *output_row = output + i * stride;
+        for (int k = 0; k < cols; k++) {
+            output_row[k] = exp_poly(row[k] * scale - max[k]) * sum[k];
+        }
+    }
+}
+
 inline float sigmoid(float x)
 {
     return 1.0 / (1.0 + expf(-x));
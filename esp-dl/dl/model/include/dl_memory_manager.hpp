@@ -7,6 +7,31 @@
 #include <list>
 
 namespace dl {
+/**
+ * @brief Memory plan of all variable tensors for one set of model input shapes: the shapes propagated by
+ * Module::get_output_shape() and the offsets in the internal RAM or PSRAM root. A plan can be cached and applied to
+ * the model context again, without any simulation.
+ */
+class MemoryPlan {
+public:
+    std::vector<std::vector<int>> shapes; /*!< Shape of each variable tensor, indexed by the variable index */
+    std::vector<uint32_t> offsets;        /*!< Offset of each variable tensor relative to its root */
+    std::vector<bool> is_internal;        /*!< Whether each variable tensor is in the internal RAM root */
+    size_t internal_size = 0;             /*!< In bytes, internal RAM root size required by this plan */
+    size_t psram_size = 0;                /*!< In bytes, PSRAM root size required by this plan */
+
+    /**
+     * @brief Reshape and relocate the variable tensors of context in place, so that the TensorBase pointers and the
+     * tensor handles held by users keep valid. The roots are enlarged if they are smaller than the plan, then the
+     * data of all variable tensors is lost.
+     *
+     * @param context    Model context
+     * @param alignment  Memory address alignment of the roots
+     * @return true if successful, false if the roots can't be enlarged
+     */
+    bool apply(ModelContext *context, int alignment = 16);
+};
+
 /**
  * @brief Memory manager base class, each model has its own memory manager
  * TODO: share memory manager with different models
@@ -38,6 +63,23 @@ public:
     virtual bool alloc(fbs::FbsModel *fbs_model,
                        std::vector<dl::module::Module *> &execution_plan,
                        ModelContext *context) = 0;
+
+    /**
+     * @brief Plan the memory for new graph input shapes. Nothing in context is changed, it must be called after
+     * alloc() because the dtypes and exponents are taken from the variable tensors of context.
+     *
+     * @param execution_plan  Topological sorted module list
+     * @param context         Model context
+     * @param graph_inputs    Variable index and new shape of each graph input
+     * @param graph_outputs   Variable index of each graph output
+     * @param plan            Output memory plan
+     * @return Bool Return true if the planning is successful, false otherwise.
+     */
+    virtual bool plan(std::vector<dl::module::Module *> &execution_plan,
+                      ModelContext *context,
+                      const std::vector<std::pair<int, std::vector<int>>> &graph_inputs,
+                      const std::vector<int> &graph_outputs,
+                      MemoryPlan &plan) = 0;
 };
 
 /**
@@ -124,6 +166,14 @@ public:
      */
     TensorBase *create_tensor(void *internal_root, void *psram_root);
 
+    /**
+     * @brief Get the offset relative to the root where the tensor is placed
+     *
+     * @param is_internal  Output, true if the tensor is in the internal RAM root, false if in the PSRAM root
+     * @return uint32_t
+     */
+    uint32_t get_root_offset(bool &is_internal);
+
     /**
      * @brief Is inplaced or not
      *
@@ -26,10 +26,46 @@ private:
      * @param tensor_info Output vector to store TensorInfo objects for all tensors
      */
     void get_tensor_info_from_fbs(fbs::FbsModel *fbs_model,
-                                  std::vector<dl::module::Module *> execution_plan,
+                                  std::vector<dl::module::Module *> &execution_plan,
                                   ModelContext *context,
                                   std::vector<TensorInfo *> &tensor_info);
 
+    /**
+     * @brief Propagates the graph input shapes through Module::get_output_shape() and builds the lifetime and inplace
+     * links of all variable tensors. The modules are visited by their tensor indices, so it doesn't need the
+     * FlatBuffer model and also works after Model::minimize().
+     * @param execution_plan Topologically sorted list of computation modules
+     * @param context Runtime context, provides the parameter tensors
+     * @param graph_inputs Variable index and shape of each graph input
+     * @param graph_outputs Variable index of each graph output
+     * @param names Name of each variable tensor, may be empty strings
+     * @param dtypes Data type of each variable tensor
+     * @param exponents Exponent of each variable tensor
+     * @param tensor_info Output vector to store TensorInfo objects for all tensors
+     */
+    void get_tensor_info(std::vector<dl::module::Module *> &execution_plan,
+                         ModelContext *context,
+                         const std::vector<std::pair<int, std::vector<int>>> &graph_inputs,
+                         const std::vector<int> &graph_outputs,
+                         std::vector<std::string> &names,
+                         const std::vector<dtype_t> &dtypes,
+                         const std::vector<int> &exponents,
+                         std::vector<TensorInfo *> &tensor_info);
+
+    /**
+     * @brief Simulates with priority to internal RAM if there's PSRAM and internal RAM is allowed, else simulate()
+     * @param tensor_info Vector containing tensor metadata
+     * @param node_num Total computation nodes in the network
+     */
+    void simulate_auto(std::vector<TensorInfo *> &tensor_info, int node_num);
+
+    /**
+     * @brief Gets the root sizes required by the simulated memory lists
+     * @param internal_size Output, internal RAM root size in bytes
+     * @param psram_size Output, PSRAM root size in bytes
+     */
+    void get_root_size(int &internal_size, int &psram_size);
+
     /**
      * @brief Simulates memory allocation process for given tensor information
      * @param tensor_info Vector containing metadata for all tensors in the network
@@ -108,6 +144,21 @@ public:
      */
     bool alloc(fbs::FbsModel *fbs_model, std::vector<dl::module::Module *> &execution_plan, ModelContext *context);
 
+    /**
+     * @brief Plans the memory of all network tensors for new graph input shapes following greedy strategy
+     * @param execution_plan Execution graph ordered by computation dependencies
+     * @param context Model context whose variable tensors have been allocated by alloc()
+     * @param graph_inputs Variable index and new shape of each graph input
+     * @param graph_outputs Variable index of each graph output
+     * @param plan Output memory plan
+     * @return bool True if successful
+     */
+    bool plan(std::vector<dl::module::Module *> &execution_plan,
+              ModelContext *context,
+              const std::vector<std::pair<int, std::vector<int>>> &graph_inputs,
+              const std::vector<int> &graph_outputs,
+              MemoryPlan &plan);
+
     /**
      * @brief Releases all allocated memory including tensor buffers and memory pools
      */
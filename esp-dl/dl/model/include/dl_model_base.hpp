@@ -6,6 +6,7 @@
 #include "esp_log.h"
 #include "fbs_loader.hpp"
 #include "fbs_model.hpp"
+#include <functional>
 
 #if DL_LOG_INFER_LATENCY
 #define DL_LOG_INFER_LATENCY_INIT_WITH_SIZE(size) DL_LOG_LATENCY_INIT_WITH_SIZE(size)
@@ -57,6 +58,69 @@ private:
     std::string m_doc_string;                      /*!< doc string of model */
     size_t m_internal_size;                        /*!< Internal RAM usage */
     size_t m_psram_size;                           /*!< PSRAM usage */
+    size_t m_max_internal_size = 0;                /*!< max_internal_size of build(), used to plan new input shapes */
+    std::vector<int> m_inputs_index;               /*!< Variable index of each input, in the order of m_inputs */
+    std::vector<int> m_outputs_index;              /*!< Variable index of each output, in the order of m_outputs */
+    std::list<std::pair<std::vector<int>, MemoryPlan *>>
+        m_memory_plans;            /*!< LRU cache of memory plans keyed by input shapes, the most recently used first */
+    int m_memory_plan_cache_size = 4; /*!< Max number of cached memory plans */
+    int m_run_cursor = INT_MAX; /*!< Index of the next module of run_step(), INT_MAX if no inference is started */
+    runtime_mode_t m_run_mode = RUNTIME_MODE_SINGLE_CORE; /*!< Runtime mode of run_step() */
+    std::vector<std::pair<int, std::string>> m_exit_points; /*!< Tensor index and name of the early exit points */
+    std::function<bool(const std::string &, TensorBase *)> m_exit_gate; /*!< Gate of the early exit points */
+    int m_exit_point = -1; /*!< Exit point whose gate fired in the last inference, -1 if none */
+
+    /**
+     * @brief Read the early exit points from metadata_props "early_exit", comma separated tensor names. Every exit
+     * point is moved to the front of the execution plan together with the modules it depends on, so it must be called
+     * before the memory is planned.
+     */
+    void load_exit_points();
+
+    /**
+     * @brief Forward a module of the execution plan and evaluate the gate of the exit points it outputs.
+     *
+     * @param index  Index of the module in the execution plan.
+     * @param mode   Runtime mode.
+     * @return false if the module is NULL or a gate fired, the remaining modules must not run.
+     */
+    bool forward_module(int index, runtime_mode_t mode);
+
+    /**
+     * @brief Assign user inputs to model inputs, re-plan the memory if their shapes differ.
+     *
+     * @param user_inputs  The map of input name and TensorBase, it must contain all inputs of model.
+     * @return ESP_OK if success, ESP_FAIL otherwise.
+     */
+    esp_err_t assign_inputs(std::map<std::string, TensorBase *> &user_inputs);
+
+    /**
+     * @brief Replace the quantized unary modules which have no exported table with LUT modules. The tables are
+     * synthesized from the exponents of inputs and outputs, so it must be called after memory allocation.
+     */
+    void synthesize_lut();
+
+    /**
+     * @brief Get the key of memory plan cache, which is the rank and dims of every input in the order of m_inputs.
+     *
+     * @param input_shapes  New shapes of inputs, the inputs not in it keep their current shapes.
+     * @param key           Output key.
+     * @return ESP_OK if all names are inputs of model, ESP_FAIL otherwise.
+     */
+    esp_err_t get_memory_plan_key(const std::map<std::string, std::vector<int>> &input_shapes, std::vector<int> &key);
+
+    /**
+     * @brief Get the memory plan of key from the LRU cache, or plan it and put it into the cache.
+     *
+     * @param key  Key returned by get_memory_plan_key().
+     * @return MemoryPlan*, nullptr if failed. It's owned by the cache.
+     */
+    MemoryPlan *get_memory_plan(const std::vector<int> &key);
+
+    /**
+     * @brief Delete all cached memory plans.
+     */
+    void clear_memory_plans();
 
 public:
     Model() {}
@@ -244,13 +308,14 @@ public:
      you want to alloc memory on internal RAM first.
      * @param mm_type        Type of memory manager
      * @param preload        Whether to preload the model's parameters to internal ram (not implemented yet)
+     * @note Quantized unary activations without an exported table(Sigmoid, Tanh, Exp...) are replaced by LUT modules.
      */
     virtual void build(size_t max_internal_size,
                        memory_manager_t mm_type = MEMORY_MANAGER_GREEDY,
                        bool preload = false);
 
     /**
-     * @brief Run the model module by module.
+     * @brief Run the model module by module. It stops at an exit point if the gate of set_exit_gate() returns true.
      *
      * @param mode  Runtime mode.
      */
@@ -271,12 +336,139 @@ public:
      * @param mode          Runtime mode.
      * @param user_outputs  It's for debug to specify the output of the intermediate layer; Under normal use, there is
      * no need to pass a value to this parameter. If no parameter is passed, the default is the graphical output, which
-     * can be obtained through Model::get_outputs().
+     * can be obtained through Model::get_outputs(). If it's passed, the run stops after all of them are got, and the
+     * graphical outputs may not be updated. The gate of set_exit_gate() is not evaluated then.
      */
     virtual void run(std::map<std::string, TensorBase *> &user_inputs,
                      runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE,
                      std::map<std::string, TensorBase *> user_outputs = {});
 
+    /**
+     * @brief Run the modules [begin, end) of the execution plan. Several calls with adjacent ranges give the same
+     * result as run(), so one inference can be split into steps and interleaved with other work, such as by
+     * ModelScheduler. The tensors of the model are kept between the steps.
+     * @note The inputs must be assigned before the first step and must not be changed until the last one.
+     *
+     * @param begin  Index of the first module, in [0, get_module_num()].
+     * @param end    Index after the last module, in [begin, get_module_num()].
+     * @param mode   Runtime mode.
+     * @return
+     *      - ESP_OK       Success
+     *      - ESP_FAIL     Range out of the execution plan
+     */
+    virtual esp_err_t run_range(int begin, int end, runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE);
+
+    /**
+     * @brief Get the number of modules in the execution plan.
+     *
+     * @return Number of modules.
+     */
+    virtual int get_module_num();
+
+    /**
+     * @brief Start an inference which is run by run_step() later, so the application can do other work between the
+     * steps. The inputs must be assigned before and must not be changed until run_done(). A started inference which
+     * is not done is dropped by the next run_begin().
+     *
+     * @param mode  Runtime mode.
+     */
+    virtual void run_begin(runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE);
+
+    /**
+     * @brief Assign the inputs and start an inference which is run by run_step() later.
+     *
+     * @param user_inputs  The model inputs, re-plan the memory if their shapes differ.
+     * @param mode         Runtime mode.
+     * @return
+     *      - ESP_OK       Success
+     *      - ESP_FAIL     Assign inputs failed, run_done() is true
+     */
+    virtual esp_err_t run_begin(std::map<std::string, TensorBase *> &user_inputs,
+                                runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE);
+
+    /**
+     * @brief Run the next modules of the inference started by run_begin(). At least one module runs if it's not done.
+     *
+     * @param max_modules     Max number of modules to run, 0 for no limit.
+     * @param time_budget_us  Stop after the module which exceeds the time budget in microseconds, 0 for no limit. A
+     * single module is never interrupted, so the step may be longer than the budget.
+     * @return Number of modules left, 0 if the inference is done.
+     */
+    virtual int run_step(int max_modules = 1, int64_t time_budget_us = 0);
+
+    /**
+     * @brief Whether the inference started by run_begin() is done, the outputs are valid if it is.
+     *
+     * @return true if done.
+     */
+    virtual bool run_done();
+
+    /**
+     * @brief Set the gate of the early exit points. After a module outputs an exit point, the gate is called with the
+     * name and tensor of the exit point. If it returns true, the remaining modules are skipped and the outputs of
+     * model are invalid. The exit points are declared by metadata_props "early_exit" of the model, comma separated
+     * tensor names, such as the output of an intermediate classifier head. They are run as early as possible.
+     *
+     * @param gate  Gate function, nullptr to disable early exit.
+     */
+    void set_exit_gate(std::function<bool(const std::string &, TensorBase *)> gate);
+
+    /**
+     * @brief Get the names of the early exit points declared by metadata_props "early_exit".
+     *
+     * @return Names of exit points, in the order of declaration.
+     */
+    std::vector<std::string> get_exit_points();
+
+    /**
+     * @brief Get the exit point whose gate fired in the last inference.
+     *
+     * @return Name of exit point, empty if the inference ran to the end.
+     */
+    std::string get_exit_point();
+
+    /**
+     * @brief Whether the outputs of model are valid, false if the last inference exited early.
+     *
+     * @return true if valid.
+     */
+    bool is_output_valid();
+
+    /**
+     * @brief Set the shapes of model inputs which differ from the exported ones, such as variable audio length or
+     * another resolution. The shapes are propagated through all modules and the tensors are re-planned in the arena.
+     * The plans are cached by input shapes in a LRU, switching to a cached shape costs no planning and no allocation.
+     * run() calls it automatically if the shapes of user inputs differ from the model inputs.
+     * @note The arena is only enlarged, never shrunk. The data of all tensors is lost after the shapes are changed.
+     * The TensorBase pointers and handles of inputs, outputs and intermediates keep valid.
+     *
+     * @param input_shapes  Map of input name and new shape, the inputs not in it keep their current shapes.
+     * @return
+     *      - ESP_OK       Success
+     *      - ESP_FAIL     Unknown input name or memory allocation failed
+     */
+    esp_err_t set_input_shapes(const std::map<std::string, std::vector<int>> &input_shapes);
+
+    /**
+     * @brief Precompute and cache the memory plan of expected input shapes, and enlarge the arena to fit it. Call it
+     * after build() for every expected shape bucket, then set_input_shapes() or run() with these shapes never plans or
+     * allocates memory, as long as the number of buckets is not larger than the cache size.
+     * @note The data of all tensors is lost if the arena is enlarged.
+     *
+     * @param input_shapes  Map of input name and shape, the inputs not in it keep their current shapes.
+     * @return
+     *      - ESP_OK       Success
+     *      - ESP_FAIL     Unknown input name or memory allocation failed
+     */
+    esp_err_t plan_input_shapes(const std::map<std::string, std::vector<int>> &input_shapes);
+
+    /**
+     * @brief Set the max number of memory plans cached for different input shapes, 4 by default.
+     *
+     * @param size  Max number of cached memory plans, at least 1.
+     */
+    void set_memory_plan_cache_size(int size);
+
     /**
      * @brief Minimize the model.
      */
@@ -388,6 +580,25 @@ public:
      */
     virtual TensorBase *get_output(const std::string &name);
 
+    /**
+     * @brief Get the handle of an input, output or intermediate tensor of model by name. Resolve the handle once and
+     * use get_tensor(handle) on the runtime path, it avoids the string lookup of get_output(name). The handle keeps
+     * valid after minimize(). The handles of inputs and outputs can be resolved after minimize() too, the ones of
+     * intermediate tensors only before it.
+     *
+     * @param name The name of tensor.
+     * @return The handle of tensor, -1 if the name is not found.
+     */
+    virtual int get_tensor_handle(const std::string &name);
+
+    /**
+     * @brief Get input, output or intermediate tensor of model by handle. O(1) access.
+     *
+     * @param handle The handle returned by get_tensor_handle()
+     * @return TensorBase*, nullptr if the handle is invalid.
+     */
+    virtual TensorBase *get_tensor(int handle);
+
     /**
      * @brief Get the model's metadata prop
      *
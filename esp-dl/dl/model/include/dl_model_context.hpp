@@ -3,6 +3,7 @@
 #include "dl_tensor_base.hpp"
 #include "esp_log.h"
 #include <map>
+#include <unordered_map>
 namespace dl {
 
 #define CONTEXT_PARAMETER_OFFSET 10000000 /*!< Offset for parameter tensors */
@@ -20,9 +21,9 @@ private:
     void *m_internal_root;                   /*!< Internal root pointer */
     int m_psram_size;                        /*!< In bytes. PSRAM size usage. Only take effect when there's a PSRAM */
     int m_internal_size;                     /*!< In bytes. Internal size usage. */
-    std::map<std::string, int> m_name2index; /*!< Tensor name to index map
-                                               >=0: variable tensor
-                                               <0: parameter tensor */
+    std::unordered_map<std::string, int> m_name2index; /*!< Tensor name to index map
+                                                         <CONTEXT_PARAMETER_OFFSET: variable tensor
+                                                         >=CONTEXT_PARAMETER_OFFSET: parameter tensor */
     /**
      * @brief Gets the parameter tensor index by global tensor index.
      *
@@ -143,6 +144,19 @@ public:
      */
     bool root_alloc(size_t internal_size, size_t psram_size, int alignment = 16);
 
+    /**
+     * @brief Enlarges the PSRAM and internal roots if they are smaller than the required sizes. The roots are never
+     * shrunk, so the largest plan of a model with dynamic shapes decides the memory usage. An enlarged root is
+     * reallocated without copying, the variable tensors must be relocated by the caller. The new roots are allocated
+     * before the old ones are freed, so on failure the old roots and the tensors pointing into them stay valid.
+     *
+     * @param internal_size The required size of the internal memory in bytes.
+     * @param psram_size The required size of the PSRAM memory in bytes.
+     * @param alignment The alignment of the memory in bytes.
+     * @return Bool Return true if the roots are large enough, false if nothing is changed.
+     */
+    bool root_realloc(size_t internal_size, size_t psram_size, int alignment = 16);
+
     /**
      * @brief Gets the pointer to the PSRAM root.
      *
@@ -197,7 +211,7 @@ public:
      */
     void minimize()
     {
-        std::map<std::string, int> temp;
+        std::unordered_map<std::string, int> temp;
         m_name2index.swap(temp);
     }
 
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "dl_model_base.hpp"
+#include <mutex>
+
+namespace dl {
+
+/**
+ * @brief Latency statistics of a model in ModelScheduler. The latency of an inference is the time from submit() to
+ * the end of its last module, including the time it waits for other models.
+ */
+typedef struct {
+    int runs;            /*!< number of finished inferences */
+    int deadline_misses; /*!< number of inferences finished later than the deadline */
+    int64_t last_us;     /*!< latency of the last inference */
+    int64_t min_us;      /*!< min latency */
+    int64_t max_us;      /*!< max latency */
+    int64_t total_us;    /*!< sum of latencies, total_us / runs is the average */
+} scheduler_stats_t;
+
+/**
+ * @brief Run several models in one task and interleave them module by module. Every step runs a few modules of the
+ * pending model with the highest priority, so a submitted high priority model, such as a wake word model, only waits
+ * for the current step of a long running one, such as a detector, instead of its whole inference. Models of the same
+ * priority run in the order of their absolute deadline, then in the order of submit().
+ * @note The models are not owned by the scheduler. Each model keeps its own tensors, so an interrupted inference
+ * continues where it stops. submit() may be called from other tasks, step() should be called from one task.
+ */
+class ModelScheduler {
+private:
+    struct task_t {
+        Model *model;            /*!< model of task, not owned */
+        int priority;            /*!< larger runs first */
+        int64_t deadline_us;     /*!< relative deadline after submit(), 0 if no deadline */
+        runtime_mode_t mode;     /*!< runtime mode of the pending inference */
+        bool pending;            /*!< an inference is submitted and not finished */
+        int cursor;              /*!< index of the next module to run */
+        int64_t submit_us;       /*!< time of submit() */
+        uint64_t sequence;       /*!< order of submit() */
+        scheduler_stats_t stats; /*!< latency statistics */
+    };
+    std::vector<task_t> m_tasks; /*!< tasks indexed by the id returned by add_model() */
+    std::mutex m_mutex;          /*!< protects m_tasks from submit() of other tasks */
+    uint64_t m_sequence;         /*!< counter of submit() */
+    int m_modules_per_step;      /*!< number of modules run by one step() */
+
+    /**
+     * @brief Select the pending task to run next.
+     *
+     * @return id of task, -1 if no task is pending.
+     */
+    int select_task();
+
+public:
+    /**
+     * @brief Construct a new ModelScheduler object.
+     *
+     * @param modules_per_step  Number of modules run by one step(). The smaller, the shorter a high priority model
+     * waits, and the more often the priorities are compared.
+     */
+    ModelScheduler(int modules_per_step = 1);
+
+    /**
+     * @brief Add a model to the scheduler.
+     *
+     * @param model        Model built and ready to run, it must outlive the scheduler.
+     * @param priority     Priority of model, larger runs first.
+     * @param deadline_us  Expected latency from submit() in microseconds, 0 if no deadline. It orders the models of
+     * the same priority and counts the deadline misses in the statistics.
+     * @return id of model in the scheduler.
+     */
+    int add_model(Model *model, int priority = 0, int64_t deadline_us = 0);
+
+    /**
+     * @brief Submit an inference of model. Assign the inputs of model before it, and read the outputs after
+     * is_pending() returns false, if Model::is_output_valid() is true.
+     *
+     * @param id    id returned by add_model().
+     * @param mode  Runtime mode.
+     * @return
+     *      - ESP_OK       Success
+     *      - ESP_FAIL     Invalid id or the last inference of model is not finished
+     */
+    esp_err_t submit(int id, runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE);
+
+    /**
+     * @brief Run the next modules of the pending model with the highest priority. This is the preemption point
+     * between modules.
+     *
+     * @return id of model which has run, -1 if no model is pending.
+     */
+    int step();
+
+    /**
+     * @brief Call step() until no model is pending, including the models submitted meanwhile.
+     */
+    void run_until_idle();
+
+    /**
+     * @brief Whether the submitted inference of model is not finished.
+     *
+     * @param id  id returned by add_model().
+     * @return true if pending.
+     */
+    bool is_pending(int id);
+
+    /**
+     * @brief Get the latency statistics of model.
+     *
+     * @param id  id returned by add_model().
+     * @return scheduler_stats_t, all zero if id is invalid.
+     */
+    scheduler_stats_t get_stats(int id);
+
+    /**
+     * @brief Clear the latency statistics of all models.
+     */
+    void reset_stats();
+
+    /**
+     * @brief Print the latency statistics of all models.
+     */
+    void print_stats();
+};
+
+} // namespace dl
@@ -71,23 +71,48 @@ void TensorInfo::update_time(int new_time)
     this->call_times++;
 }
 
-TensorBase *TensorInfo::create_tensor(void *internal_root, void *psram_root)
+uint32_t TensorInfo::get_root_offset(bool &is_internal)
 {
-    TensorBase *tensor = nullptr;
-    uint8_t *element = nullptr;
-
 #if CONFIG_SPIRAM
-    if (this->is_internal) {
-        element = (uint8_t *)internal_root + this->get_internal_offset();
-    } else {
-        element = (uint8_t *)psram_root + this->get_offset();
-    }
+    // The inplace follower is placed in the root of its leader.
+    is_internal = this->get_internal_state();
+    return is_internal ? this->get_internal_offset() : this->get_offset();
 #else
-    element = (uint8_t *)internal_root + this->get_offset();
+    is_internal = true;
+    return this->get_offset();
 #endif
+}
 
-    tensor = new TensorBase(shape, element, exponent, dtype, false);
-    return tensor;
+TensorBase *TensorInfo::create_tensor(void *internal_root, void *psram_root)
+{
+    bool in_internal = false;
+    uint32_t root_offset = this->get_root_offset(in_internal);
+    uint8_t *element = (uint8_t *)(in_internal ? internal_root : psram_root) + root_offset;
+
+    return new TensorBase(shape, element, exponent, dtype, false);
+}
+
+/*oooooooooooooooooo00000000000000000000 MemoryPlan 00000000000000000000ooooooooooooooooo*/
+
+bool MemoryPlan::apply(ModelContext *context, int alignment)
+{
+    if (!context->root_realloc(this->internal_size, this->psram_size, alignment)) {
+        return false;
+    }
+
+    uint8_t *internal_root = (uint8_t *)context->get_internal_root();
+    uint8_t *psram_root = (uint8_t *)context->get_psram_root();
+    for (int i = 0; i < context->get_variable_count() && i < this->shapes.size(); i++) {
+        TensorBase *tensor = context->m_variables[i];
+        if (!tensor) {
+            continue;
+        }
+        if (!this->shapes[i].empty()) {
+            tensor->set_shape(this->shapes[i]);
+        }
+        tensor->set_element_ptr((this->is_internal[i] ? internal_root : psram_root) + this->offsets[i]);
+    }
+    return true;
 }
 
 /*oooooooooooooooooo00000000000000000000 MemoryChunk 00000000000000000000ooooooooooooooooo*/
@@ -17,28 +17,13 @@ bool MemoryManagerGreedy::alloc(fbs::FbsModel *fbs_model,
     get_tensor_info_from_fbs(fbs_model, execution_plan, context, tensor_info);
 
     // simulate the memory allocation
-#if CONFIG_SPIRAM
-    if (this->max_internal_size > this->alignment) {
-        simulate_with_internal_memory(tensor_info, execution_plan.size());
-    } else {
-        simulate(tensor_info, execution_plan.size());
-    }
-#else
-    simulate(tensor_info, execution_plan.size());
-#endif
+    simulate_auto(tensor_info, execution_plan.size());
 
     void *psram_root = nullptr;
     void *internal_root = nullptr;
     int psram_size = 0;
     int internal_size = 0;
-
-    if (!this->psram_memory_list.empty()) {
-        psram_size = psram_memory_list.back()->offset + psram_memory_list.back()->size;
-    }
-
-    if (!this->internal_memory_list.empty()) {
-        internal_size = internal_memory_list.back()->offset + internal_memory_list.back()->size;
-    }
+    get_root_size(internal_size, psram_size);
 
     // alloc memory for tensors
     if (context->root_alloc(internal_size, psram_size, this->alignment)) {
@@ -68,42 +53,128 @@ bool MemoryManagerGreedy::alloc(fbs::FbsModel *fbs_model,
     return false;
 }
 
+bool MemoryManagerGreedy::plan(std::vector<dl::module::Module *> &execution_plan,
+                               ModelContext *context,
+                               const std::vector<std::pair<int, std::vector<int>>> &graph_inputs,
+                               const std::vector<int> &graph_outputs,
+                               MemoryPlan &plan)
+{
+    int variable_count = context->get_variable_count();
+    std::vector<std::string> names(variable_count);
+    std::vector<dtype_t> dtypes(variable_count, DATA_TYPE_FLOAT);
+    std::vector<int> exponents(variable_count, 0);
+    for (int i = 0; i < variable_count; i++) {
+        TensorBase *tensor = context->m_variables[i];
+        if (tensor) {
+            dtypes[i] = tensor->get_dtype();
+            exponents[i] = tensor->get_exponent();
+        }
+    }
+
+    std::vector<TensorInfo *> tensor_info;
+    get_tensor_info(execution_plan, context, graph_inputs, graph_outputs, names, dtypes, exponents, tensor_info);
+    simulate_auto(tensor_info, execution_plan.size());
+
+    int internal_size = 0;
+    int psram_size = 0;
+    get_root_size(internal_size, psram_size);
+    plan.internal_size = internal_size;
+    plan.psram_size = psram_size;
+    plan.shapes.assign(variable_count, {});
+    plan.offsets.assign(variable_count, 0);
+    plan.is_internal.assign(variable_count, false);
+    bool in_internal = false;
+    for (int i = 0; i < variable_count; i++) {
+        if (tensor_info[i]) {
+            plan.shapes[i] = tensor_info[i]->get_shape();
+            plan.offsets[i] = tensor_info[i]->get_root_offset(in_internal);
+            plan.is_internal[i] = in_internal;
+        }
+    }
+    // inplace followers refer to their leaders, free them after all offsets are taken
+    for (int i = 0; i < variable_count; i++) {
+        delete tensor_info[i];
+    }
+
+    this->free_memory_list();
+    return true;
+}
+
 void MemoryManagerGreedy::free()
 {
     this->free_memory_list();
 }
 
 void MemoryManagerGreedy::get_tensor_info_from_fbs(fbs::FbsModel *fbs_model,
-                                                   std::vector<dl::module::Module *> execution_plan,
+                                                   std::vector<dl::module::Module *> &execution_plan,
                                                    ModelContext *context,
                                                    std::vector<TensorInfo *> &tensor_info)
 {
-    tensor_info.resize(context->get_variable_count());
-    // 1. add graph inputs
-    std::vector<std::string> graph_inputs = fbs_model->get_graph_inputs();
+    int variable_count = context->get_variable_count();
+    std::vector<std::string> names(variable_count);
+    std::vector<dtype_t> dtypes(variable_count, DATA_TYPE_FLOAT);
+    std::vector<int> exponents(variable_count, 0);
+    std::vector<std::pair<int, std::vector<int>>> graph_inputs;
+    std::vector<int> graph_outputs;
     int index = -1;
-    std::string name;
-
-    for (int i = 0; i < graph_inputs.size(); i++) {
-        name = graph_inputs[i];
-        index = context->get_variable_index(name);
 
+    // graph inputs, outputs and the outputs of all nodes are variables, take their dtypes and exponents
+    std::vector<std::string> variable_names = fbs_model->get_graph_inputs();
+    for (int i = 0; i < variable_names.size(); i++) {
+        index = context->get_variable_index(variable_names[i]);
         if (index >= 0) {
-            TensorInfo *info = new TensorInfo(name,
-                                              0,
-                                              -1,
-                                              fbs_model->get_value_info_shape(name),
-                                              fbs_model->get_value_info_dtype(name),
-                                              fbs_model->get_value_info_exponent(name));
-            tensor_info[index] = info;
+            graph_inputs.emplace_back(index, fbs_model->get_value_info_shape(variable_names[i]));
+        }
+    }
+    std::vector<std::string> outputs_name = fbs_model->get_graph_outputs();
+    for (int i = 0; i < outputs_name.size(); i++) {
+        index = context->get_variable_index(outputs_name[i]);
+        if (index >= 0) {
+            graph_outputs.push_back(index);
         }
     }
-
-    // 2. add tensor outputs and update time line of tensors
-    std::vector<std::string> graph_outputs = fbs_model->get_graph_outputs();
     std::vector<std::string> sorted_nodes = fbs_model->topological_sort();
     std::vector<std::string> op_inputs;
     std::vector<std::string> op_outputs;
+    for (int i = 0; i < sorted_nodes.size(); i++) {
+        fbs_model->get_operation_inputs_and_outputs(sorted_nodes[i], op_inputs, op_outputs);
+        variable_names.insert(variable_names.end(), op_outputs.begin(), op_outputs.end());
+    }
+    for (int i = 0; i < variable_names.size(); i++) {
+        index = context->get_variable_index(variable_names[i]);
+        if (index >= 0) {
+            names[index] = variable_names[i];
+            dtypes[index] = fbs_model->get_value_info_dtype(variable_names[i]);
+            exponents[index] = fbs_model->get_value_info_exponent(variable_names[i]);
+        }
+    }
+
+    get_tensor_info(execution_plan, context, graph_inputs, graph_outputs, names, dtypes, exponents, tensor_info);
+}
+
+void MemoryManagerGreedy::get_tensor_info(std::vector<dl::module::Module *> &execution_plan,
+                                          ModelContext *context,
+                                          const std::vector<std::pair<int, std::vector<int>>> &graph_inputs,
+                                          const std::vector<int> &graph_outputs,
+                                          std::vector<std::string> &names,
+                                          const std::vector<dtype_t> &dtypes,
+                                          const std::vector<int> &exponents,
+                                          std::vector<TensorInfo *> &tensor_info)
+{
+    tensor_info.assign(context->get_variable_count(), nullptr);
+    // 1. add graph inputs
+    int index = -1;
+    for (int i = 0; i < graph_inputs.size(); i++) {
+        index = graph_inputs[i].first;
+        tensor_info[index] =
+            new TensorInfo(names[index], 0, -1, graph_inputs[i].second, dtypes[index], exponents[index]);
+    }
+
+    // 2. add tensor outputs and update time line of tensors
+    auto is_variable = [](int index) { return index >= 0 && index < CONTEXT_PARAMETER_OFFSET; };
+    auto is_graph_output = [&graph_outputs](int index) {
+        return std::find(graph_outputs.begin(), graph_outputs.end(), index) != graph_outputs.end();
+    };
     for (int i = 0; i < execution_plan.size(); i++) {
         dl::module::Module *module = execution_plan[i];
         if (!module) {
@@ -113,12 +184,12 @@ void MemoryManagerGreedy::get_tensor_info_from_fbs(fbs::FbsModel *fbs_model,
 
         // update the time of tensor by node's inputs
         std::vector<std::vector<int>> input_shapes;
-        fbs_model->get_operation_inputs_and_outputs(sorted_nodes[i], op_inputs, op_outputs);
+        const std::vector<int> &op_inputs = module->m_inputs_index;
+        const std::vector<int> &op_outputs = module->m_outputs_index;
 
         for (int j = 0; j < op_inputs.size(); j++) {
-            name = op_inputs[j];
-            index = context->get_variable_index(name);
-            if (index >= 0) {
+            index = op_inputs[j];
+            if (is_variable(index)) {
                 // The previously existing tensor will dirty the input. Must disconnect the inplace link.
                 TensorInfo *follower_tensor = tensor_info[index]->get_inplace_follower_tensor();
                 if (follower_tensor) {
@@ -126,12 +197,11 @@ void MemoryManagerGreedy::get_tensor_info_from_fbs(fbs::FbsModel *fbs_model,
                     follower_tensor->set_inplace_leader_tensor(nullptr);
                 }
 
-                auto out_iter = std::find(graph_outputs.begin(), graph_outputs.end(), name);
-                if (out_iter == graph_outputs.end())
+                if (!is_graph_output(index))
                     tensor_info[index]->update_time(i + 1); // free this tensor next step
                 input_shapes.push_back(tensor_info[index]->get_shape());
             } else {
-                TensorBase *tensor = context->get_tensor(name);
+                TensorBase *tensor = context->get_tensor(index);
                 if (tensor) {
                     input_shapes.push_back(tensor->get_shape());
                 } else {
@@ -144,26 +214,18 @@ void MemoryManagerGreedy::get_tensor_info_from_fbs(fbs::FbsModel *fbs_model,
         std::vector<std::vector<int>> output_shapes = module->get_output_shape(input_shapes);
         if ((module->inplace == MODULE_INPLACE_UNCHANGED_BUFFER || module->inplace == MODULE_INPLACE_CHANGED_BUFFER) &&
             op_outputs.size() == 1) {
-            name = op_outputs[0];
+            index = op_outputs[0];
             TensorInfo *inplace_tensor = nullptr;
-            TensorInfo *info = new TensorInfo(name,
-                                              i,
-                                              -1,
-                                              output_shapes[0],
-                                              fbs_model->get_value_info_dtype(name),
-                                              fbs_model->get_value_info_exponent(name));
-            index = context->get_variable_index(name);
+            TensorInfo *info = new TensorInfo(names[index], i, -1, output_shapes[0], dtypes[index], exponents[index]);
             tensor_info[index] = info;
 
             // inplace, loop all inputs and find a suitable inplace tensor
             for (int j = 0; j < op_inputs.size(); j++) {
-                name = op_inputs[j];
-                index = context->get_variable_index(name);
-                if (index >= 0) {
+                index = op_inputs[j];
+                if (is_variable(index)) {
                     inplace_tensor = tensor_info[index];
                     if (inplace_tensor->get_size() >= info->get_size()) {
-                        auto out_iter = std::find(graph_outputs.begin(), graph_outputs.end(), name);
-                        if (out_iter == graph_outputs.end()) {
+                        if (!is_graph_output(index)) {
                             break;
                         } else {
                             // If op_input is graph output. It can't be set inplace.
@@ -191,20 +253,40 @@ void MemoryManagerGreedy::get_tensor_info_from_fbs(fbs::FbsModel *fbs_model,
             }
         } else {
             for (int j = 0; j < op_outputs.size(); j++) {
-                name = op_outputs[j];
-                TensorInfo *info = new TensorInfo(name,
-                                                  i,
-                                                  -1,
-                                                  output_shapes[j],
-                                                  fbs_model->get_value_info_dtype(name),
-                                                  fbs_model->get_value_info_exponent(name));
-                index = context->get_variable_index(name);
-                tensor_info[index] = info;
+                index = op_outputs[j];
+                tensor_info[index] =
+                    new TensorInfo(names[index], i, -1, output_shapes[j], dtypes[index], exponents[index]);
             }
         }
     }
 }
 
+void MemoryManagerGreedy::simulate_auto(std::vector<TensorInfo *> &tensor_info, int node_num)
+{
+#if CONFIG_SPIRAM
+    if (this->max_internal_size > this->alignment) {
+        simulate_with_internal_memory(tensor_info, node_num);
+    } else {
+        simulate(tensor_info, node_num);
+    }
+#else
+    simulate(tensor_info, node_num);
+#endif
+}
+
+void MemoryManagerGreedy::get_root_size(int &internal_size, int &psram_size)
+{
+    internal_size = 0;
+    psram_size = 0;
+    if (!this->psram_memory_list.empty()) {
+        psram_size = psram_memory_list.back()->offset + psram_memory_list.back()->size;
+    }
+
+    if (!this->internal_memory_list.empty()) {
+        internal_size = internal_memory_list.back()->offset + internal_memory_list.back()->size;
+    }
+}
+
 void MemoryManagerGreedy::simulate(std::vector<TensorInfo *> &tensor_info, int node_num)
 {
     std::vector<std::vector<TensorInfo *>> node_alloc_tensors(node_num);
@@ -3,6 +3,8 @@
 #include "dl_memory_manager_greedy.hpp"
 #include "dl_model_base.hpp"
 #include "dl_module_creator.hpp"
+#include "dl_module_lut.hpp"
+#include "esp_timer.h"
 #include "fbs_model.hpp"
 #include <format>
 
@@ -83,13 +85,14 @@ Model::~Model()
 {
     // If fbs_loader is NULL, this means fbs_model is created outside this class. So don't delete it.
     if (m_fbs_loader) {
-        delete m_fbs_loader;
-
+        // The loader owns the mapped flash that fbs_model refers to.
         if (m_fbs_model) {
             delete m_fbs_model;
         }
+        delete m_fbs_loader;
     }
 
+    this->clear_memory_plans();
     if (m_model_context) {
         delete m_model_context;
     }
@@ -179,6 +182,9 @@ esp_err_t Model::load(fbs::FbsModel *fbs_model)
             module->m_outputs_index.push_back(index); // assign output index of
         }
     }
+    if (ret == ESP_OK) {
+        this->load_exit_points();
+    }
 
     return ret;
 }
@@ -196,6 +202,9 @@ void Model::build(size_t max_internal_size, memory_manager_t mm_type, bool prelo
         memory_manager = new MemoryManagerGreedy(max_internal_size);
     }
     memory_manager->alloc(m_fbs_model, m_execution_plan, m_model_context);
+    this->synthesize_lut();
+    this->clear_memory_plans();
+    m_max_internal_size = max_internal_size;
 
     // get the TensorBase* of inputs and outputs
     std::vector<std::string> inputs_tmp = m_fbs_model->get_graph_inputs();
@@ -210,22 +219,352 @@ void Model::build(size_t max_internal_size, memory_manager_t mm_type, bool prelo
         TensorBase *output_tensor = this->get_intermediate(outputs_tmp[i]);
         m_outputs.emplace(outputs_tmp[i], output_tensor);
     }
+    m_inputs_index.clear();
+    m_outputs_index.clear();
+    for (auto it = m_inputs.begin(); it != m_inputs.end(); it++) {
+        m_inputs_index.push_back(m_model_context->get_variable_index(it->first));
+    }
+    for (auto it = m_outputs.begin(); it != m_outputs.end(); it++) {
+        m_outputs_index.push_back(m_model_context->get_variable_index(it->first));
+    }
 
     m_fbs_model->clear_map();
     delete memory_manager;
 }
 
-void Model::run(runtime_mode_t mode)
+void Model::synthesize_lut()
 {
-    // execute each module.
     for (int i = 0; i < m_execution_plan.size(); i++) {
         dl::module::Module *module = m_execution_plan[i];
-        if (module) {
-            module->forward(m_model_context, mode);
-        } else {
+        if (module->quant_type != QUANT_TYPE_SYMM_8BIT && module->quant_type != QUANT_TYPE_SYMM_16BIT) {
+            continue;
+        }
+        std::string key;
+        ActivationFunction func = module->get_lut_function(key);
+        if (!func) {
+            continue;
+        }
+
+        TensorBase *input = m_model_context->get_tensor(module->m_inputs_index[0]);
+        TensorBase *output = m_model_context->get_tensor(module->m_outputs_index[0]);
+        TensorBase *table = dl::module::LUT::get_synthesized_table(
+            key, func, input->exponent, output->exponent, module->quant_type);
+        if (!table) {
+            continue;
+        }
+
+        dl::module::LUT *lut = new dl::module::LUT(module->name, table, module->inplace, module->quant_type);
+        lut->m_inputs_index = module->m_inputs_index;
+        lut->m_outputs_index = module->m_outputs_index;
+        m_execution_plan[i] = lut;
+        delete module;
+    }
+}
+
+esp_err_t Model::get_memory_plan_key(const std::map<std::string, std::vector<int>> &input_shapes,
+                                     std::vector<int> &key)
+{
+    for (auto it = input_shapes.begin(); it != input_shapes.end(); it++) {
+        if (m_inputs.find(it->first) == m_inputs.end()) {
+            ESP_LOGE(TAG, "The input name(%s) isn't graph input.", it->first.c_str());
+            return ESP_FAIL;
+        }
+    }
+
+    key.clear();
+    for (auto it = m_inputs.begin(); it != m_inputs.end(); it++) {
+        auto shape_it = input_shapes.find(it->first);
+        const std::vector<int> &shape = shape_it == input_shapes.end() ? it->second->shape : shape_it->second;
+        key.push_back(shape.size());
+        key.insert(key.end(), shape.begin(), shape.end());
+    }
+    return ESP_OK;
+}
+
+MemoryPlan *Model::get_memory_plan(const std::vector<int> &key)
+{
+    for (auto it = m_memory_plans.begin(); it != m_memory_plans.end(); it++) {
+        if (it->first == key) {
+            m_memory_plans.splice(m_memory_plans.begin(), m_memory_plans, it);
+            return it->second;
+        }
+    }
+
+    std::vector<std::pair<int, std::vector<int>>> graph_inputs;
+    const int *dims = key.data();
+    for (int i = 0; i < m_inputs_index.size(); i++) {
+        graph_inputs.emplace_back(m_inputs_index[i], std::vector<int>(dims + 1, dims + 1 + dims[0]));
+        dims += 1 + dims[0];
+    }
+
+    // Only MemoryManagerGreedy is supported, the same as build().
+    MemoryManagerGreedy memory_manager(m_max_internal_size);
+    MemoryPlan *plan = new MemoryPlan();
+    if (!memory_manager.plan(m_execution_plan, m_model_context, graph_inputs, m_outputs_index, *plan)) {
+        ESP_LOGE(TAG, "Failed to plan memory for the new input shapes.");
+        delete plan;
+        return nullptr;
+    }
+
+    m_memory_plans.emplace_front(key, plan);
+    while (m_memory_plans.size() > m_memory_plan_cache_size) {
+        delete m_memory_plans.back().second;
+        m_memory_plans.pop_back();
+    }
+    return plan;
+}
+
+void Model::clear_memory_plans()
+{
+    for (auto it = m_memory_plans.begin(); it != m_memory_plans.end(); it++) {
+        delete it->second;
+    }
+    m_memory_plans.clear();
+}
+
+esp_err_t Model::set_input_shapes(const std::map<std::string, std::vector<int>> &input_shapes)
+{
+    std::vector<int> key, current_key;
+    if (this->get_memory_plan_key(input_shapes, key) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    this->get_memory_plan_key({}, current_key);
+    if (key == current_key) {
+        return ESP_OK;
+    }
+
+    MemoryPlan *plan = this->get_memory_plan(key);
+    if (!plan || !plan->apply(m_model_context)) {
+        ESP_LOGE(TAG, "Failed to set the input shapes.");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t Model::plan_input_shapes(const std::map<std::string, std::vector<int>> &input_shapes)
+{
+    std::vector<int> key, current_key;
+    if (this->get_memory_plan_key(input_shapes, key) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    this->get_memory_plan_key({}, current_key);
+
+    MemoryPlan *plan = this->get_memory_plan(key);
+    if (!plan) {
+        return ESP_FAIL;
+    }
+    mem_info_t root_size;
+    m_model_context->get_variable_memory_size(root_size);
+    if (plan->internal_size <= root_size.internal && plan->psram_size <= root_size.psram) {
+        return ESP_OK;
+    }
+
+    // Enlarge the arena, then relocate the tensors of current shapes into it. The current plan is got first, so a
+    // failure leaves the old arena and tensors untouched. It may evict plan from the cache, keep its sizes.
+    size_t internal_size = plan->internal_size;
+    size_t psram_size = plan->psram_size;
+    MemoryPlan *current_plan = this->get_memory_plan(current_key);
+    if (!current_plan) {
+        return ESP_FAIL;
+    }
+    if (!m_model_context->root_realloc(internal_size, psram_size)) {
+        return ESP_FAIL;
+    }
+    if (!current_plan->apply(m_model_context)) {
+        return ESP_FAIL;
+    }
+    // keep the planned shapes as the most recently used
+    this->get_memory_plan(key);
+    return ESP_OK;
+}
+
+void Model::set_memory_plan_cache_size(int size)
+{
+    m_memory_plan_cache_size = DL_MAX(size, 1);
+    while (m_memory_plans.size() > m_memory_plan_cache_size) {
+        delete m_memory_plans.back().second;
+        m_memory_plans.pop_back();
+    }
+}
+
+void Model::run(runtime_mode_t mode)
+{
+    this->run_range(0, m_execution_plan.size(), mode);
+}
+
+esp_err_t Model::run_range(int begin, int end, runtime_mode_t mode)
+{
+    if (begin < 0 || begin > end || end > m_execution_plan.size()) {
+        ESP_LOGE(TAG, "Module range [%d, %d) is out of [0, %d).", begin, end, (int)m_execution_plan.size());
+        return ESP_FAIL;
+    }
+
+    // a new inference starts at module 0, the rest of an exited inference is skipped.
+    if (begin == 0) {
+        m_exit_point = -1;
+    }
+    for (int i = begin; i < end && m_exit_point < 0; i++) {
+        if (!this->forward_module(i, mode)) {
             break;
         }
     }
+    return ESP_OK;
+}
+
+bool Model::forward_module(int index, runtime_mode_t mode)
+{
+    dl::module::Module *module = m_execution_plan[index];
+    if (!module) {
+        return false;
+    }
+    module->forward(m_model_context, mode);
+    if (!m_exit_gate) {
+        return true;
+    }
+    for (int output_index : module->get_outputs_index()) {
+        for (int i = 0; i < m_exit_points.size(); i++) {
+            if (m_exit_points[i].first == output_index &&
+                m_exit_gate(m_exit_points[i].second, m_model_context->get_tensor(output_index))) {
+                m_exit_point = i;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void Model::set_exit_gate(std::function<bool(const std::string &, TensorBase *)> gate)
+{
+    m_exit_gate = gate;
+}
+
+std::vector<std::string> Model::get_exit_points()
+{
+    std::vector<std::string> names;
+    for (auto &exit_point : m_exit_points) {
+        names.push_back(exit_point.second);
+    }
+    return names;
+}
+
+std::string Model::get_exit_point()
+{
+    return m_exit_point < 0 ? "" : m_exit_points[m_exit_point].second;
+}
+
+bool Model::is_output_valid()
+{
+    return m_exit_point < 0;
+}
+
+void Model::load_exit_points()
+{
+    m_exit_points.clear();
+    std::string value = m_fbs_model->get_model_metadata_prop("early_exit");
+    // module which outputs every variable tensor, -1 for inputs of model. Parameters are never outputs.
+    std::vector<int> producer(m_model_context->get_variable_count(), -1);
+    for (int i = 0; i < m_execution_plan.size(); i++) {
+        for (int output_index : m_execution_plan[i]->m_outputs_index) {
+            producer[output_index] = i;
+        }
+    }
+
+    // move every exit point with the modules it depends on to the front of the plan, in the order of declaration, so
+    // that the rest of the backbone is not run before the gate.
+    std::vector<bool> placed(m_execution_plan.size(), false);
+    std::vector<dl::module::Module *> plan;
+    size_t start = 0;
+    while (start < value.size()) {
+        size_t comma = value.find(',', start);
+        std::string name = value.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        start = comma == std::string::npos ? value.size() : comma + 1;
+        int index = m_model_context->get_tensor_index(name);
+        if (index < 0 || index >= producer.size() || producer[index] < 0) {
+            ESP_LOGW(TAG, "Early exit point %s is not an output of any module.", name.c_str());
+            continue;
+        }
+        m_exit_points.emplace_back(index, name);
+
+        std::vector<bool> required(m_execution_plan.size(), false);
+        std::vector<int> stack = {producer[index]};
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+            if (required[i] || placed[i]) {
+                continue;
+            }
+            required[i] = true;
+            for (int input_index : m_execution_plan[i]->m_inputs_index) {
+                if (input_index >= 0 && input_index < producer.size() && producer[input_index] >= 0) {
+                    stack.push_back(producer[input_index]);
+                }
+            }
+        }
+        for (int i = 0; i < m_execution_plan.size(); i++) {
+            if (required[i]) {
+                plan.push_back(m_execution_plan[i]);
+                placed[i] = true;
+            }
+        }
+    }
+    if (m_exit_points.empty()) {
+        return;
+    }
+    for (int i = 0; i < m_execution_plan.size(); i++) {
+        if (!placed[i]) {
+            plan.push_back(m_execution_plan[i]);
+        }
+    }
+    m_execution_plan = plan;
+}
+
+int Model::get_module_num()
+{
+    return m_execution_plan.size();
+}
+
+void Model::run_begin(runtime_mode_t mode)
+{
+    m_run_cursor = 0;
+    m_run_mode = mode;
+    m_exit_point = -1;
+}
+
+esp_err_t Model::run_begin(std::map<std::string, TensorBase *> &user_inputs, runtime_mode_t mode)
+{
+    m_run_cursor = INT_MAX;
+    if (this->assign_inputs(user_inputs) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    this->run_begin(mode);
+    return ESP_OK;
+}
+
+int Model::run_step(int max_modules, int64_t time_budget_us)
+{
+    if (this->run_done()) {
+        return 0;
+    }
+    int64_t start = time_budget_us > 0 ? esp_timer_get_time() : 0;
+    int module_num = m_execution_plan.size();
+    int end = max_modules > 0 ? DL_MIN(m_run_cursor + max_modules, module_num) : module_num;
+    // at least one module runs, the time budget is checked between modules.
+    while (m_run_cursor < end) {
+        if (!this->forward_module(m_run_cursor, m_run_mode)) {
+            m_run_cursor = INT_MAX;
+            break;
+        }
+        m_run_cursor++;
+        if (time_budget_us > 0 && esp_timer_get_time() - start >= time_budget_us) {
+            break;
+        }
+    }
+    return this->run_done() ? 0 : module_num - m_run_cursor;
+}
+
+bool Model::run_done()
+{
+    return m_run_cursor >= (int)m_execution_plan.size();
 }
 
 void Model::run(TensorBase *input, runtime_mode_t mode)
@@ -236,6 +575,10 @@ void Model::run(TensorBase *input, runtime_mode_t mode)
 
     TensorBase *model_input = m_inputs.begin()->second;
     if (input != model_input) {
+        if (input->shape != model_input->shape &&
+            this->set_input_shapes({{m_inputs.begin()->first, input->shape}}) != ESP_OK) {
+            return;
+        }
         if (!model_input->assign(input)) {
             ESP_LOGE(TAG, "Assign input failed");
             return;
@@ -246,16 +589,26 @@ void Model::run(TensorBase *input, runtime_mode_t mode)
     this->run(mode);
 }
 
-void Model::run(std::map<std::string, TensorBase *> &user_inputs,
-                runtime_mode_t mode,
-                std::map<std::string, TensorBase *> user_outputs)
+esp_err_t Model::assign_inputs(std::map<std::string, TensorBase *> &user_inputs)
 {
     if (user_inputs.size() != m_inputs.size()) {
         ESP_LOGE(TAG,
                  "The size of user_inputs(%d) don't equal with the size of model inputs(%d).",
                  user_inputs.size(),
                  m_inputs.size());
-        return;
+        return ESP_FAIL;
+    }
+
+    // re-plan if the user inputs have new shapes
+    std::map<std::string, std::vector<int>> input_shapes;
+    for (auto user_inputs_iter = user_inputs.begin(); user_inputs_iter != user_inputs.end(); user_inputs_iter++) {
+        auto graph_input_iter = m_inputs.find(user_inputs_iter->first);
+        if (graph_input_iter != m_inputs.end() && graph_input_iter->second->shape != user_inputs_iter->second->shape) {
+            input_shapes.emplace(user_inputs_iter->first, user_inputs_iter->second->shape);
+        }
+    }
+    if (!input_shapes.empty() && this->set_input_shapes(input_shapes) != ESP_OK) {
+        return ESP_FAIL;
     }
 
     for (auto user_inputs_iter = user_inputs.begin(); user_inputs_iter != user_inputs.end(); user_inputs_iter++) {
@@ -264,34 +617,54 @@ void Model::run(std::map<std::string, TensorBase *> &user_inputs,
         auto graph_input_iter = m_inputs.find(user_input_name);
         if (graph_input_iter == m_inputs.end()) {
             ESP_LOGE(TAG, "The input name(%s) isn't graph input.", user_input_name.c_str());
-            return;
+            return ESP_FAIL;
         }
         TensorBase *graph_input_tensor = graph_input_iter->second;
         if (!graph_input_tensor->assign(user_input_tensor)) {
             ESP_LOGE(TAG, "Assign input failed");
-            return;
+            return ESP_FAIL;
         }
     }
+    return ESP_OK;
+}
 
-    // execute each module.
-    for (int i = 0; i < m_execution_plan.size(); i++) {
+void Model::run(std::map<std::string, TensorBase *> &user_inputs,
+                runtime_mode_t mode,
+                std::map<std::string, TensorBase *> user_outputs)
+{
+    if (this->assign_inputs(user_inputs) != ESP_OK) {
+        return;
+    }
+
+    if (user_outputs.empty()) {
+        this->run(mode);
+        return;
+    }
+
+    // resolve the names of user_outputs once, then only compare the tensor index per module.
+    std::vector<std::pair<int, TensorBase *>> user_outputs_index;
+    for (auto user_outputs_iter = user_outputs.begin(); user_outputs_iter != user_outputs.end(); user_outputs_iter++) {
+        int user_tensor_index = m_model_context->get_tensor_index(user_outputs_iter->first);
+        if (user_tensor_index >= 0) {
+            user_outputs_index.emplace_back(user_tensor_index, user_outputs_iter->second);
+        }
+    }
+
+    // execute each module, stop after the last user output is got. The exit gate is not evaluated for debug.
+    m_exit_point = -1;
+    int remaining_outputs = user_outputs_index.size();
+    for (int i = 0; i < m_execution_plan.size() && remaining_outputs > 0; i++) {
         dl::module::Module *module = m_execution_plan[i];
         if (module) {
             module->forward(m_model_context, mode);
             // get the intermediate tensor for debug.
-            if (!user_outputs.empty()) {
-                for (auto user_outputs_iter = user_outputs.begin(); user_outputs_iter != user_outputs.end();
-                     user_outputs_iter++) {
-                    int user_tensor_index =
-                        m_model_context->get_tensor_index(const_cast<std::string &>(user_outputs_iter->first));
-                    if (user_tensor_index >= 0) {
-                        std::vector<int> outputs_index = module->get_outputs_index();
-                        for (int i = 0; i < outputs_index.size(); i++) {
-                            if (user_tensor_index == outputs_index[i]) {
-                                user_outputs_iter->second->assign(m_model_context->m_variables[user_tensor_index]);
-                                break;
-                            }
-                        }
+            const std::vector<int> &outputs_index = module->get_outputs_index();
+            for (auto &user_output : user_outputs_index) {
+                for (int j = 0; j < outputs_index.size(); j++) {
+                    if (user_output.first == outputs_index[j]) {
+                        user_output.second->assign(m_model_context->m_variables[user_output.first]);
+                        remaining_outputs--;
+                        break;
                     }
                 }
             }
@@ -359,6 +732,33 @@ TensorBase *Model::get_output(const std::string &name)
     return it->second;
 }
 
+int Model::get_tensor_handle(const std::string &name)
+{
+    if (name.empty()) {
+        ESP_LOGE(TAG, "Invalid name.");
+        return -1;
+    }
+    // inputs and outputs are resolved by m_inputs and m_outputs, which are kept by minimize().
+    int i = 0;
+    for (auto it = m_outputs.begin(); it != m_outputs.end(); it++, i++) {
+        if (it->first == name) {
+            return m_outputs_index[i];
+        }
+    }
+    i = 0;
+    for (auto it = m_inputs.begin(); it != m_inputs.end(); it++, i++) {
+        if (it->first == name) {
+            return m_inputs_index[i];
+        }
+    }
+    return m_model_context->get_tensor_index(name);
+}
+
+TensorBase *Model::get_tensor(int handle)
+{
+    return m_model_context->get_tensor(handle);
+}
+
 std::string Model::get_metadata_prop(const std::string &key)
 {
     if (!m_fbs_model) {
@@ -436,7 +836,7 @@ esp_err_t Model::test()
     for (int i = 0; i < m_execution_plan.size(); i++) {
         dl::module::Module *module = m_execution_plan[i];
         module->forward(m_model_context, RUNTIME_MODE_SINGLE_CORE);
-        std::vector<int> module_outputs_index = module->get_outputs_index();
+        const std::vector<int> &module_outputs_index = module->get_outputs_index();
         for (int index : module_outputs_index) {
             auto iter = std::find(test_outputs_index.begin(), test_outputs_index.end(), index);
             if (iter != test_outputs_index.end()) {
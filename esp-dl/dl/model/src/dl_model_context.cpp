@@ -76,8 +76,9 @@ TensorBase *ModelContext::get_tensor(int index)
 
 TensorBase *ModelContext::get_tensor(const std::string &name)
 {
-    if (m_name2index.find(name) != m_name2index.end()) {
-        return get_tensor(m_name2index[name]);
+    auto iter = m_name2index.find(name);
+    if (iter != m_name2index.end()) {
+        return get_tensor(iter->second);
     } else {
         ESP_LOGE(TAG, "Tensor %s not found", name.c_str());
     }
@@ -87,8 +88,9 @@ TensorBase *ModelContext::get_tensor(const std::string &name)
 
 int ModelContext::get_tensor_index(const std::string &name)
 {
-    if (m_name2index.find(name) != m_name2index.end()) {
-        return m_name2index[name];
+    auto iter = m_name2index.find(name);
+    if (iter != m_name2index.end()) {
+        return iter->second;
     } else {
         ESP_LOGE(TAG, "Tensor %s not found", name.c_str());
     }
@@ -98,8 +100,9 @@ int ModelContext::get_tensor_index(const std::string &name)
 
 int ModelContext::get_variable_index(const std::string &name)
 {
-    if (m_name2index.find(name) != m_name2index.end()) {
-        int index = m_name2index[name];
+    auto iter = m_name2index.find(name);
+    if (iter != m_name2index.end()) {
+        int index = iter->second;
         if (index < CONTEXT_PARAMETER_OFFSET) {
             return index;
         } else {
@@ -176,4 +179,50 @@ bool ModelContext::root_alloc(size_t internal_size, size_t psram_size, int align
     return true;
 }
 
+bool ModelContext::root_realloc(size_t internal_size, size_t psram_size, int alignment)
+{
+    // allocate both new roots first, the old ones are still used by the variable tensors until they are relocated.
+    void *psram_root = nullptr;
+    void *internal_root = nullptr;
+    if (psram_size > m_psram_size) {
+        psram_root = tool::calloc_aligned(alignment, psram_size, 1, MALLOC_CAP_SPIRAM);
+        if (!psram_root) {
+            ESP_LOGE(TAG,
+                     "Failed to realloc %.2fKB PSRAM, largest available PSRAM block size %.2fKB",
+                     psram_size / 1024.f,
+                     heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) / 1024.f);
+            return false;
+        }
+    }
+    if (internal_size > m_internal_size) {
+        internal_root = tool::calloc_aligned(alignment, internal_size, 1, MALLOC_CAP_INTERNAL);
+        if (!internal_root) {
+            ESP_LOGE(TAG,
+                     "Failed to realloc %.2fKB internal RAM, largest available internal RAM block size %.2fKB",
+                     internal_size / 1024.f,
+                     heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024.f);
+            if (psram_root) {
+                free(psram_root);
+            }
+            return false;
+        }
+    }
+
+    if (psram_root) {
+        if (m_psram_root) {
+            free(m_psram_root);
+        }
+        m_psram_root = psram_root;
+        m_psram_size = psram_size;
+    }
+    if (internal_root) {
+        if (m_internal_root) {
+            free(m_internal_root);
+        }
+        m_internal_root = internal_root;
+        m_internal_size = internal_size;
+    }
+    return true;
+}
+
 } // namespace dl
@@ -0,0 +1,166 @@
+#include "dl_model_scheduler.hpp"
+#include "esp_timer.h"
+
+static const char *TAG = "dl::ModelScheduler";
+
+namespace dl {
+
+ModelScheduler::ModelScheduler(int modules_per_step) : m_sequence(0), m_modules_per_step(DL_MAX(modules_per_step, 1))
+{
+}
+
+int ModelScheduler::add_model(Model *model, int priority, int64_t deadline_us)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    task_t task = {};
+    task.model = model;
+    task.priority = priority;
+    task.deadline_us = deadline_us;
+    m_tasks.push_back(task);
+    return m_tasks.size() - 1;
+}
+
+esp_err_t ModelScheduler::submit(int id, runtime_mode_t mode)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (id < 0 || id >= m_tasks.size()) {
+        ESP_LOGE(TAG, "Invalid model id %d.", id);
+        return ESP_FAIL;
+    }
+    task_t &task = m_tasks[id];
+    if (task.pending) {
+        ESP_LOGE(TAG, "The last inference of model %d is not finished.", id);
+        return ESP_FAIL;
+    }
+    task.mode = mode;
+    task.pending = true;
+    task.cursor = 0;
+    task.submit_us = esp_timer_get_time();
+    task.sequence = m_sequence++;
+    return ESP_OK;
+}
+
+int ModelScheduler::select_task()
+{
+    int selected = -1;
+    int64_t selected_deadline = 0;
+    for (int i = 0; i < m_tasks.size(); i++) {
+        task_t &task = m_tasks[i];
+        if (!task.pending) {
+            continue;
+        }
+        int64_t deadline = task.deadline_us > 0 ? task.submit_us + task.deadline_us : INT64_MAX;
+        if (selected < 0) {
+            selected = i;
+            selected_deadline = deadline;
+            continue;
+        }
+        task_t &best = m_tasks[selected];
+        if (task.priority != best.priority) {
+            if (task.priority < best.priority) {
+                continue;
+            }
+        } else if (deadline != selected_deadline) {
+            if (deadline > selected_deadline) {
+                continue;
+            }
+        } else if (task.sequence > best.sequence) {
+            continue;
+        }
+        selected = i;
+        selected_deadline = deadline;
+    }
+    return selected;
+}
+
+int ModelScheduler::step()
+{
+    int id;
+    Model *model;
+    int begin, end;
+    runtime_mode_t mode;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = this->select_task();
+        if (id < 0) {
+            return -1;
+        }
+        task_t &task = m_tasks[id];
+        model = task.model;
+        mode = task.mode;
+        begin = task.cursor;
+        end = DL_MIN(begin + m_modules_per_step, model->get_module_num());
+    }
+
+    // the modules run without the lock, other tasks may submit meanwhile
+    esp_err_t ret = model->run_range(begin, end, mode);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    task_t &task = m_tasks[id];
+    task.cursor = end;
+    // an inference which exits early at a gate is finished too.
+    if (ret != ESP_OK || end >= model->get_module_num() || !model->is_output_valid()) {
+        int64_t latency = esp_timer_get_time() - task.submit_us;
+        scheduler_stats_t &stats = task.stats;
+        stats.min_us = stats.runs ? DL_MIN(stats.min_us, latency) : latency;
+        stats.max_us = DL_MAX(stats.max_us, latency);
+        stats.last_us = latency;
+        stats.total_us += latency;
+        stats.runs++;
+        if (task.deadline_us > 0 && latency > task.deadline_us) {
+            stats.deadline_misses++;
+        }
+        task.pending = false;
+    }
+    return id;
+}
+
+void ModelScheduler::run_until_idle()
+{
+    while (this->step() >= 0) {
+    }
+}
+
+bool ModelScheduler::is_pending(int id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return id >= 0 && id < m_tasks.size() && m_tasks[id].pending;
+}
+
+scheduler_stats_t ModelScheduler::get_stats(int id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (id < 0 || id >= m_tasks.size()) {
+        return {};
+    }
+    return m_tasks[id].stats;
+}
+
+void ModelScheduler::reset_stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (task_t &task : m_tasks) {
+        task.stats = {};
+    }
+}
+
+void ModelScheduler::print_stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int i = 0; i < m_tasks.size(); i++) {
+        const scheduler_stats_t &stats = m_tasks[i].stats;
+        ESP_LOGI(TAG,
+                 "model %d, priority: %d, runs: %d, latency avg/min/max/last: %lld/%lld/%lld/%lld us, "
+                 "deadline misses: %d",
+                 i,
+                 m_tasks[i].priority,
+                 stats.runs,
+                 stats.runs ? stats.total_us / stats.runs : 0,
+                 stats.min_us,
+                 stats.max_us,
+                 stats.last_us,
+                 stats.deadline_misses);
+    }
+}
+
+} // namespace dl
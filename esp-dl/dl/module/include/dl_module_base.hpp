@@ -1,6 +1,7 @@
 #pragma once
 #include "dl_base.hpp"
 #include "dl_define.hpp"
+#include "dl_math.hpp"
 #include "dl_model_context.hpp"
 #include "dl_tensor_base.hpp"
 #include "dl_tool.hpp"
@@ -9,6 +10,9 @@
 #include <functional>
 #include <iostream>
 
+#define DL_MODULE_PARALLEL_MIN_WORK 4096 /*!< Min elements of a loop that RUNTIME_MODE_AUTO splits to both cores */
+#define DL_MODULE_TASK_STACK_SIZE 4096   /*!< Stack size of the task created by module_parallel_for() */
+
 namespace dl {
 // Define the enum type for module in-place operation mode
 typedef enum {
@@ -57,7 +61,7 @@ public:
      *
      * @return Tensor index of model's tensors
      */
-    virtual std::vector<int> get_outputs_index() { return m_outputs_index; }
+    virtual const std::vector<int> &get_outputs_index() { return m_outputs_index; }
 
     /**
      * @brief Calculate output shape by input shape
@@ -98,6 +102,16 @@ public:
      */
     virtual void print() {}
 
+    /**
+     * @brief Get the float function of a quantized unary module, which is used by Model::build to replace the module
+     * with a LUT module when the model has no exported table for it.
+     *
+     * @param key  Name of function with its attributes, modules with the same key and exponents share one table
+     *
+     * @return The float function, nullptr if the module can not be replaced by a LUT module.
+     */
+    virtual ActivationFunction get_lut_function(std::string &key) { return nullptr; }
+
     /**
      * @brief set preload RAM pointer
      *
@@ -123,7 +137,27 @@ public:
     }
 
     /**
-     * @brief Run the module with single input and single output
+     * @brief Bind the standalone module to inputs and outputs. The tensors are kept in a context owned by the module,
+     * and run(mode) reuses it without any heap allocation. Several standalone modules can be chained by binding the
+     * output of one module as the input of the next one.
+     *
+     * @note Do not use it on a module which is a part of Model, it overwrites the tensor index of module.
+     *
+     * @param inputs   Input tensors
+     * @param outputs  Output tensors
+     */
+    virtual void bind(const std::vector<dl::TensorBase *> &inputs, const std::vector<dl::TensorBase *> &outputs);
+
+    /**
+     * @brief Run the module with the tensors bound by bind()
+     *
+     * @param mode    Runtime mode
+     */
+    virtual void run(runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE);
+
+    /**
+     * @brief Run the module with single input and single output. Same as bind({input}, {output}) and run(mode), the
+     * context is reused between calls.
      *
      * @param input   Input tensor
      * @param output  Output tensor
@@ -132,15 +166,28 @@ public:
     virtual void run(TensorBase *input, TensorBase *output, runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE);
 
     /**
-     * @brief Run the module by inputs and outputs
+     * @brief Run the module by inputs and outputs. Same as bind(inputs, outputs) and run(mode), the context is reused
+     * between calls.
      *
      * @param inputs   Input tensors
      * @param outputs  Output tensors
      * @param mode    Runtime mode
      */
-    virtual void run(std::vector<dl::TensorBase *> inputs,
-                     std::vector<dl::TensorBase *> outputs,
+    virtual void run(const std::vector<dl::TensorBase *> &inputs,
+                     const std::vector<dl::TensorBase *> &outputs,
                      runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE);
+
+private:
+    ModelContext *m_eager_context; ///< Context of standalone module, created by the first bind() or run()
+
+    /**
+     * @brief Prepare the context of standalone module for the given number of inputs and outputs. Only allocate when
+     * the number changes.
+     *
+     * @param num_inputs   Number of inputs
+     * @param num_outputs  Number of outputs
+     */
+    void init_eager_context(int num_inputs, int num_outputs);
 };
 
 /**
@@ -203,5 +250,18 @@ static void module_forward_dual_core(Module *op, void *args1, void *args2)
 }
 #pragma GCC diagnostic pop
 
+/**
+ * @brief Split the outer loop [0, size) of a module into two ranges and run them on both cores, like
+ * module_forward_dual_core() does for the modules with two args. The first range runs in a task pinned to the other
+ * core, the second one runs in the calling task.
+ *
+ * @param size    Number of iterations of the outer loop
+ * @param mode    RUNTIME_MODE_MULTI_CORE always splits. RUNTIME_MODE_AUTO splits when size * grain is at least
+ *                DL_MODULE_PARALLEL_MIN_WORK. RUNTIME_MODE_SINGLE_CORE never splits.
+ * @param func    The loop body, called with [start, end) of one range
+ * @param grain   Number of elements processed by one iteration, only used by RUNTIME_MODE_AUTO
+ */
+void module_parallel_for(int size, runtime_mode_t mode, const std::function<void(int, int)> &func, int grain = 1);
+
 } // namespace module
 } // namespace dl
@@ -82,10 +82,10 @@ public:
         T min_value = min == nullptr ? std::numeric_limits<T>::min() : min->get_element<T>(0);
         T max_value = max == nullptr ? std::numeric_limits<T>::max() : max->get_element<T>(0);
 
-        float rescale = DL_SCALE(input->exponent) * DL_RESCALE(output->exponent);
+        tool::requant_t requant = tool::get_requant(DL_SCALE(input->exponent) * DL_RESCALE(output->exponent));
         for (size_t i = 0; i < input->size; i++) {
             T temp = DL_CLIP(input_ptr[i], min_value, max_value);
-            tool::truncate(output_ptr[i], tool::round(temp * rescale));
+            output_ptr[i] = tool::requantize<T>(temp, requant);
         }
     }
 
@@ -90,18 +90,27 @@ public:
         int n_inputs = m_inputs_index.size();
 
         std::vector<T *> inputs_ptr(n_inputs);
+        std::vector<int> output_offsets(n_inputs + 1, 0); // offset of every input in one loop of output
         for (size_t i = 0; i < n_inputs; i++) {
             TensorBase *input = context->get_tensor(m_inputs_index[i]);
             inputs_ptr[i] = (T *)input->get_element_ptr();
+            output_offsets[i + 1] = output_offsets[i] + this->copy_nums[i];
         }
 
-        for (size_t i = 0; i < this->loop_times; i++) {
-            for (size_t j = 0; j < n_inputs; j++) {
-                tool::copy_memory(output_ptr, inputs_ptr[j], sizeof(T) * this->copy_nums[j]);
-                output_ptr += copy_nums[j];
-                inputs_ptr[j] += copy_nums[j];
-            }
-        }
+        // every (loop, input) copies one slice, so concat on the outer axis with few loops is split as well
+        module_parallel_for(
+            this->loop_times * n_inputs,
+            mode,
+            [&](int start, int end) {
+                for (int n = start; n < end; n++) {
+                    int i = n / n_inputs;
+                    int j = n % n_inputs;
+                    tool::copy_memory(output_ptr + i * output_offsets[n_inputs] + output_offsets[j],
+                                      inputs_ptr[j] + i * this->copy_nums[j],
+                                      sizeof(T) * this->copy_nums[j]);
+                }
+            },
+            output_offsets[n_inputs] / n_inputs);
     }
 
     /**
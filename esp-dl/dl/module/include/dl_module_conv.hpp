@@ -1,8 +1,12 @@
 #pragma once
 
 #include "dl_base_conv2d.hpp"
+#include "dl_base_conv2d_sparse.hpp"
+#include "dl_base_conv2d_winograd.hpp"
 #include "dl_base_depthwise_conv2d.hpp"
+#include "dl_base_grouped_conv2d.hpp"
 #include "dl_module_base.hpp"
+#include <algorithm>
 #include <typeinfo>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -22,13 +26,28 @@ private:
     activation_type_t activation; /*!< activation of Conv, if you don't specify anything, no activation is applied */
     std::vector<int> m_pads;      /*!< pads size needed in [top, bottom, left, right] of this operation */
     bool is_bias_reseted;
+    void *m_winograd_filter;                /*!< filter of conv2d_winograd, NULL if Winograd is not used */
+    const void *m_winograd_source;          /*!< filter data which m_winograd_filter is transformed from */
+    base::sparse_filter_t *m_sparse_filter; /*!< block-sparse filter of conv2d_sparse, NULL if the filter is dense */
+    const void *m_sparse_source;            /*!< filter data which m_sparse_filter is packed from */
+    std::vector<int> m_filter_exponents;    /*!< exponent of every output channel, empty if quantized per-tensor */
+    std::vector<int16_t> m_channel_shift;   /*!< per-channel mac_shift computed from m_filter_exponents */
+
+    /**
+     * @brief 1 < group < input_channel, computed by grouped_conv2d instead of Split + Conv + Concat.
+     */
+    bool is_grouped(int input_channel) { return m_group > 1 && m_group != input_channel; }
 
     void reset_bias(ModelContext *context)
     {
         if (is_bias_reseted == false) {
             if (m_inputs_index.size() == 3) {
                 TensorBase *bias = context->get_tensor(m_inputs_index[2]);
-                if (bias) {
+                int input_channel = context->get_tensor(m_inputs_index[0])->shape.back();
+                bool filter_int4 = context->get_tensor(m_inputs_index[1])->dtype == DATA_TYPE_INT4;
+                // grouped_conv2d, per-channel and int4 conv have C/C++ implementation only, which reads the bias in
+                // the original layout
+                if (bias && !is_grouped(input_channel) && m_filter_exponents.empty() && !filter_int4) {
                     bias->reset_bias_layout(quant_type, m_group != 1);
                 }
             }
@@ -36,6 +55,45 @@ private:
         }
     }
 
+    template <typename T>
+    void transform_winograd_filter(TensorBase *input, TensorBase *filter)
+    {
+#if CONFIG_DL_CONV_WINOGRAD && !CONFIG_TIE728_BOOST && !CONFIG_ESP32P4_BOOST
+        // ISA targets keep the assembly 3x3 kernels
+        if (m_winograd_source == filter->data) {
+            return;
+        }
+        heap_caps_free(m_winograd_filter);
+        m_winograd_filter = nullptr;
+        m_winograd_source = filter->data;
+        if (m_group == 1 && input->shape.size() == 4 && filter->shape[0] == 3 && filter->shape[1] == 3 &&
+            m_strides[0] == 1 && m_strides[1] == 1 && m_dilations[0] == 1 && m_dilations[1] == 1) {
+            m_winograd_filter = base::conv2d_winograd_transform_filter<T>(
+                (T *)filter->get_element_ptr(), filter->shape[3], filter->shape[2]);
+        }
+#endif
+    }
+
+    template <typename T>
+    void pack_sparse_filter(TensorBase *input, TensorBase *filter)
+    {
+#if !CONFIG_TIE728_BOOST && !CONFIG_ESP32P4_BOOST
+        // ISA targets keep the assembly 1x1 kernels and their filter layout
+        if (m_sparse_source == filter->data) {
+            return;
+        }
+        heap_caps_free(m_sparse_filter);
+        m_sparse_filter = nullptr;
+        m_sparse_source = filter->data;
+        bool no_pads = std::all_of(m_pads.begin(), m_pads.end(), [](int pad) { return pad == 0; });
+        if (m_group == 1 && input->shape.size() == 4 && filter->dtype != DATA_TYPE_INT4 && filter->shape[0] == 1 &&
+            filter->shape[1] == 1 && no_pads) {
+            m_sparse_filter = base::conv2d_sparse_pack_filter<T>(
+                (T *)filter->get_element_ptr(), filter->shape[3], filter->shape[2]);
+        }
+#endif
+    }
+
 public:
     /**
      * @brief Construct a new Conv object.
@@ -47,6 +105,11 @@ public:
      * @param strides         stride along each spatial axis
      * @param group           group of Conv
      * @param name            name of module
+     * @param quant_type      quantization type of Conv
+     * @param filter_exponents exponent of every output channel of filter, empty if quantized per-tensor. The bias of
+     * channel n must be quantized with exponent input.exponent + filter_exponents[n]. int8 on C/C++ targets only, the
+     * ISA kernels of ESP32-S3 and ESP32-P4 take one mac_shift. The fbs loader only supports PER_TENSOR quantization,
+     * so a Conv deserialized from .espdl is always per-tensor.
      */
     Conv(activation_type_t activation = Linear,
          std::vector<int> pads = {},
@@ -54,14 +117,23 @@ public:
          std::vector<int> strides = {},
          const char *name = NULL,
          const int group = 1,
-         quant_type_t quant_type = QUANT_TYPE_NONE) :
+         quant_type_t quant_type = QUANT_TYPE_NONE,
+         std::vector<int> filter_exponents = {}) :
         Module(name, MODULE_NON_INPLACE, quant_type),
         m_dilations(dilations),
         m_strides(strides),
         m_group(group),
         activation(activation),
-        m_pads(pads)
+        m_pads(pads),
+        m_winograd_filter(nullptr),
+        m_winograd_source(nullptr),
+        m_sparse_filter(nullptr),
+        m_sparse_source(nullptr),
+        m_filter_exponents(filter_exponents)
     {
+#if CONFIG_TIE728_BOOST || CONFIG_ESP32P4_BOOST
+        assert(filter_exponents.empty());
+#endif
         is_bias_reseted = false;
     }
 
@@ -69,7 +141,11 @@ public:
      * @brief Destroy the Conv object.
      *
      */
-    ~Conv() {}
+    ~Conv()
+    {
+        heap_caps_free(m_winograd_filter);
+        heap_caps_free(m_sparse_filter);
+    }
 
     /**
      * @brief Calculate the output shape
@@ -89,32 +165,43 @@ public:
         // refer to https://pytorch.org/docs/stable/generated/torch.nn.Conv2d.html
         output_shape[1] =
             (input_shape[1] + m_pads[0] + m_pads[1] - m_dilations[0] * (filter_shape[0] - 1) - 1) / m_strides[0] + 1;
+        bool is_depthwise = m_group != 1 && !is_grouped(input_shape.back());
         if (input_shape.size() == 3) {
-            output_shape[2] = m_group == 1 ? filter_shape[2] : input_shape[2];
+            output_shape[2] = is_depthwise ? input_shape[2] : filter_shape[2];
         } else if (input_shape.size() == 4) {
             output_shape[2] =
                 (input_shape[2] + m_pads[2] + m_pads[3] - m_dilations[1] * (filter_shape[1] - 1) - 1) / m_strides[1] +
                 1;
-            output_shape[3] = m_group == 1 ? filter_shape[3] : input_shape[3];
+            output_shape[3] = is_depthwise ? input_shape[3] : filter_shape[3];
         }
 
         return {output_shape};
     }
 
     void forward_args(void *args)
+    {
+        if (quant_type == QUANT_TYPE_SYMM_8BIT) {
+            forward_args_template<int8_t, int32_t, int32_t>(args);
+        } else if (quant_type == QUANT_TYPE_SYMM_16BIT) {
+            forward_args_template<int16_t, int32_t, int64_t>(args);
+        }
+    }
+
+    template <typename T, typename bias_t, typename buffer_t>
+    void forward_args_template(void *args)
     {
         if (m_group == 1) {
-            if (quant_type == QUANT_TYPE_SYMM_8BIT) {
-                base::conv2d<int8_t, int32_t, int32_t>(args);
-            } else if (quant_type == QUANT_TYPE_SYMM_16BIT) {
-                base::conv2d<int16_t, int32_t, int64_t>(args);
+            if (((base::ArgsType<T> *)args)->sparse_filter_element) {
+                base::conv2d_sparse<T, bias_t, buffer_t>(args);
+            } else if (((base::ArgsType<T> *)args)->winograd_filter_element) {
+                base::conv2d_winograd<T, bias_t, buffer_t>(args);
+            } else {
+                base::conv2d<T, bias_t, buffer_t>(args);
             }
+        } else if (is_grouped(((base::ArgsType<T> *)args)->input_channel)) {
+            base::grouped_conv2d<T, bias_t, buffer_t>(args);
         } else {
-            if (quant_type == QUANT_TYPE_SYMM_8BIT) {
-                base::depthwise_conv2d<int8_t, int32_t, int32_t>(args);
-            } else if (quant_type == QUANT_TYPE_SYMM_16BIT) {
-                base::depthwise_conv2d<int16_t, int32_t, int64_t>(args);
-            }
+            base::depthwise_conv2d<T, bias_t, buffer_t>(args);
         }
     }
 
@@ -139,6 +226,12 @@ public:
             bias = context->get_tensor(m_inputs_index[2]);
         }
         TensorBase *output = context->get_tensor(m_outputs_index[0]);
+        // int4 filter is only read by the C/C++ kernel of int8 1x1 conv2d without pads
+        assert(filter->dtype != DATA_TYPE_INT4 ||
+               (std::is_same<T, int8_t>::value && m_group == 1 && filter->shape[0] == 1 && filter->shape[1] == 1 &&
+                std::all_of(m_pads.begin(), m_pads.end(), [](int pad) { return pad == 0; })));
+        transform_winograd_filter<T>(input, filter);
+        pack_sparse_filter<T>(input, filter);
 
         std::vector<base::ArgsType<T>> m_args =
             base::get_conv_operation_args<T>(output,
@@ -152,6 +245,13 @@ public:
                                              this->activation,
                                              nullptr,
                                              mode); // do not support RReLU and Leaky RelU
+        for (base::ArgsType<T> &args : m_args) {
+            args.winograd_filter_element = m_winograd_filter;
+            args.sparse_filter_element = m_sparse_filter;
+        }
+        if (!m_filter_exponents.empty()) {
+            base::set_conv_per_channel_args<T>(m_args, output, input, m_filter_exponents, m_channel_shift);
+        }
         int task_size = m_args.size();
         if (task_size == 1) { // single task
             forward_args((void *)&m_args[0]);
@@ -197,13 +297,14 @@ public:
     {
         ESP_LOGI("Conv",
                  "pads: %s, strides: %s, dilations: %s, group: %d, activation: %s, "
-                 "quant_type: %s.",
+                 "quant_type: %s%s.",
                  vector_to_string(m_pads).c_str(),
                  vector_to_string(m_strides).c_str(),
                  vector_to_string(m_dilations).c_str(),
                  m_group,
                  activation_type_to_string(activation),
-                 quant_type_to_string(quant_type));
+                 quant_type_to_string(quant_type),
+                 m_filter_exponents.empty() ? "" : " per-channel");
     }
 
     // void set_preload_addr(void *addr, size_t size)
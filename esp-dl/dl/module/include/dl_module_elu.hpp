@@ -82,6 +82,18 @@ public:
         }
     }
 
+    ActivationFunction get_lut_function(std::string &key)
+    {
+        // Not smooth, int16 table with linear interpolation is not exact around the kink.
+        if (quant_type == QUANT_TYPE_SYMM_8BIT) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "Elu:%a", m_alpha);
+            key = buf;
+            return [alpha = m_alpha](float x) { return x >= 0 ? x : alpha * (expf(x) - 1); };
+        }
+        return nullptr;
+    }
+
     /**
      * @brief deserialize Elu module instance by node serialization information
      */
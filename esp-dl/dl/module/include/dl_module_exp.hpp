@@ -74,6 +74,15 @@ public:
 
     void forward_args(void *args) {}
 
+    ActivationFunction get_lut_function(std::string &key)
+    {
+        if (quant_type == QUANT_TYPE_SYMM_8BIT || quant_type == QUANT_TYPE_SYMM_16BIT) {
+            key = "Exp";
+            return [](float x) { return expf(x); };
+        }
+        return nullptr;
+    }
+
     /**
      * @brief deserialize Exp module instance by node serialization information
      */
@@ -67,16 +67,29 @@ public:
     }
 
     template <typename T1, typename T2>
-    void forward_template(
-        T1 *output, T1 *input, T2 *indices, int outer_size, int inner_size, int indices_num, int in_axis_size)
+    void forward_template(T1 *output,
+                          T1 *input,
+                          T2 *indices,
+                          int outer_size,
+                          int inner_size,
+                          int indices_num,
+                          int in_axis_size,
+                          runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE)
     {
-        for (int outer = 0; outer < outer_size; outer++) {
-            for (int i = 0; i < indices_num; i++) {
-                tool::copy_memory(output + (outer * indices_num + i) * inner_size,
-                                  input + (outer * in_axis_size + static_cast<int>(indices[i])) * inner_size,
-                                  inner_size * sizeof(T1));
-            }
-        }
+        // every (outer, i) copies one slice
+        module_parallel_for(
+            outer_size * indices_num,
+            mode,
+            [&](int start, int end) {
+                for (int n = start; n < end; n++) {
+                    int outer = n / indices_num;
+                    int i = n % indices_num;
+                    tool::copy_memory(output + n * inner_size,
+                                      input + (outer * in_axis_size + static_cast<int>(indices[i])) * inner_size,
+                                      inner_size * sizeof(T1));
+                }
+            },
+            inner_size);
     }
 
     void forward(ModelContext *context, runtime_mode_t mode)
@@ -103,7 +116,8 @@ public:
                                  outer_size,
                                  inner_size,
                                  indices_num,
-                                 input->get_shape()[m_axis]);
+                                 input->get_shape()[m_axis],
+                                 mode);
 
             } else if (input->get_dtype() == dl::DATA_TYPE_INT16) {
                 forward_template(static_cast<int16_t *>(output->get_element_ptr()),
@@ -112,7 +126,8 @@ public:
                                  outer_size,
                                  inner_size,
                                  indices_num,
-                                 input->get_shape()[m_axis]);
+                                 input->get_shape()[m_axis],
+                                 mode);
 
             } else if (input->get_dtype() == dl::DATA_TYPE_FLOAT) {
                 forward_template(static_cast<float *>(output->get_element_ptr()),
@@ -121,7 +136,8 @@ public:
                                  outer_size,
                                  inner_size,
                                  indices_num,
-                                 input->get_shape()[m_axis]);
+                                 input->get_shape()[m_axis],
+                                 mode);
 
             } else if (input->get_dtype() == dl::DATA_TYPE_DOUBLE) {
                 forward_template(static_cast<double *>(output->get_element_ptr()),
@@ -130,7 +146,8 @@ public:
                                  outer_size,
                                  inner_size,
                                  indices_num,
-                                 input->get_shape()[m_axis]);
+                                 input->get_shape()[m_axis],
+                                 mode);
             }
         } else if (m_indices->get_dtype() == dl::DATA_TYPE_INT32) {
             if (input->get_dtype() == dl::DATA_TYPE_INT8) {
@@ -140,7 +157,8 @@ public:
                                  outer_size,
                                  inner_size,
                                  indices_num,
-                                 input->get_shape()[m_axis]);
+                                 input->get_shape()[m_axis],
+                                 mode);
 
             } else if (input->get_dtype() == dl::DATA_TYPE_INT16) {
                 forward_template(static_cast<int16_t *>(output->get_element_ptr()),
@@ -149,7 +167,8 @@ public:
                                  outer_size,
                                  inner_size,
                                  indices_num,
-                                 input->get_shape()[m_axis]);
+                                 input->get_shape()[m_axis],
+                                 mode);
 
             } else if (input->get_dtype() == dl::DATA_TYPE_FLOAT) {
                 forward_template(static_cast<float *>(output->get_element_ptr()),
@@ -158,7 +177,8 @@ public:
                                  outer_size,
                                  inner_size,
                                  indices_num,
-                                 input->get_shape()[m_axis]);
+                                 input->get_shape()[m_axis],
+                                 mode);
 
             } else if (input->get_dtype() == dl::DATA_TYPE_DOUBLE) {
                 forward_template(static_cast<double *>(output->get_element_ptr()),
@@ -167,7 +187,8 @@ public:
                                  outer_size,
                                  inner_size,
                                  indices_num,
-                                 input->get_shape()[m_axis]);
+                                 input->get_shape()[m_axis],
+                                 mode);
             }
         }
     }
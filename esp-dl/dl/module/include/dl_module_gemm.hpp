@@ -1,6 +1,7 @@
 #pragma once
 
 #include "dl_base_conv2d.hpp"
+#include "dl_base_conv2d_sparse.hpp"
 #include "dl_base_depthwise_conv2d.hpp"
 #include "dl_module_base.hpp"
 #include <typeinfo>
@@ -18,13 +19,20 @@ class Gemm : public Module {
 private:
     activation_type_t activation; /*!< activation of Gemm, if you don't specify anything, no activation is applied */
     bool is_bias_reseted;
+    std::vector<int> m_filter_exponents;    /*!< exponent of every output channel, empty if quantized per-tensor */
+    std::vector<int16_t> m_channel_shift;   /*!< per-channel mac_shift computed from m_filter_exponents */
+    base::sparse_filter_t *m_sparse_filter; /*!< block-sparse filter of conv2d_sparse, NULL if the filter is dense */
+    const void *m_sparse_source;            /*!< filter data which m_sparse_filter is packed from */
 
     void reset_bias(ModelContext *context)
     {
         if (is_bias_reseted == false) {
             if (m_inputs_index.size() == 3) {
                 TensorBase *bias = context->get_tensor(m_inputs_index[2]);
-                if (bias) {
+                bool filter_int4 = context->get_tensor(m_inputs_index[1])->dtype == DATA_TYPE_INT4;
+                // per-channel and int4 Gemm have C/C++ implementation only, which reads the bias in the original
+                // layout
+                if (bias && m_filter_exponents.empty() && !filter_int4) {
                     bias->reset_bias_layout(quant_type, false);
                 }
             }
@@ -32,16 +40,49 @@ private:
         }
     }
 
+    template <typename T>
+    void pack_sparse_filter(TensorBase *filter)
+    {
+#if !CONFIG_TIE728_BOOST && !CONFIG_ESP32P4_BOOST
+        // ISA targets keep the assembly 1x1 kernels and their filter layout
+        if (m_sparse_source == filter->data) {
+            return;
+        }
+        heap_caps_free(m_sparse_filter);
+        m_sparse_filter = nullptr;
+        m_sparse_source = filter->data;
+        if (filter->dtype != DATA_TYPE_INT4) {
+            m_sparse_filter = base::conv2d_sparse_pack_filter<T>(
+                (T *)filter->get_element_ptr(), filter->shape[3], filter->shape[2]);
+        }
+#endif
+    }
+
 public:
     /**
      * @brief Construct a new Gemm object.
      *
      * @param activation      activation of Gemm, if you don't specify anything, no activation is applied
      * @param name            name of module
+     * @param quant_type      quantization type of Gemm
+     * @param filter_exponents exponent of every output channel of filter, empty if quantized per-tensor. The bias of
+     * channel n must be quantized with exponent input.exponent + filter_exponents[n]. int8 on C/C++ targets only, the
+     * ISA kernels of ESP32-S3 and ESP32-P4 take one mac_shift. The fbs loader only supports PER_TENSOR quantization,
+     * so a Gemm deserialized from .espdl is always per-tensor.
      */
-    Gemm(activation_type_t activation = Linear, const char *name = nullptr, quant_type_t quant_type = QUANT_TYPE_NONE) :
-        Module(name, MODULE_NON_INPLACE, quant_type), activation(activation)
+    Gemm(activation_type_t activation = Linear,
+         const char *name = nullptr,
+         quant_type_t quant_type = QUANT_TYPE_NONE,
+         std::vector<int> filter_exponents = {}) :
+        Module(name, MODULE_NON_INPLACE, quant_type),
+        activation(activation),
+        m_filter_exponents(filter_exponents),
+        m_sparse_filter(nullptr),
+        m_sparse_source(nullptr)
     {
+#if CONFIG_TIE728_BOOST || CONFIG_ESP32P4_BOOST
+        assert(filter_exponents.empty());
+#endif
         is_bias_reseted = false;
     }
 
@@ -49,7 +90,7 @@ public:
      * @brief Destroy the Gemm object.
      *
      */
-    ~Gemm() {}
+    ~Gemm() { heap_caps_free(m_sparse_filter); }
 
     /**
      * @brief Calculate the output shape
@@ -76,9 +117,19 @@ public:
     void forward_args(void *args)
     {
         if (quant_type == QUANT_TYPE_SYMM_8BIT) {
-            base::conv2d<int8_t, int32_t, int32_t>(args);
+            forward_args_template<int8_t, int32_t, int32_t>(args);
         } else if (quant_type == QUANT_TYPE_SYMM_16BIT) {
-            base::conv2d<int16_t, int32_t, int64_t>(args);
+            forward_args_template<int16_t, int32_t, int64_t>(args);
+        }
+    }
+
+    template <typename T, typename bias_t, typename buffer_t>
+    void forward_args_template(void *args)
+    {
+        if (((base::ArgsType<T> *)args)->sparse_filter_element) {
+            base::conv2d_sparse<T, bias_t, buffer_t>(args);
+        } else {
+            base::conv2d<T, bias_t, buffer_t>(args);
         }
     }
 
@@ -93,6 +144,8 @@ public:
             bias = context->get_tensor(m_inputs_index[2]);
         }
         TensorBase *output = context->get_tensor(m_outputs_index[0]);
+        assert(filter->dtype != DATA_TYPE_INT4 || (std::is_same<T, int8_t>::value)); // int4 filter is int8 only
+        pack_sparse_filter<T>(filter);
         std::vector<int> origin_input_shape = input0->get_shape();
         std::vector<int> origin_output_shape = output->get_shape();
         input0->set_shape({1, 1, input0->get_size() / origin_input_shape.back(), origin_input_shape.back()});
@@ -110,6 +163,12 @@ public:
                                              this->activation,
                                              nullptr,
                                              mode); // do not support PReLU and Leaky RelU
+        for (base::ArgsType<T> &args : m_args) {
+            args.sparse_filter_element = m_sparse_filter;
+        }
+        if (!m_filter_exponents.empty()) {
+            base::set_conv_per_channel_args<T>(m_args, output, input0, m_filter_exponents, m_channel_shift);
+        }
         int task_size = m_args.size();
         if (task_size == 1) { // single task
             forward_args((void *)&m_args[0]);
@@ -162,9 +221,10 @@ public:
     void print()
     {
         ESP_LOGI("Gemm",
-                 "activation: %s, quant_type: %s.",
+                 "activation: %s, quant_type: %s%s.",
                  activation_type_to_string(activation),
-                 quant_type_to_string(quant_type));
+                 quant_type_to_string(quant_type),
+                 m_filter_exponents.empty() ? "" : " per-channel");
     }
 };
 } // namespace module
@@ -86,6 +86,20 @@ public:
 
     void forward_args(void *args) {}
 
+    ActivationFunction get_lut_function(std::string &key)
+    {
+        // Not smooth, int16 table with linear interpolation is not exact around the kink.
+        if (quant_type == QUANT_TYPE_SYMM_8BIT) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "HardSigmoid:%a:%a", alpha, beta);
+            key = buf;
+            return [alpha = this->alpha, beta = this->beta](float x) {
+                return (float)DL_MAX(0, DL_MIN(1, alpha * x + beta));
+            };
+        }
+        return nullptr;
+    }
+
     /**
      * @brief deserialize HardSigmoid module instance by node serialization information
      */
@@ -78,6 +78,16 @@ public:
 
     void forward_args(void *args) {}
 
+    ActivationFunction get_lut_function(std::string &key)
+    {
+        // Not smooth, int16 table with linear interpolation is not exact around the kink.
+        if (quant_type == QUANT_TYPE_SYMM_8BIT) {
+            key = "HardSwish";
+            return [](float x) { return (float)(DL_MAX(0, DL_MIN(1, 0.166667 * x + 0.5)) * x); };
+        }
+        return nullptr;
+    }
+
     /**
      * @brief deserialize HardSwish module instance by node serialization information
      */
@@ -164,134 +164,98 @@ public:
             inner_dim *= x_shape[i];
         }
 
-        // Use compile-time branching to eliminate runtime if statements
-        if constexpr (std::is_same_v<T, float>) {
-            // Float32 path - direct computation
-            for (int i = 0; i < outer_dim; i++) {
-                float *x_slice = reinterpret_cast<float *>(x_ptr) + i * inner_dim;
-                float *y_slice = reinterpret_cast<float *>(y_ptr) + i * inner_dim;
-
-                // Calculate mean
-                float mean_val = 0.0f;
-                for (int j = 0; j < inner_dim; j++) {
-                    mean_val += x_slice[j];
-                }
-                mean_val /= inner_dim;
-
-                // Store mean if output tensor exists
-                if (mean_ptr && mean) {
-                    reinterpret_cast<float *>(mean_ptr)[i] = mean_val;
-                }
-
-                // Calculate variance
-                float variance = 0.0f;
-                for (int j = 0; j < inner_dim; j++) {
-                    float diff = x_slice[j] - mean_val;
-                    variance += diff * diff;
-                }
-                variance /= inner_dim;
-
-                // Add epsilon and calculate inverse standard deviation
-                float inv_std = 1.0f / dl::math::sqrt_newton(variance + m_epsilon);
-                // float inv_std = math::fast_inv_sqrt(variance + m_epsilon); // faster but less accurate
-
-                // Store inverse standard deviation if output tensor exists
-                if (inv_std_dev_ptr && inv_std_dev) {
-                    reinterpret_cast<float *>(inv_std_dev_ptr)[i] = inv_std;
-                }
-
-                // Normalize and apply scale/bias
-                float *scale_slice = scale_ptr ? reinterpret_cast<float *>(scale_ptr) : nullptr;
-                float *bias_slice = bias_ptr ? reinterpret_cast<float *>(bias_ptr) : nullptr;
-                for (int j = 0; j < inner_dim; j++) {
-                    float x_val = x_slice[j];
-                    float normalized = (x_val - mean_val) * inv_std;
-
-                    float scale_val = scale_slice ? scale_slice[j] : 1.0f;
-                    float bias_val = bias_slice ? bias_slice[j] : 0.0f;
+        // Scale and bias folded with their exponents and the output exponent, y = (x * a + c) * gamma[j] + beta[j]
+        // with a = input_scale * inv_std and c = -mean * inv_std of every slice
+        float input_scale = 1.0f;
+        float output_scale = 1.0f;
+        float scale_scale = 1.0f;
+        float bias_scale = 1.0f;
+        if constexpr (!std::is_same_v<T, float>) {
+            input_scale = DL_SCALE(x->exponent);
+            output_scale = DL_RESCALE(y->exponent);
+            scale_scale = scale ? DL_SCALE(scale->exponent) : 1.0f;
+            bias_scale = bias ? DL_SCALE(bias->exponent) : 1.0f;
+        }
+        std::vector<float> gamma(inner_dim);
+        std::vector<float> beta(inner_dim);
+        for (int j = 0; j < inner_dim; j++) {
+            gamma[j] = (scale_ptr ? scale_ptr[j] * scale_scale : 1.0f) * output_scale;
+            beta[j] = (bias_ptr ? bias_ptr[j] * bias_scale : 0.0f) * output_scale;
+        }
 
-                    y_slice[j] = normalized * scale_val + bias_val;
-                }
-            }
-        } else {
-            // Quantized path (int8_t or int16_t)
-            // Get quantization scales
-            float input_scale = DL_SCALE(x->exponent);
-            float output_scale = DL_RESCALE(y->exponent);
-            float scale_scale = scale ? DL_SCALE(scale->exponent) : 1.0f;
-            float bias_scale = bias ? DL_SCALE(bias->exponent) : 0.0f;
-            float mean_output_scale = mean ? DL_RESCALE(mean->exponent) : 1.0f;
-            float inv_std_dev_output_scale = inv_std_dev ? DL_RESCALE(inv_std_dev->exponent) : 1.0f;
-
-            for (int i = 0; i < outer_dim; i++) {
-                T *x_slice = x_ptr + i * inner_dim;
-                T *y_slice = y_ptr + i * inner_dim;
-
-                // Calculate mean
-                float mean_val = 0.0f;
-                int sum_val = 0;
-                for (int j = 0; j < inner_dim; j++) {
-                    sum_val += x_slice[j];
-                }
-                mean_val = sum_val * 1.0 / inner_dim;
-
-                // Store mean if output tensor exists
-                if (mean_ptr && mean) {
-                    if constexpr (std::is_same_v<T, int8_t>) {
-                        int8_t &output_ref = reinterpret_cast<int8_t &>(mean_ptr[i]);
-                        tool::truncate(output_ref, tool::round(mean_val * mean_output_scale * input_scale));
-                    } else if constexpr (std::is_same_v<T, int16_t>) {
-                        int16_t &output_ref = reinterpret_cast<int16_t &>(mean_ptr[i]);
-                        tool::truncate(output_ref, tool::round(mean_val * mean_output_scale * input_scale));
+        module_parallel_for(
+            outer_dim,
+            mode,
+            [&](int start, int end) {
+                for (int i = start; i < end; i++) {
+                    T *x_slice = x_ptr + i * inner_dim;
+                    T *y_slice = y_ptr + i * inner_dim;
+
+                    // Calculate mean and variance in one pass
+                    float mean_val;
+                    float variance;
+                    if constexpr (std::is_same_v<T, float>) {
+                        // shifted by the first element to keep sum of squares from cancelling
+                        float shift = x_slice[0];
+                        float sum = 0.0f;
+                        float sum_sq = 0.0f;
+                        for (int j = 0; j < inner_dim; j++) {
+                            float diff = x_slice[j] - shift;
+                            sum += diff;
+                            sum_sq += diff * diff;
+                        }
+                        mean_val = shift + sum / inner_dim;
+                        variance = (sum_sq - sum * sum / inner_dim) / inner_dim;
+                    } else {
+                        // exact in integer, n * sum(x^2) - sum(x)^2 = n^2 * variance
+                        int32_t sum = 0;
+                        int64_t sum_sq = 0;
+                        for (int j = 0; j < inner_dim; j++) {
+                            int32_t x_val = x_slice[j];
+                            sum += x_val;
+                            sum_sq += x_val * x_val;
+                        }
+                        int64_t n_var = sum_sq * inner_dim - (int64_t)sum * sum;
+                        mean_val = (float)sum / inner_dim * input_scale;
+                        variance = (float)n_var / ((float)inner_dim * inner_dim) * input_scale * input_scale;
                     }
-                }
-
-                // Calculate variance
-                float variance = 0.0f;
-                for (int j = 0; j < inner_dim; j++) {
-                    float diff = x_slice[j] - mean_val;
-                    variance += diff * diff;
-                }
-                mean_val *= input_scale;
-                variance *= input_scale * input_scale;
-                variance /= inner_dim;
-
-                // Add epsilon and calculate inverse standard deviation
-                float inv_std = 1.0f / dl::math::sqrt_newton(variance + m_epsilon);
-                // float inv_std = math::fast_inv_sqrt(variance + m_epsilon); // faster but less accurate
-
-                // Store inverse standard deviation if output tensor exists
-                if (inv_std_dev_ptr && inv_std_dev) {
-                    if constexpr (std::is_same_v<T, int8_t>) {
-                        int8_t &output_ref = reinterpret_cast<int8_t &>(inv_std_dev_ptr[i]);
-                        tool::truncate(output_ref, tool::round(inv_std * inv_std_dev_output_scale));
-                    } else if constexpr (std::is_same_v<T, int16_t>) {
-                        int16_t &output_ref = reinterpret_cast<int16_t &>(inv_std_dev_ptr[i]);
-                        tool::truncate(output_ref, tool::round(inv_std * inv_std_dev_output_scale));
+                    variance = DL_MAX(variance, 0.0f);
+
+                    // Add epsilon and calculate inverse standard deviation
+                    float inv_std = math::rsqrt(variance + m_epsilon);
+
+                    // Store mean and inverse standard deviation if output tensors exist
+                    if constexpr (std::is_same_v<T, float>) {
+                        if (mean_ptr) {
+                            mean_ptr[i] = mean_val;
+                        }
+                        if (inv_std_dev_ptr) {
+                            inv_std_dev_ptr[i] = inv_std;
+                        }
+                    } else {
+                        if (mean_ptr) {
+                            tool::truncate(mean_ptr[i], tool::round(mean_val * DL_RESCALE(mean->exponent)));
+                        }
+                        if (inv_std_dev_ptr) {
+                            tool::truncate(inv_std_dev_ptr[i],
+                                           tool::round(inv_std * DL_RESCALE(inv_std_dev->exponent)));
+                        }
                     }
-                }
-
-                // Normalize and apply scale/bias
-                for (int j = 0; j < inner_dim; j++) {
-                    float x_val = x_slice[j] * input_scale;
-                    float normalized = (x_val - mean_val) * inv_std;
-
-                    float scale_val = scale_ptr ? scale_ptr[j] * scale_scale : 1.0f;
-                    float bias_val = bias_ptr ? bias_ptr[j] * bias_scale : 0.0f;
 
-                    float result = normalized * scale_val + bias_val;
-
-                    // Use appropriate truncate based on quantization type
-                    if constexpr (std::is_same_v<T, int8_t>) {
-                        int8_t &output_ref = reinterpret_cast<int8_t &>(y_slice[j]);
-                        tool::truncate(output_ref, tool::round(result * output_scale));
-                    } else if constexpr (std::is_same_v<T, int16_t>) {
-                        int16_t &output_ref = reinterpret_cast<int16_t &>(y_slice[j]);
-                        tool::truncate(output_ref, tool::round(result * output_scale));
+                    // Normalize and apply scale/bias
+                    float a = input_scale * inv_std;
+                    float c = -mean_val * inv_std;
+                    for (int j = 0; j < inner_dim; j++) {
+                        float result = (x_slice[j] * a + c) * gamma[j] + beta[j];
+                        if constexpr (std::is_same_v<T, float>) {
+                            y_slice[j] = result;
+                        } else {
+                            tool::truncate(y_slice[j], tool::round(result));
+                        }
                     }
                 }
-            }
-        }
+            },
+            inner_dim);
     }
 
     /**
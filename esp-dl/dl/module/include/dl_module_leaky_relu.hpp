@@ -75,14 +75,14 @@ public:
         T *input_ptr = (T *)input->get_element_ptr();
         T *output_ptr = (T *)output->get_element_ptr();
 
-        float input_scale = DL_SCALE(input->exponent);
-        float output_scale = DL_RESCALE(output->exponent);
+        float rescale = DL_SCALE(input->exponent) * DL_RESCALE(output->exponent);
+        tool::requant_t requant = tool::get_requant(rescale);
+        tool::requant_t requant_alpha = tool::get_requant(rescale * this->alpha);
         for (size_t i = 0; i < input->size; i++) {
-            float temp = input_ptr[i] * input_scale;
-            if (temp >= 0) {
-                tool::truncate(output_ptr[i], tool::round(temp * output_scale));
+            if (input_ptr[i] >= 0) {
+                output_ptr[i] = tool::requantize<T>(input_ptr[i], requant);
             } else {
-                tool::truncate(output_ptr[i], tool::round(temp * output_scale * this->alpha));
+                output_ptr[i] = tool::requantize<T>(input_ptr[i], requant_alpha);
             }
         }
     }
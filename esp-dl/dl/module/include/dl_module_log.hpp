@@ -73,6 +73,15 @@ public:
 
     void forward_args(void *args) {}
 
+    ActivationFunction get_lut_function(std::string &key)
+    {
+        if (quant_type == QUANT_TYPE_SYMM_8BIT || quant_type == QUANT_TYPE_SYMM_16BIT) {
+            key = "Log";
+            return [](float x) { return logf(x); };
+        }
+        return nullptr;
+    }
+
     /**
      * @brief deserialize Log module instance by node serialization information
      */
@@ -101,20 +101,98 @@ public:
         int batch_size = (m_layout == 0) ? x_shape[1] : x_shape[0];
 
         std::vector<int> y_shape;
-        y_shape = {seq_length, m_direction_num, batch_size, m_hidden_size};
-        output_shapes.push_back(y_shape);
-
         std::vector<int> y_h_shape;
-        y_h_shape = {m_direction_num, batch_size, m_hidden_size};
+        if (m_layout == 0) {
+            y_shape = {seq_length, m_direction_num, batch_size, m_hidden_size};
+            y_h_shape = {m_direction_num, batch_size, m_hidden_size};
+        } else {
+            y_shape = {batch_size, seq_length, m_direction_num, m_hidden_size};
+            y_h_shape = {batch_size, m_direction_num, m_hidden_size};
+        }
+        output_shapes.push_back(y_shape);
         output_shapes.push_back(y_h_shape);
-
-        std::vector<int> y_c_shape;
-        y_c_shape = {m_direction_num, batch_size, m_hidden_size};
-        output_shapes.push_back(y_c_shape);
+        output_shapes.push_back(y_h_shape); // Y_c
 
         return output_shapes;
     }
 
+    /**
+     * @brief Index of x_t of sequence b in X, in vectors of input_size.
+     *        layout 0: X is [seq_length, batch_size, input_size], layout 1: X is [batch_size, seq_length, input_size]
+     */
+    int get_x_index(int seq, int b, int seq_length, int batch_size)
+    {
+        return (m_layout == 0) ? seq * batch_size + b : b * seq_length + seq;
+    }
+
+    /**
+     * @brief Index of y_t of sequence b in Y, in vectors of hidden_size.
+     *        layout 0: Y is [seq_length, num_directions, batch_size, hidden_size],
+     *        layout 1: Y is [batch_size, seq_length, num_directions, hidden_size]
+     */
+    int get_y_index(int seq, int di, int b, int seq_length, int batch_size)
+    {
+        return (m_layout == 0) ? (seq * m_direction_num + di) * batch_size + b
+                               : (b * seq_length + seq) * m_direction_num + di;
+    }
+
+    /**
+     * @brief Index of the state of sequence b in initial_h, initial_c, Y_h and Y_c, in vectors of hidden_size.
+     *        layout 0: [num_directions, batch_size, hidden_size], layout 1: [batch_size, num_directions, hidden_size]
+     */
+    int get_state_index(int di, int b, int batch_size)
+    {
+        return (m_layout == 0) ? di * batch_size + b : b * m_direction_num + di;
+    }
+
+    bool check_weight_shape(TensorBase *input_w, TensorBase *input_r, int input_size)
+    {
+        std::vector<int> w_shape = input_w->get_shape();
+        std::vector<int> r_shape = input_r->get_shape();
+
+        if (w_shape.size() != 3 || w_shape[0] != m_direction_num || w_shape[1] != 4 * m_hidden_size ||
+            w_shape[2] != input_size) {
+            ESP_LOGE("LSTM", "Invalid W tensor shape");
+            return false;
+        }
+
+        if (r_shape.size() != 3 || r_shape[0] != m_direction_num || r_shape[1] != 4 * m_hidden_size ||
+            r_shape[2] != m_hidden_size) {
+            ESP_LOGE("LSTM", "Invalid R tensor shape");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Allocate the caches and states for the shape of X, they are reused until the shape of X is changed.
+     */
+    void alloc_cache(int seq_length, int batch_size, TensorBase *output_h, TensorBase *output_c)
+    {
+        int gate_size = 4 * m_hidden_size;
+        if (m_input_cache && m_input_cache->get_size() == seq_length * batch_size * gate_size &&
+            m_h_prev->get_size() == batch_size * m_hidden_size) {
+            return;
+        }
+        delete m_input_cache;
+        delete m_hidden_cache;
+        delete m_h_prev;
+        delete m_c_prev;
+
+        if (quant_type == QUANT_TYPE_SYMM_8BIT || quant_type == QUANT_TYPE_SYMM_16BIT) {
+            m_input_cache =
+                new TensorBase({seq_length * batch_size, gate_size}, nullptr, m_gate_exponent, DATA_TYPE_INT16);
+            m_hidden_cache = new TensorBase({batch_size, gate_size}, nullptr, m_gate_exponent, DATA_TYPE_INT16);
+        } else {
+            m_input_cache = new TensorBase({seq_length * batch_size, gate_size}, nullptr);
+            m_hidden_cache = new TensorBase({batch_size, gate_size}, nullptr);
+        }
+        m_h_prev = new TensorBase(
+            {batch_size, m_hidden_size}, nullptr, output_h->get_exponent(), output_h->get_dtype());
+        m_c_prev = new TensorBase(
+            {batch_size, m_hidden_size}, nullptr, output_c->get_exponent(), output_c->get_dtype());
+    }
+
     void forward(ModelContext *context, runtime_mode_t mode) override
     {
         if (quant_type == QUANT_TYPE_SYMM_8BIT) {
@@ -154,71 +232,31 @@ public:
         // Extract dimensions and New variables
         std::vector<int> x_shape = input_x->get_shape();
         int seq_length = (m_layout == 0) ? x_shape[0] : x_shape[1];
+        int batch_size = (m_layout == 0) ? x_shape[1] : x_shape[0];
         int input_size = x_shape[2];
+        int gate_size = 4 * m_hidden_size;
         if (m_first_step) {
             m_first_step = false;
-            m_input_cache = new TensorBase({4 * m_hidden_size}, nullptr, m_gate_exponent, DATA_TYPE_INT16);
-            m_hidden_cache = new TensorBase({4 * m_hidden_size}, nullptr, m_gate_exponent, DATA_TYPE_INT16);
-            m_h_prev = new TensorBase({m_hidden_size}, nullptr, output_h->get_exponent(), output_h->get_dtype());
-            m_c_prev = new TensorBase({m_hidden_size}, nullptr, output_c->get_exponent(), output_c->get_dtype());
             assert(output_c->get_dtype() == DATA_TYPE_INT16);
             assert(output_c->get_exponent() == m_gate_exponent);
-
-            // Validate input dimensions
-            std::vector<int> w_shape = input_w->get_shape();
-            std::vector<int> r_shape = input_r->get_shape();
-
-            if (w_shape.size() != 3 || w_shape[0] != m_direction_num || w_shape[1] != 4 * m_hidden_size ||
-                w_shape[2] != input_size) {
-                ESP_LOGE("LSTM", "Invalid W tensor shape");
-                return;
-            }
-
-            if (r_shape.size() != 3 || r_shape[0] != m_direction_num || r_shape[1] != 4 * m_hidden_size ||
-                r_shape[2] != m_hidden_size) {
-                ESP_LOGE("LSTM", "Invalid R tensor shape");
+            if (!check_weight_shape(input_w, input_r, input_size)) {
                 return;
             }
         }
+        alloc_cache(seq_length, batch_size, output_h, output_c);
 
-        // Process sequence, currently only support batch_size = 1 and forward direction
         T *x_items = input_x->get_element_ptr<T>();
-        T *w_items = input_w->get_element_ptr<T>();
-        T *r_items = input_r->get_element_ptr<T>();
         T *h_prev_items = m_h_prev->get_element_ptr<T>();
-        T *initial_h_items = nullptr;
-        int16_t *initial_c_items = nullptr;
+        T *initial_h_items = initial_h ? initial_h->get_element_ptr<T>() : nullptr;
+        int16_t *initial_c_items = initial_c ? initial_c->get_element_ptr<int16_t>() : nullptr;
         int16_t *c_prev_items = m_c_prev->get_element_ptr<int16_t>();
-        int16_t *wb_items = nullptr;
-        int16_t *rb_items = nullptr;
-        if (input_b) {
-            wb_items = input_b->get_element_ptr<int16_t>();
-            rb_items = wb_items + 4 * m_hidden_size;
-        }
-        if (initial_h) {
-            initial_h_items = initial_h->get_element_ptr<T>();
-            memcpy(h_prev_items, initial_h_items, m_hidden_size * sizeof(T));
-        } else {
-            memset(h_prev_items, 0, m_hidden_size * sizeof(T));
-        }
-        if (initial_c) {
-            initial_c_items = initial_c->get_element_ptr<int16_t>();
-            memcpy(c_prev_items, initial_c_items, m_hidden_size * sizeof(int16_t));
-        } else {
-            memset(c_prev_items, 0, m_hidden_size * sizeof(int16_t));
-        }
-
         T *y_items = output_y->get_element_ptr<T>();
         T *h_items = output_h->get_element_ptr<T>();
         int16_t *c_items = output_c->get_element_ptr<int16_t>();
         int16_t *input_cache_items = m_input_cache->get_element_ptr<int16_t>();
         int16_t *hidden_cache_items = m_hidden_cache->get_element_ptr<int16_t>();
 
-        // W/R/B parameter weight matrix for input, output, forget, and cell gates
-        int16_t *i_gate_in = input_cache_items;
-        int16_t *o_gate_in = input_cache_items + m_hidden_size;
-        int16_t *f_gate_in = input_cache_items + 2 * m_hidden_size;
-        int16_t *g_gate_in = input_cache_items + 3 * m_hidden_size;
+        // Gates of one sequence: input, output, forget, and cell
         float *i_gate = m_gates;
         float *o_gate = m_gates + m_hidden_size;
         float *f_gate = m_gates + 2 * m_hidden_size;
@@ -230,77 +268,84 @@ public:
         int r_shift = m_gate_exponent - (m_h_prev->exponent + input_r->exponent);
 
         for (int di = 0; di < m_direction_num; di++) {
-            if (di == 1) {
-                x_items = x_items - input_size;
-                y_items = y_items - m_hidden_size;
-                w_items += 4 * m_hidden_size * input_size;
-                r_items += 4 * m_hidden_size * m_hidden_size;
-                if (input_b) {
-                    wb_items = wb_items + 8 * m_hidden_size;
-                    rb_items = wb_items + 4 * m_hidden_size;
-                }
+            T *w_items = input_w->get_element_ptr<T>() + di * gate_size * input_size;
+            T *r_items = input_r->get_element_ptr<T>() + di * gate_size * m_hidden_size;
+            int16_t *wb_items = nullptr;
+            int16_t *rb_items = nullptr;
+            if (input_b) {
+                wb_items = input_b->get_element_ptr<int16_t>() + di * 2 * gate_size;
+                rb_items = wb_items + gate_size;
+            }
+            for (int b = 0; b < batch_size; b++) {
+                int offset = get_state_index(di, b, batch_size) * m_hidden_size;
                 if (initial_h_items) {
-                    memcpy(h_prev_items, initial_h_items + m_hidden_size, m_hidden_size * sizeof(T));
+                    memcpy(h_prev_items + b * m_hidden_size, initial_h_items + offset, m_hidden_size * sizeof(T));
                 } else {
-                    memset(h_prev_items, 0, m_hidden_size * sizeof(T));
+                    memset(h_prev_items + b * m_hidden_size, 0, m_hidden_size * sizeof(T));
                 }
-
                 if (initial_c_items) {
-                    memcpy(c_prev_items, initial_c_items + m_hidden_size, m_hidden_size * sizeof(int16_t));
+                    memcpy(c_prev_items + b * m_hidden_size, initial_c_items + offset, m_hidden_size * sizeof(int16_t));
                 } else {
-                    memset(c_prev_items, 0, m_hidden_size * sizeof(int16_t));
+                    memset(c_prev_items + b * m_hidden_size, 0, m_hidden_size * sizeof(int16_t));
                 }
             }
 
-            for (int seq = 0; seq < seq_length; seq++) {
-                // W * x_t
-                base::mat_vec_dotprod(w_items, x_items, input_cache_items, 4 * m_hidden_size, input_size, w_shift);
-                // R * h_prev
-                base::mat_vec_dotprod(
-                    r_items, h_prev_items, hidden_cache_items, 4 * m_hidden_size, m_hidden_size, r_shift);
-
-                // add bias
-                if (input_b) {
-                    for (int i = 0; i < 4 * m_hidden_size; i++) {
-                        input_cache_items[i] += wb_items[i] + hidden_cache_items[i] + rb_items[i];
-                    }
-                } else {
-                    for (int i = 0; i < 4 * m_hidden_size; i++) {
-                        input_cache_items[i] += hidden_cache_items[i];
+            // W * x_t of all time steps
+            base::mat_mat_dotprod(
+                w_items, x_items, input_cache_items, gate_size, input_size, seq_length * batch_size, w_shift);
+
+            for (int step = 0; step < seq_length; step++) {
+                int seq = (di == 0) ? step : seq_length - 1 - step;
+                // R * h_prev of all sequences in batch
+                base::mat_mat_dotprod(
+                    r_items, h_prev_items, hidden_cache_items, gate_size, m_hidden_size, batch_size, r_shift);
+
+                for (int b = 0; b < batch_size; b++) {
+                    int16_t *gate_in = input_cache_items + get_x_index(seq, b, seq_length, batch_size) * gate_size;
+                    int16_t *hidden_in = hidden_cache_items + b * gate_size;
+                    T *h_prev = h_prev_items + b * m_hidden_size;
+                    int16_t *c_prev = c_prev_items + b * m_hidden_size;
+                    T *y = y_items + get_y_index(seq, di, b, seq_length, batch_size) * m_hidden_size;
+
+                    // add bias
+                    if (input_b) {
+                        for (int i = 0; i < gate_size; i++) {
+                            gate_in[i] += wb_items[i] + hidden_in[i] + rb_items[i];
+                        }
+                    } else {
+                        for (int i = 0; i < gate_size; i++) {
+                            gate_in[i] += hidden_in[i];
+                        }
                     }
-                }
 
-                // Compute gates
-                for (int i = 0; i < m_hidden_size; i++) {
-                    i_gate[i] = m_sigmoid_lut->get(i_gate_in[i]);
-                    f_gate[i] = m_sigmoid_lut->get(f_gate_in[i]);
-                    g_gate[i] = m_tanh_lut->get(g_gate_in[i]);
-                    o_gate[i] = m_sigmoid_lut->get(o_gate_in[i]);
-                }
-
-                // Compute outputs
-                for (int i = 0; i < m_hidden_size; i++) {
-                    float temp = f_gate[i] * c_prev_items[i] + i_gate[i] * g_gate[i] * rescale_c;
-                    c_prev_items[i] = tool::round(temp);
+                    // Compute gates
+                    int16_t *i_gate_in = gate_in;
+                    int16_t *o_gate_in = gate_in + m_hidden_size;
+                    int16_t *f_gate_in = gate_in + 2 * m_hidden_size;
+                    int16_t *g_gate_in = gate_in + 3 * m_hidden_size;
+                    for (int i = 0; i < m_hidden_size; i++) {
+                        i_gate[i] = m_sigmoid_lut->get(i_gate_in[i]);
+                        f_gate[i] = m_sigmoid_lut->get(f_gate_in[i]);
+                        g_gate[i] = m_tanh_lut->get(g_gate_in[i]);
+                        o_gate[i] = m_sigmoid_lut->get(o_gate_in[i]);
+                    }
 
-                    temp = o_gate[i] * m_tanh_lut->get(c_prev_items[i]) * rescale_y;
-                    tool::truncate(h_prev_items[i], tool::round(temp));
-                    y_items[i] = h_prev_items[i];
-                }
+                    // Compute outputs
+                    for (int i = 0; i < m_hidden_size; i++) {
+                        float temp = f_gate[i] * c_prev[i] + i_gate[i] * g_gate[i] * rescale_c;
+                        c_prev[i] = tool::round(temp);
 
-                // Get input and output pointer for next time step
-                if (di == 0) {
-                    x_items += input_size;
-                    y_items += m_hidden_size * m_direction_num;
-                } else {
-                    x_items -= input_size;
-                    y_items -= m_hidden_size * m_direction_num;
+                        temp = o_gate[i] * m_tanh_lut->get(c_prev[i]) * rescale_y;
+                        tool::truncate(h_prev[i], tool::round(temp));
+                        y[i] = h_prev[i];
+                    }
                 }
             }
-            memcpy(h_items, h_prev_items, m_hidden_size * sizeof(T));
-            h_items += m_hidden_size;
-            memcpy(c_items, c_prev_items, m_hidden_size * sizeof(int16_t));
-            c_items += m_hidden_size;
+            for (int b = 0; b < batch_size; b++) {
+                int offset = get_state_index(di, b, batch_size) * m_hidden_size;
+                memcpy(h_items + offset, h_prev_items + b * m_hidden_size, m_hidden_size * sizeof(T));
+                memcpy(c_items + offset, c_prev_items + b * m_hidden_size, m_hidden_size * sizeof(int16_t));
+            }
         }
     }
 
@@ -331,135 +376,100 @@ public:
         // Extract dimensions and New variables
         std::vector<int> x_shape = input_x->get_shape();
         int seq_length = (m_layout == 0) ? x_shape[0] : x_shape[1];
+        int batch_size = (m_layout == 0) ? x_shape[1] : x_shape[0];
         int input_size = x_shape[2];
+        int gate_size = 4 * m_hidden_size;
         if (m_first_step) {
             m_first_step = false;
-            m_input_cache = new TensorBase({4 * m_hidden_size}, nullptr);
-            m_hidden_cache = new TensorBase({4 * m_hidden_size}, nullptr);
-            m_h_prev = new TensorBase({m_hidden_size}, nullptr);
-            m_c_prev = new TensorBase({m_hidden_size}, nullptr);
-
-            // Validate input dimensions
-            std::vector<int> w_shape = input_w->get_shape();
-            std::vector<int> r_shape = input_r->get_shape();
-
-            if (w_shape.size() != 3 || w_shape[0] != m_direction_num || w_shape[1] != 4 * m_hidden_size ||
-                w_shape[2] != input_size) {
-                ESP_LOGE("LSTM", "Invalid W tensor shape");
-                return;
-            }
-
-            if (r_shape.size() != 3 || r_shape[0] != m_direction_num || r_shape[1] != 4 * m_hidden_size ||
-                r_shape[2] != m_hidden_size) {
-                ESP_LOGE("LSTM", "Invalid R tensor shape");
+            if (!check_weight_shape(input_w, input_r, input_size)) {
                 return;
             }
         }
+        alloc_cache(seq_length, batch_size, output_h, output_c);
 
-        // Process sequence, currently only support batch_size = 1
         float *x_items = input_x->get_element_ptr<float>();
-        float *w_items = input_w->get_element_ptr<float>();
-        float *r_items = input_r->get_element_ptr<float>();
-        float *wb_items = nullptr;
-        float *rb_items = nullptr;
-        float *initial_h_items = nullptr;
-        float *initial_c_items = nullptr;
         float *h_prev_items = m_h_prev->get_element_ptr<float>();
         float *c_prev_items = m_c_prev->get_element_ptr<float>();
-        if (input_b) {
-            wb_items = input_b->get_element_ptr<float>();
-            rb_items = wb_items + 4 * m_hidden_size;
-        }
-        if (initial_h) {
-            initial_h_items = initial_h->get_element_ptr<float>();
-            memcpy(h_prev_items, initial_h_items, m_hidden_size * sizeof(float));
-        } else {
-            memset(h_prev_items, 0, m_hidden_size * sizeof(float));
-        }
-        if (initial_c) {
-            initial_c_items = initial_c->get_element_ptr<float>();
-            memcpy(c_prev_items, initial_c_items, m_hidden_size * sizeof(float));
-        } else {
-            memset(c_prev_items, 0, m_hidden_size * sizeof(float));
-        }
-
+        float *initial_h_items = initial_h ? initial_h->get_element_ptr<float>() : nullptr;
+        float *initial_c_items = initial_c ? initial_c->get_element_ptr<float>() : nullptr;
         float *y_items = output_y->get_element_ptr<float>();
         float *h_items = output_h->get_element_ptr<float>();
         float *c_items = output_c->get_element_ptr<float>();
-
         float *input_cache_items = m_input_cache->get_element_ptr<float>();
         float *hidden_cache_items = m_hidden_cache->get_element_ptr<float>();
 
-        // W/R/B parameter weight matrix for input, output, forget, and cell gates
-        float *i_gate = input_cache_items;
-        float *o_gate = input_cache_items + m_hidden_size;
-        float *f_gate = input_cache_items + 2 * m_hidden_size;
-        float *g_gate = input_cache_items + 3 * m_hidden_size;
-
         for (int di = 0; di < m_direction_num; di++) {
-            if (di == 1) {
-                x_items = x_items - input_size;
-                y_items = y_items - m_hidden_size;
-                w_items += 4 * m_hidden_size * input_size;
-                r_items += 4 * m_hidden_size * m_hidden_size;
-                if (input_b) {
-                    wb_items = input_b->get_element_ptr<float>() + 8 * m_hidden_size;
-                    rb_items = wb_items + 4 * m_hidden_size;
-                }
+            float *w_items = input_w->get_element_ptr<float>() + di * gate_size * input_size;
+            float *r_items = input_r->get_element_ptr<float>() + di * gate_size * m_hidden_size;
+            float *wb_items = nullptr;
+            float *rb_items = nullptr;
+            if (input_b) {
+                wb_items = input_b->get_element_ptr<float>() + di * 2 * gate_size;
+                rb_items = wb_items + gate_size;
+            }
+            for (int b = 0; b < batch_size; b++) {
+                int offset = get_state_index(di, b, batch_size) * m_hidden_size;
                 if (initial_h_items) {
-                    memcpy(h_prev_items, initial_h_items + m_hidden_size, m_hidden_size * sizeof(float));
+                    memcpy(h_prev_items + b * m_hidden_size, initial_h_items + offset, m_hidden_size * sizeof(float));
                 } else {
-                    memset(h_prev_items, 0, m_hidden_size * sizeof(float));
+                    memset(h_prev_items + b * m_hidden_size, 0, m_hidden_size * sizeof(float));
                 }
-                if (initial_c) {
-                    memcpy(c_prev_items, initial_c_items + m_hidden_size, m_hidden_size * sizeof(float));
+                if (initial_c_items) {
+                    memcpy(c_prev_items + b * m_hidden_size, initial_c_items + offset, m_hidden_size * sizeof(float));
                 } else {
-                    memset(c_prev_items, 0, m_hidden_size * sizeof(float));
+                    memset(c_prev_items + b * m_hidden_size, 0, m_hidden_size * sizeof(float));
                 }
             }
-            for (int seq = 0; seq < seq_length; seq++) {
-                // W * x_t + bias
-                // R * h_t + bias
-                base::mat_vec_dotprod(w_items, x_items, input_cache_items, 4 * m_hidden_size, input_size, 0);
-                base::mat_vec_dotprod(r_items, h_prev_items, hidden_cache_items, 4 * m_hidden_size, m_hidden_size, 0);
-
-                if (input_b) {
-                    for (int i = 0; i < 4 * m_hidden_size; i++) {
-                        input_cache_items[i] += wb_items[i] + hidden_cache_items[i] + rb_items[i];
-                    }
-                } else {
-                    for (int i = 0; i < 4 * m_hidden_size; i++) {
-                        input_cache_items[i] += hidden_cache_items[i];
-                    }
-                }
 
-                // Compute gates
-                for (int i = 0; i < m_hidden_size; i++) {
-                    i_gate[i] = math::sigmoid(i_gate[i]);
-                    f_gate[i] = math::sigmoid(f_gate[i]);
-                    g_gate[i] = math::tanh(g_gate[i]);
-                    o_gate[i] = math::sigmoid(o_gate[i]);
-                }
+            // W * x_t of all time steps
+            base::mat_mat_dotprod(w_items, x_items, input_cache_items, gate_size, input_size, seq_length * batch_size);
+
+            for (int step = 0; step < seq_length; step++) {
+                int seq = (di == 0) ? step : seq_length - 1 - step;
+                // R * h_prev of all sequences in batch
+                base::mat_mat_dotprod(r_items, h_prev_items, hidden_cache_items, gate_size, m_hidden_size, batch_size);
+
+                for (int b = 0; b < batch_size; b++) {
+                    float *gate_in = input_cache_items + get_x_index(seq, b, seq_length, batch_size) * gate_size;
+                    float *hidden_in = hidden_cache_items + b * gate_size;
+                    float *h_prev = h_prev_items + b * m_hidden_size;
+                    float *c_prev = c_prev_items + b * m_hidden_size;
+                    float *y = y_items + get_y_index(seq, di, b, seq_length, batch_size) * m_hidden_size;
+
+                    if (input_b) {
+                        for (int i = 0; i < gate_size; i++) {
+                            gate_in[i] += wb_items[i] + hidden_in[i] + rb_items[i];
+                        }
+                    } else {
+                        for (int i = 0; i < gate_size; i++) {
+                            gate_in[i] += hidden_in[i];
+                        }
+                    }
 
-                for (int i = 0; i < m_hidden_size; i++) {
-                    c_prev_items[i] = f_gate[i] * c_prev_items[i] + i_gate[i] * g_gate[i];
-                    h_prev_items[i] = o_gate[i] * math::tanh(c_prev_items[i]);
-                    y_items[i] = h_prev_items[i];
-                }
+                    // Compute gates: input, output, forget, and cell
+                    float *i_gate = gate_in;
+                    float *o_gate = gate_in + m_hidden_size;
+                    float *f_gate = gate_in + 2 * m_hidden_size;
+                    float *g_gate = gate_in + 3 * m_hidden_size;
+                    for (int i = 0; i < m_hidden_size; i++) {
+                        i_gate[i] = math::sigmoid(i_gate[i]);
+                        f_gate[i] = math::sigmoid(f_gate[i]);
+                        g_gate[i] = math::tanh(g_gate[i]);
+                        o_gate[i] = math::sigmoid(o_gate[i]);
+                    }
 
-                // Get input and output pointer for next time step
-                if (di == 0) {
-                    x_items += input_size;
-                    y_items += m_hidden_size * m_direction_num;
-                } else {
-                    x_items -= input_size;
-                    y_items -= m_hidden_size * m_direction_num;
+                    for (int i = 0; i < m_hidden_size; i++) {
+                        c_prev[i] = f_gate[i] * c_prev[i] + i_gate[i] * g_gate[i];
+                        h_prev[i] = o_gate[i] * math::tanh(c_prev[i]);
+                        y[i] = h_prev[i];
+                    }
                 }
             }
-            memcpy(h_items, h_prev_items, m_hidden_size * sizeof(float));
-            memcpy(c_items, c_prev_items, m_hidden_size * sizeof(float));
-            h_items += m_hidden_size;
-            c_items += m_hidden_size;
+            for (int b = 0; b < batch_size; b++) {
+                int offset = get_state_index(di, b, batch_size) * m_hidden_size;
+                memcpy(h_items + offset, h_prev_items + b * m_hidden_size, m_hidden_size * sizeof(float));
+                memcpy(c_items + offset, c_prev_items + b * m_hidden_size, m_hidden_size * sizeof(float));
+            }
         }
     }
 
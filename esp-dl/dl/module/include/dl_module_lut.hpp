@@ -2,6 +2,8 @@
 
 #include "dl_module_base.hpp"
 
+#define DL_LUT_SYNTHESIZED_INT16_STEP 16 /*!< Input step between two entries of synthesized int16 table */
+
 namespace dl {
 namespace module {
 /**
@@ -38,7 +40,40 @@ public:
     /**
      * @brief Destroy the LUT object.
      */
-    ~LUT() { delete table; }
+    ~LUT()
+    {
+        if (!release_synthesized_table(table)) {
+            delete table;
+        }
+    }
+
+    /**
+     * @brief Synthesize the table of a quantized unary function from the input and output exponents. The table gives
+     * the same result as running the float function on every quantized input.
+     * - int8: 256 entries.
+     * - int16: 65536 / DL_LUT_SYNTHESIZED_INT16_STEP + 1 entries, linear interpolation between entries.
+     * Tables are shared by the LUT modules with the same key and exponents, and freed with the last one of them.
+     *
+     * @param key              Name of function with its attributes
+     * @param func             The float function
+     * @param input_exponent   Exponent of input
+     * @param output_exponent  Exponent of output
+     * @param quant_type       QUANT_TYPE_SYMM_8BIT or QUANT_TYPE_SYMM_16BIT
+     * @return The table, nullptr if quant_type is not supported.
+     */
+    static TensorBase *get_synthesized_table(const std::string &key,
+                                             const ActivationFunction &func,
+                                             int input_exponent,
+                                             int output_exponent,
+                                             quant_type_t quant_type);
+
+    /**
+     * @brief Release a table got from get_synthesized_table().
+     *
+     * @param table The table
+     * @return False if the table is not a synthesized table.
+     */
+    static bool release_synthesized_table(TensorBase *table);
 
     std::vector<std::vector<int>> get_output_shape(std::vector<std::vector<int>> &input_shapes)
     {
@@ -56,30 +91,35 @@ public:
             int8_t *input_ptr = (int8_t *)input->get_element_ptr();
             int8_t *output_ptr = (int8_t *)output->get_element_ptr();
             int8_t *table_ptr = (int8_t *)(this->table->get_element_ptr());
-            for (size_t i = 0; i < input->size; i++) {
-                output_ptr[i] = table_ptr[input_ptr[i] + 128];
-            }
+            module_parallel_for(input->size, mode, [&](int start, int end) {
+                for (int i = start; i < end; i++) {
+                    output_ptr[i] = table_ptr[input_ptr[i] + 128];
+                }
+            });
         } else if (quant_type == QUANT_TYPE_SYMM_16BIT) {
             int16_t *input_ptr = (int16_t *)input->get_element_ptr();
             int16_t *output_ptr = (int16_t *)output->get_element_ptr();
             int16_t *table_ptr = (int16_t *)(this->table->get_element_ptr());
 
-            if (this->step == 1) {
-                for (size_t i = 0; i < input->size; i++) {
-                    output_ptr[i] = table_ptr[input_ptr[i] + 32768];
-                }
-            } else {
-                for (size_t i = 0; i < input->size; i++) {
-                    int idx = input_ptr[i] + 32768;
-                    int len = idx % this->step;
-                    idx = idx / this->step;
-
-                    // linear interpolation
-                    int x = table_ptr[idx];
-                    int y = table_ptr[idx + 1];
-                    output_ptr[i] = x + len * (y - x) / this->step;
+            int step = this->step;
+            module_parallel_for(input->size, mode, [&](int start, int end) {
+                if (step == 1) {
+                    for (int i = start; i < end; i++) {
+                        output_ptr[i] = table_ptr[input_ptr[i] + 32768];
+                    }
+                } else {
+                    for (int i = start; i < end; i++) {
+                        int idx = input_ptr[i] + 32768;
+                        int len = idx % step;
+                        idx = idx / step;
+
+                        // linear interpolation
+                        int x = table_ptr[idx];
+                        int y = table_ptr[idx + 1];
+                        output_ptr[i] = x + len * (y - x) / step;
+                    }
                 }
-            }
+            });
         }
     }
 
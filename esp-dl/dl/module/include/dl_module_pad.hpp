@@ -1,6 +1,7 @@
 #pragma once
 #include "dl_base_pad.hpp"
 #include "dl_module_base.hpp"
+#include <algorithm>
 
 namespace dl {
 namespace module {
@@ -46,7 +47,95 @@ public:
         TensorBase *input = context->get_tensor(m_inputs_index[0]);
         TensorBase *output = context->get_tensor(m_outputs_index[0]);
 
-        output->pad(input, m_pads, m_mode, m_constant_value);
+        int dims = input->shape.size();
+        bool by_rows = dims > 0 && m_pads.size() == 2 * dims &&
+            std::all_of(m_pads.begin(), m_pads.end(), [](int pad) { return pad >= 0; });
+        // only moves elements, so the dtypes with the same size share one implementation
+        switch (by_rows ? input->get_dtype_bytes() : 0) {
+        case 1:
+            forward_template<int8_t>(input, output, mode);
+            break;
+        case 2:
+            forward_template<int16_t>(input, output, mode);
+            break;
+        case 4:
+            forward_template<int32_t>(input, output, mode);
+            break;
+        case 8:
+            forward_template<int64_t>(input, output, mode);
+            break;
+        default:
+            output->pad(input, m_pads, m_mode, m_constant_value);
+            break;
+        }
+    }
+
+    /**
+     * @brief Pad every output row of the last axis on its own, so the rows can be split to both cores.
+     */
+    template <typename T>
+    void forward_template(TensorBase *input, TensorBase *output, runtime_mode_t mode)
+    {
+        int dims = input->shape.size();
+        std::vector<int> &input_shape = input->shape;
+        std::vector<int> output_shape = base::get_pad_shape(input_shape, m_pads);
+        T *input_ptr = (T *)input->get_element_ptr();
+        T *output_ptr = (T *)output->get_element_ptr();
+        T const_value = m_constant_value ? m_constant_value->get_element<T>(0) : 0;
+        int cols = input_shape[dims - 1];
+        int head = m_pads[dims - 1];
+        int tail = m_pads[2 * dims - 1];
+        int output_cols = output_shape[dims - 1];
+        int rows = output->get_size() / output_cols;
+
+        module_parallel_for(
+            rows,
+            mode,
+            [&](int start, int end) {
+                for (int row = start; row < end; row++) {
+                    T *output_row = output_ptr + (size_t)row * output_cols;
+                    // the input row of this output row, nullptr if it's in the constant padding
+                    T *input_row = input_ptr;
+                    for (int i = dims - 2, n = row, stride = cols; i >= 0; i--) {
+                        int index = n % output_shape[i] - m_pads[i];
+                        n /= output_shape[i];
+                        if (index < 0 || index >= input_shape[i]) {
+                            if (m_mode == PADDING_CONSTANT) {
+                                input_row = nullptr;
+                                break;
+                            } else if (m_mode == PADDING_EDGE) {
+                                index = DL_CLIP(index, 0, input_shape[i] - 1);
+                            } else {
+                                index = index < 0 ? -index : 2 * (input_shape[i] - 1) - index;
+                                index = DL_CLIP(index, 0, input_shape[i] - 1);
+                            }
+                        }
+                        input_row += (size_t)index * stride;
+                        stride *= input_shape[i];
+                    }
+
+                    if (!input_row) {
+                        std::fill(output_row, output_row + output_cols, const_value);
+                        continue;
+                    }
+                    tool::copy_memory(output_row + head, input_row, cols * sizeof(T));
+                    if (m_mode == PADDING_CONSTANT) {
+                        std::fill(output_row, output_row + head, const_value);
+                        std::fill(output_row + head + cols, output_row + output_cols, const_value);
+                    } else if (m_mode == PADDING_EDGE) {
+                        std::fill(output_row, output_row + head, input_row[0]);
+                        std::fill(output_row + head + cols, output_row + output_cols, input_row[cols - 1]);
+                    } else {
+                        for (int j = 0; j < head; j++) {
+                            output_row[j] = input_row[DL_MIN(head - j, cols - 1)];
+                        }
+                        for (int j = 0; j < tail; j++) {
+                            output_row[head + cols + j] = input_row[DL_MAX(cols - 2 - j, 0)];
+                        }
+                    }
+                }
+            },
+            output_cols);
     }
 
     void forward_args(void *args) {}
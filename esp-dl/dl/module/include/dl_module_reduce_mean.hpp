@@ -34,26 +34,28 @@ public:
             size_t count = size0 * size1;
             return sum / static_cast<float>(count);
         } else {
-            // For quantized types, perform scaling and truncation
-            T ret = 0;
+            // For quantized types, rescale the integer sum by the fixed-point scale of forward()
             V_T tmp = ReduceBase::reduce<reduce_op_add<V_T, T>>(v0, ptr, size0, stride0, size1, stride1, arg);
-            size_t count = size0 * size1;
-            float input_scale = DL_SCALE(input_exponent);
-            float output_scale = DL_RESCALE(output_exponent);
-            tool::truncate(ret, tool::round(tmp * input_scale / count * output_scale));
-
-            return ret;
+            return tool::requantize<T>(tmp, *(tool::requant_t *)arg);
         }
     }
 
     void forward(ModelContext *context, runtime_mode_t mode)
     {
-        if (quant_type == QUANT_TYPE_SYMM_8BIT) {
-            int32_t v0 = 0;
-            forward_template<int32_t, int8_t>(context, mode, v0, reduce<int32_t, int8_t>, nullptr);
-        } else if (quant_type == QUANT_TYPE_SYMM_16BIT) {
-            int64_t v0 = 0;
-            forward_template<int64_t, int16_t>(context, mode, v0, reduce<int64_t, int16_t>, nullptr);
+        if (quant_type == QUANT_TYPE_SYMM_8BIT || quant_type == QUANT_TYPE_SYMM_16BIT) {
+            // scale of the sum, the same for all outputs
+            TensorBase *input = context->get_tensor(m_inputs_index[0]);
+            TensorBase *output = context->get_tensor(m_outputs_index[0]);
+            int count = input->get_size() / output->get_size();
+            tool::requant_t requant =
+                tool::get_requant(DL_SCALE(input->exponent) / count * DL_RESCALE(output->exponent));
+            if (quant_type == QUANT_TYPE_SYMM_8BIT) {
+                int32_t v0 = 0;
+                forward_template<int32_t, int8_t>(context, mode, v0, reduce<int32_t, int8_t>, &requant);
+            } else {
+                int64_t v0 = 0;
+                forward_template<int64_t, int16_t>(context, mode, v0, reduce<int64_t, int16_t>, &requant);
+            }
         } else if (quant_type == QUANT_TYPE_FLOAT32) {
             float v0 = 0.0f;
             forward_template<float, float>(context, mode, v0, reduce<float, float>, nullptr);
@@ -78,12 +78,10 @@ public:
                 }
             }
         } else {
-            float input_scale = DL_SCALE(input->exponent);
-            float output_scale = DL_RESCALE(output->exponent);
+            tool::requant_t requant = tool::get_requant(DL_SCALE(input->exponent) * DL_RESCALE(output->exponent));
             for (size_t i = 0; i < input->size; i++) {
-                float temp = input_ptr[i] * input_scale;
-                if (temp >= 0) {
-                    tool::truncate(output_ptr[i], tool::round(temp * output_scale));
+                if (input_ptr[i] >= 0) {
+                    output_ptr[i] = tool::requantize<T>(input_ptr[i], requant);
                 } else {
                     output_ptr[i] = 0;
                 }
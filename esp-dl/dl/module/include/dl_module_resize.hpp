@@ -16,7 +16,8 @@ private:
     std::vector<float> m_scales;       /*!< The scale array along each dimension. */
     std::vector<int64_t> m_sizes;      /*!< Target size of the output tensor. */
     bool m_align_corners;              /*!< Whether coordinate_transformation_mode is align_corners */
-    float *m_cache = nullptr; /*!< Temporary memory, used to cache the intermediate results of linear operations. */
+    void *m_cache = nullptr; /*!< Coordinates, weights and intermediate rows of base::resize_cache_init(). */
+    std::vector<int> m_cache_shape; /*!< Input and output shape of m_cache */
 public:
     /**
      * @brief Construct a new Resize object.
@@ -103,12 +104,21 @@ public:
     {
         TensorBase *input = context->get_tensor(m_inputs_index[0]);
         TensorBase *output = context->get_tensor(m_outputs_index[0]);
-        int dims = input->get_shape().size();
 
-        if ((dims == 3 && m_scales[2] == 1) || (dims == 4 && m_scales[2] == 1 && m_scales[3] == 1)) {
+        if (input->shape == output->shape) {
+            // identity scale of any mode, only requantize if the exponents are different
             output->assign(input);
+            return;
         }
 
+        std::vector<int> cache_shape = input->shape;
+        cache_shape.insert(cache_shape.end(), output->shape.begin(), output->shape.end());
+        if (m_cache && cache_shape != m_cache_shape) {
+            free(m_cache);
+            m_cache = nullptr;
+        }
+        m_cache_shape.swap(cache_shape);
+
         std::vector<base::resizeArgsType<T>> m_args =
             base::get_resize_operation_args<T>(output, input, m_resize_mode, m_scales, m_align_corners, m_cache);
         int task_size = m_args.size();
@@ -50,32 +50,47 @@ public:
 
             float input_scale = DL_SCALE(input->exponent);
             float output_scale = DL_RESCALE(output->exponent);
-            for (size_t i = 0; i < input->size; i++) {
-                float temp = math::sigmoid((float)input_ptr[i] * input_scale);
-                tool::truncate(output_ptr[i], tool::round(temp * output_scale));
-            }
+            module_parallel_for(input->size, mode, [&](int start, int end) {
+                for (int i = start; i < end; i++) {
+                    float temp = math::sigmoid((float)input_ptr[i] * input_scale);
+                    tool::truncate(output_ptr[i], tool::round(temp * output_scale));
+                }
+            });
         } else if (quant_type == QUANT_TYPE_SYMM_16BIT) {
             int16_t *input_ptr = (int16_t *)input->get_element_ptr();
             int16_t *output_ptr = (int16_t *)output->get_element_ptr();
 
             float input_scale = DL_SCALE(input->exponent);
             float output_scale = DL_RESCALE(output->exponent);
-            for (size_t i = 0; i < input->size; i++) {
-                float temp = math::sigmoid((float)input_ptr[i] * input_scale);
-                tool::truncate(output_ptr[i], tool::round(temp * output_scale));
-            }
+            module_parallel_for(input->size, mode, [&](int start, int end) {
+                for (int i = start; i < end; i++) {
+                    float temp = math::sigmoid((float)input_ptr[i] * input_scale);
+                    tool::truncate(output_ptr[i], tool::round(temp * output_scale));
+                }
+            });
         } else if (quant_type == QUANT_TYPE_FLOAT32) {
             float *input_ptr = (float *)input->get_element_ptr();
             float *output_ptr = (float *)output->get_element_ptr();
 
-            for (size_t i = 0; i < input->size; i++) {
-                output_ptr[i] = math::sigmoid(input_ptr[i]);
-            }
+            module_parallel_for(input->size, mode, [&](int start, int end) {
+                for (int i = start; i < end; i++) {
+                    output_ptr[i] = math::sigmoid(input_ptr[i]);
+                }
+            });
         }
     }
 
     void forward_args(void *args) {}
 
+    ActivationFunction get_lut_function(std::string &key)
+    {
+        if (quant_type == QUANT_TYPE_SYMM_8BIT || quant_type == QUANT_TYPE_SYMM_16BIT) {
+            key = "Sigmoid";
+            return [](float x) { return math::sigmoid(x); };
+        }
+        return nullptr;
+    }
+
     /**
      * @brief deserialize Sigmoid module instance by node serialization information
      */
@@ -56,154 +56,115 @@ public:
         TensorBase *output = context->get_tensor(m_outputs_index[0]);
 
         if (quant_type == QUANT_TYPE_SYMM_8BIT) {
-            forward_lut(input, output);
+            forward_lut(input, output, mode);
         } else if (quant_type == QUANT_TYPE_SYMM_16BIT) {
-            int16_t *input_element = (int16_t *)input->get_element_ptr();
-            float *output_element = (float *)output->get_element_ptr();
-
-            float scale = DL_SCALE(input->exponent);
-            for (int i = 0; i < input->get_size(); i++) {
-                output_element[i] = scale * input_element[i];
-            }
-            forward_float(output_element, output->get_size(), output->get_shape(), this->axis);
+            // dequantized by math::softmax() while reading, no float copy of input
+            forward_template((int16_t *)input->get_element_ptr(),
+                             (float *)output->get_element_ptr(),
+                             output->get_shape(),
+                             this->axis,
+                             DL_SCALE(input->exponent),
+                             mode);
         } else if (quant_type == QUANT_TYPE_FLOAT32) {
             float *input_element = (float *)input->get_element_ptr();
             float *output_element = (float *)output->get_element_ptr();
-
-            if (input_element != output_element) {
-                memcpy(output_element, input_element, input->get_bytes());
-            }
-            forward_float(output_element, output->get_size(), output->get_shape(), this->axis);
+            forward_template(input_element, output_element, output->get_shape(), this->axis, 1.f, mode);
         }
     }
 
-    void forward_float(float *output_element, int size, std::vector<int> shape, int axis)
+    void forward_float(float *output_element,
+                       int size,
+                       std::vector<int> shape,
+                       int axis,
+                       runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE)
     {
+        forward_template(output_element, output_element, shape, axis, 1.f, mode);
+    }
+
+    template <typename T>
+    void forward_template(const T *input_element,
+                          float *output_element,
+                          std::vector<int> shape,
+                          int axis,
+                          float scale,
+                          runtime_mode_t mode)
+    {
+        // convert input tensor to [outer_loop, len, inner_loop], every DL_SOFTMAX_TILE softmaxes of inner_loop are
+        // computed together
         int dims = shape.size();
         int positive_axis = axis < 0 ? dims + axis : axis;
         int len = shape[positive_axis]; // the size of positive_axis
-
-        if (positive_axis == dims - 1) { // positive_axis == dims - 1
-            int outer_loop = 1;
-            if (dims > 1) {
-                outer_loop = size / len;
-            }
-
-            for (int o = 0; o < outer_loop; o++) {
-                float max = output_element[0];
-                for (int i = 1; i < len; i++) {
-                    max = DL_MAX(max, output_element[i]);
-                }
-
-                float sum = 0.f;
-                for (int i = 0; i < len; i++) {
-                    output_element[i] = expf(output_element[i] - max);
-                    sum += output_element[i];
-                }
-
-                for (int i = 0; i < len; i++) {
-                    output_element[i] = output_element[i] / sum;
-                }
-                output_element += len;
-            }
-        } else {
-            // convert input tensor to [outer_loop, len, inner_loop]
-            int outer_loop = 1;
-            int inner_loop = 1;
-            for (int i = 0; i < dims; i++) {
-                if (i < positive_axis) {
-                    outer_loop *= shape[i];
-                } else if (i > positive_axis) {
-                    inner_loop *= shape[i];
-                }
-            }
-
-            for (int o = 0; o < outer_loop; o++) {
-                for (int k = 0; k < inner_loop; k++) {
-                    float max = output_element[0];
-                    for (int i = 1; i < len; i++) {
-                        max = DL_MAX(max, output_element[i * inner_loop]);
-                    }
-
-                    float sum = 0.f;
-                    for (int i = 0; i < len; i++) {
-                        output_element[i * inner_loop] = expf(output_element[i * inner_loop] - max);
-                        sum += output_element[i * inner_loop];
-                    }
-
-                    for (int i = 0; i < len; i++) {
-                        output_element[i * inner_loop] = output_element[i * inner_loop] / sum;
-                    }
-                    output_element += 1;
-                }
-                output_element += inner_loop * (len - 1);
+        int outer_loop = 1;
+        int inner_loop = 1;
+        for (int i = 0; i < dims; i++) {
+            if (i < positive_axis) {
+                outer_loop *= shape[i];
+            } else if (i > positive_axis) {
+                inner_loop *= shape[i];
             }
         }
+        int tiles = (inner_loop + DL_SOFTMAX_TILE - 1) / DL_SOFTMAX_TILE;
+
+        module_parallel_for(
+            outer_loop * tiles,
+            mode,
+            [&](int start, int end) {
+                for (int n = start; n < end; n++) {
+                    int k = (n % tiles) * DL_SOFTMAX_TILE;
+                    int offset = (n / tiles) * len * inner_loop + k;
+                    math::softmax(input_element + offset,
+                                  output_element + offset,
+                                  len,
+                                  inner_loop,
+                                  DL_MIN(DL_SOFTMAX_TILE, inner_loop - k),
+                                  scale);
+                }
+            },
+            len * DL_MIN(DL_SOFTMAX_TILE, inner_loop));
     }
 
-    void forward_lut(TensorBase *input, TensorBase *output)
+    void forward_lut(TensorBase *input, TensorBase *output, runtime_mode_t mode = RUNTIME_MODE_SINGLE_CORE)
     {
         if (this->exp_table == nullptr) {
             this->exp_table = (float *)heap_caps_malloc(256 * sizeof(float), MALLOC_CAP_DEFAULT);
             tool::gen_lut_8bit(this->exp_table, input->exponent, expf);
         }
 
+        // convert input tensor to [outer_loop, len, inner_loop], every (outer, inner) is one softmax
         int dims = input->get_shape().size();
         int positive_axis = axis < 0 ? dims + axis : axis;
         int len = input->get_shape()[positive_axis]; // the size of positive_axis
+        int inner_loop = 1;
+        for (int i = positive_axis + 1; i < dims; i++) {
+            inner_loop *= input->get_shape()[i];
+        }
+        int outer_loop = input->get_size() / (len * inner_loop);
         int8_t *input_element = (int8_t *)input->get_element_ptr();
         assert(output->get_dtype() == DATA_TYPE_FLOAT);
         float *output_element = (float *)output->get_element_ptr();
-
-        if (positive_axis == dims - 1) { // positive_axis == dims - 1
-            int outer_loop = 1;
-            if (dims > 1) {
-                outer_loop = input->get_size() / len;
-            }
-
-            for (int o = 0; o < outer_loop; o++) {
-                float sum = 0.f;
-                for (int i = 0; i < len; i++) {
-                    output_element[i] = this->exp_table[input_element[i] + 128];
-                    sum += output_element[i];
-                }
-
-                for (int i = 0; i < len; i++) {
-                    output_element[i] = output_element[i] / sum;
-                }
-                input_element += len;
-                output_element += len;
-            }
-        } else {
-            // convert input tensor to [outer_loop, len, inner_loop]
-            int outer_loop = 1;
-            int inner_loop = 1;
-            for (int i = 0; i < dims; i++) {
-                if (i < positive_axis) {
-                    outer_loop *= input->get_shape()[i];
-                } else if (i > positive_axis) {
-                    inner_loop *= input->get_shape()[i];
-                }
-            }
-
-            for (int o = 0; o < outer_loop; o++) {
-                for (int k = 0; k < inner_loop; k++) {
+        float *exp_table = this->exp_table;
+
+        module_parallel_for(
+            outer_loop * inner_loop,
+            mode,
+            [&](int start, int end) {
+                for (int n = start; n < end; n++) {
+                    int offset = (n / inner_loop) * len * inner_loop + n % inner_loop;
+                    int8_t *input_ptr = input_element + offset;
+                    float *output_ptr = output_element + offset;
                     float sum = 0.f;
                     for (int i = 0; i < len; i++) {
-                        output_element[i * inner_loop] = this->exp_table[input_element[i * inner_loop] + 128];
-                        sum += output_element[i * inner_loop];
+                        output_ptr[i * inner_loop] = exp_table[input_ptr[i * inner_loop] + 128];
+                        sum += output_ptr[i * inner_loop];
                     }
 
+                    float inv_sum = 1.f / sum;
                     for (int i = 0; i < len; i++) {
-                        output_element[i * inner_loop] = output_element[i * inner_loop] / sum;
+                        output_ptr[i * inner_loop] *= inv_sum;
                     }
-                    input_element += 1;
-                    output_element += 1;
                 }
-                input_element += inner_loop * (len - 1);
-                output_element += inner_loop * (len - 1);
-            }
-        }
+            },
+            len);
     }
 
     /**
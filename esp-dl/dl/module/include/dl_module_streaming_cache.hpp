@@ -5,17 +5,49 @@
 namespace dl {
 namespace module {
 /**
- * @brief: Performs StreamingCachetraction operation.
- * memcpy(output, cache, cache_size)
- * memcpy(output+cache_size, input, input_size)
- * memcpy(cache, output+input_size, cache_size)
+ * @brief: Performs StreamingCache operation. output = concat(cache, input) along frame_axis, cache keeps the last
+ * window_size - 1 frames of output.
+ *
+ * The cache and the new frames are kept in a ring buffer of 2 windows. Every forward only appends the input to the ring
+ * and the window is always contiguous in the ring. When the ring is full, the cache is moved to the head of the ring
+ * once, which is amortized over about (window_size - 1) / input_frames + 1 forwards.
+ * - ring view mode: output is a view of the window in the ring, no copy of the window. Used when frames are
+ *   contiguous(all dims before frame_axis are 1) and a frame is 16 bytes aligned, so the view is aligned as the
+ *   kernels of downstream modules expect. The output must not own its memory, e.g. it's planned by the memory manager
+ *   of Model, otherwise its memory would be leaked.
+ * - copy mode: the window is copied from the ring to output with a single memcpy.
  */
 class StreamingCache : public Module {
 private:
     int m_window_size;
     int m_frame_axis;
     int m_cache_bytes;
-    TensorBase *m_cache;
+    TensorBase *m_cache; /*!< Ring buffer of cache and input frames */
+    int m_ring_bytes;    /*!< In bytes, size of ring buffer */
+    int m_ring_offset;   /*!< In bytes, offset of current window in ring buffer */
+    bool m_ring_view;    /*!< True: output is a view of ring buffer. False: copy window to output */
+
+    void init_ring(TensorBase *input, TensorBase *output)
+    {
+        std::vector<int> output_shape = output->get_shape();
+        if (m_frame_axis < 0) {
+            m_frame_axis = output_shape.size() + m_frame_axis;
+        }
+        int outer = 1;
+        for (int i = 0; i < m_frame_axis; i++) {
+            outer *= output_shape[i];
+        }
+        int frame_bytes = output->get_bytes() / output_shape[m_frame_axis];
+        m_ring_view = outer == 1 && frame_bytes % 16 == 0;
+
+        std::vector<int> ring_shape = output_shape;
+        ring_shape[m_frame_axis] = output_shape[m_frame_axis] * 2;
+        m_cache = new TensorBase(ring_shape, nullptr, input->get_exponent(), input->get_dtype());
+        m_ring_bytes = m_cache->get_bytes();
+        m_cache_bytes = output->get_bytes() - input->get_bytes();
+        m_ring_offset = 0;
+        memset(m_cache->get_element_ptr(), 0, m_ring_bytes);
+    }
 
 public:
     /**
@@ -33,6 +65,10 @@ public:
         Module(name, inplace, quant_type), m_window_size(window_size), m_frame_axis(frame_axis)
     {
         m_cache = nullptr;
+        m_cache_bytes = 0;
+        m_ring_bytes = 0;
+        m_ring_offset = 0;
+        m_ring_view = false;
     }
 
     /**
@@ -66,22 +102,32 @@ public:
         TensorBase *output = context->get_tensor(m_outputs_index[0]);
         int input_bytes = input->get_bytes();
 
+        if (m_cache && m_cache_bytes != output->get_bytes() - input_bytes) {
+            // the input shape is changed, the cached frames are stale
+            delete m_cache;
+            m_cache = nullptr;
+        }
         if (m_cache == nullptr) {
-            std::vector<int> cache_shape = output->get_shape();
-            cache_shape[m_frame_axis] = m_window_size - 1;
-            m_cache = new TensorBase(cache_shape, nullptr, input->get_exponent(), input->get_dtype());
-            m_cache_bytes = m_cache->get_bytes();
-            memset(m_cache->get_element_ptr(), 0, m_cache_bytes);
+            init_ring(input, output);
         }
 
-        // Copy cache to output
-        tool::copy_memory(output->get_element_ptr(), m_cache->get_element_ptr(), m_cache_bytes);
+        // Keep the window contiguous. The ring holds 2 windows, so the source and destination never overlap.
+        uint8_t *ring = m_cache->get_element_ptr<uint8_t>();
+        if (m_ring_offset + m_cache_bytes + input_bytes > m_ring_bytes) {
+            tool::copy_memory(ring, ring + m_ring_offset, m_cache_bytes);
+            m_ring_offset = 0;
+        }
 
-        // Copy input to output
-        tool::copy_memory(output->get_element_ptr<uint8_t>() + m_cache_bytes, input->get_element_ptr(), input_bytes);
+        // Append input after cache
+        uint8_t *window = ring + m_ring_offset;
+        tool::copy_memory(window + m_cache_bytes, input->get_element_ptr(), input_bytes);
+        m_ring_offset += input_bytes;
 
-        // Update cache
-        tool::copy_memory(m_cache->get_element_ptr(), output->get_element_ptr<uint8_t>() + input_bytes, m_cache_bytes);
+        if (m_ring_view && !output->auto_free) {
+            output->set_element_ptr(window);
+        } else {
+            tool::copy_memory(output->get_element_ptr(), window, m_cache_bytes + input_bytes);
+        }
     }
 
     /**
@@ -78,6 +78,15 @@ public:
 
     void forward_args(void *args) {}
 
+    ActivationFunction get_lut_function(std::string &key)
+    {
+        if (quant_type == QUANT_TYPE_SYMM_8BIT || quant_type == QUANT_TYPE_SYMM_16BIT) {
+            key = "Swish";
+            return [](float x) { return dl::math::sigmoid(x) * x; };
+        }
+        return nullptr;
+    }
+
     /**
      * @brief deserialize Swish module instance by node serialization information
      */
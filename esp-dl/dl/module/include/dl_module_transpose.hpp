@@ -55,7 +55,92 @@ public:
     {
         TensorBase *input = context->get_tensor(m_inputs_index[0]);
         TensorBase *output = context->get_tensor(m_outputs_index[0]);
-        output->transpose(input, m_perm);
+
+        // only moves elements, so the dtypes with the same size share one implementation
+        switch (input->get_dtype_bytes()) {
+        case 1:
+            forward_template<int8_t>(input, output, mode);
+            break;
+        case 2:
+            forward_template<int16_t>(input, output, mode);
+            break;
+        case 4:
+            forward_template<int32_t>(input, output, mode);
+            break;
+        case 8:
+            forward_template<int64_t>(input, output, mode);
+            break;
+        default:
+            output->transpose(input, m_perm);
+            break;
+        }
+    }
+
+    template <typename T>
+    void forward_template(TensorBase *input, TensorBase *output, runtime_mode_t mode)
+    {
+        int dims = input->shape.size();
+        T *input_ptr = (T *)input->get_element_ptr();
+        T *output_ptr = (T *)output->get_element_ptr();
+        if (dims == 0) {
+            output_ptr[0] = input_ptr[0];
+            return;
+        }
+
+        // output axis i walks along input axis perm[i]
+        std::vector<int> perm = m_perm;
+        if (perm.empty()) {
+            for (int i = dims - 1; i >= 0; i--) {
+                perm.push_back(i);
+            }
+        }
+        std::vector<int> output_shape(dims);
+        std::vector<int> input_stride(dims);
+        for (int i = 0; i < dims; i++) {
+            int axis = perm[i] < 0 ? perm[i] + dims : perm[i];
+            output_shape[i] = input->shape[axis];
+            input_stride[i] = input->axis_offset[axis];
+        }
+        int cols = output_shape[dims - 1];
+        int col_stride = input_stride[dims - 1];
+
+        // every output row of the last axis is one iteration
+        module_parallel_for(
+            input->get_size() / cols,
+            mode,
+            [&](int start, int end) {
+                std::vector<int> index(dims, 0);
+                int offset = 0;
+                for (int i = dims - 2, n = start; i >= 0; i--) {
+                    index[i] = n % output_shape[i];
+                    n /= output_shape[i];
+                    offset += index[i] * input_stride[i];
+                }
+
+                T *output_row = output_ptr + (size_t)start * cols;
+                for (int row = start; row < end; row++) {
+                    T *input_row = input_ptr + offset;
+                    if (col_stride == 1) {
+                        tool::copy_memory(output_row, input_row, cols * sizeof(T));
+                    } else {
+                        for (int j = 0; j < cols; j++) {
+                            output_row[j] = input_row[j * col_stride];
+                        }
+                    }
+                    output_row += cols;
+
+                    // move to the next row
+                    for (int i = dims - 2; i >= 0; i--) {
+                        offset += input_stride[i];
+                        if (++index[i] < output_shape[i]) {
+                            break;
+                        }
+                        offset -= index[i] * input_stride[i];
+                        index[i] = 0;
+                    }
+                }
+            },
+            cols);
     }
 
     void forward_args(void *args) {}
@@ -1,12 +1,14 @@
 #include "dl_module_base.hpp"
 #include <string.h>
 
+static const char *TAG = "dl::Module";
+
 using namespace dl;
 
 namespace dl {
 namespace module {
 Module::Module(const char *name, module_inplace_t inplace, quant_type_t quant_type) :
-    inplace(inplace), quant_type(quant_type)
+    inplace(inplace), quant_type(quant_type), m_eager_context(nullptr)
 {
 #if DL_LOG_MODULE_NAME
     if (name) {
@@ -26,28 +28,121 @@ Module::~Module()
     if (this->name) {
         free((void *)this->name);
     }
+    delete m_eager_context;
 }
 
-void Module::run(TensorBase *input, TensorBase *output, runtime_mode_t mode)
+void Module::init_eager_context(int num_inputs, int num_outputs)
 {
-    ModelContext context;
-    m_inputs_index.push_back(context.push_back_tensor(input));
-    m_outputs_index.push_back(context.push_back_tensor(output));
-    forward(&context, mode);
+    if (!m_eager_context) {
+        m_eager_context = new ModelContext();
+    } else if (m_inputs_index.size() == num_inputs && m_outputs_index.size() == num_outputs &&
+               m_eager_context->get_variable_count() == num_inputs + num_outputs) {
+        return;
+    }
+
+    m_eager_context->clear();
+    m_inputs_index.clear();
+    m_outputs_index.clear();
+    for (int i = 0; i < num_inputs; i++) {
+        m_inputs_index.push_back(m_eager_context->push_back_tensor(nullptr));
+    }
+    for (int i = 0; i < num_outputs; i++) {
+        m_outputs_index.push_back(m_eager_context->push_back_tensor(nullptr));
+    }
 }
 
-void Module::run(std::vector<dl::TensorBase *> inputs, std::vector<dl::TensorBase *> outputs, runtime_mode_t mode)
+void Module::bind(const std::vector<dl::TensorBase *> &inputs, const std::vector<dl::TensorBase *> &outputs)
 {
-    ModelContext context;
+    init_eager_context(inputs.size(), outputs.size());
     for (int i = 0; i < inputs.size(); i++) {
-        m_inputs_index.push_back(context.push_back_tensor(inputs[i]));
+        m_eager_context->update_tensor(m_inputs_index[i], inputs[i]);
     }
-
     for (int i = 0; i < outputs.size(); i++) {
-        m_outputs_index.push_back(context.push_back_tensor(outputs[i]));
+        m_eager_context->update_tensor(m_outputs_index[i], outputs[i]);
     }
+}
 
-    forward(&context, mode);
+void Module::run(runtime_mode_t mode)
+{
+    if (!m_eager_context) {
+        ESP_LOGE(TAG, "Module is not bound to any tensor, call bind() first.");
+        return;
+    }
+    forward(m_eager_context, mode);
+}
+
+void Module::run(TensorBase *input, TensorBase *output, runtime_mode_t mode)
+{
+    init_eager_context(1, 1);
+    m_eager_context->update_tensor(m_inputs_index[0], input);
+    m_eager_context->update_tensor(m_outputs_index[0], output);
+    forward(m_eager_context, mode);
+}
+
+void Module::run(const std::vector<dl::TensorBase *> &inputs,
+                 const std::vector<dl::TensorBase *> &outputs,
+                 runtime_mode_t mode)
+{
+    bind(inputs, outputs);
+    forward(m_eager_context, mode);
+}
+
+namespace {
+typedef struct {
+    const std::function<void(int, int)> *func; ///< The loop body
+    int start;                                 ///< Start of range
+    int end;                                   ///< End of range
+    SemaphoreHandle_t semaphore;               ///< Given when the range is done
+} parallel_for_task_data_t;
+
+void parallel_for_task(void *args)
+{
+    parallel_for_task_data_t *task = (parallel_for_task_data_t *)args;
+    (*task->func)(task->start, task->end);
+    xSemaphoreGive(task->semaphore);
+    vTaskSuspend(NULL);
+}
+} // namespace
+
+void module_parallel_for(int size, runtime_mode_t mode, const std::function<void(int, int)> &func, int grain)
+{
+    if (size <= 0) {
+        return;
+    }
+#if !CONFIG_FREERTOS_UNICORE
+    if (size > 1 &&
+        (mode == RUNTIME_MODE_MULTI_CORE ||
+         (mode == RUNTIME_MODE_AUTO && (int64_t)size * grain >= DL_MODULE_PARALLEL_MIN_WORK))) {
+        int half = (size + 1) / 2;
+        SemaphoreHandle_t semaphore = xSemaphoreCreateBinary();
+        parallel_for_task_data_t task_data = {
+            .func = &func,
+            .start = 0,
+            .end = half,
+            .semaphore = semaphore,
+        };
+        TaskHandle_t handle;
+        if (semaphore &&
+            xTaskCreatePinnedToCore(parallel_for_task,
+                                    NULL,
+                                    DL_MODULE_TASK_STACK_SIZE,
+                                    &task_data,
+                                    uxTaskPriorityGet(NULL),
+                                    &handle,
+                                    (xPortGetCoreID() + 1) % 2) == pdPASS) {
+            func(half, size);
+            xSemaphoreTake(semaphore, portMAX_DELAY);
+            vSemaphoreDelete(semaphore);
+            vTaskDelete(handle);
+            return;
+        }
+        ESP_LOGW(TAG, "Failed to create the task of the other core, run on one core.");
+        if (semaphore) {
+            vSemaphoreDelete(semaphore);
+        }
+    }
+#endif
+    func(0, size);
 }
 
 } // namespace module
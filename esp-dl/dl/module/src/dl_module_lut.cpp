@@ -0,0 +1,96 @@
+#include "dl_module_lut.hpp"
+#include <map>
+
+static const char *TAG = "dl::LUT";
+
+namespace dl {
+namespace module {
+namespace {
+typedef struct {
+    TensorBase *table;
+    int refcount;
+} synthesized_table_t;
+
+std::map<std::string, synthesized_table_t> &synthesized_tables()
+{
+    static std::map<std::string, synthesized_table_t> tables;
+    return tables;
+}
+
+template <typename T>
+void fill_table(
+    T *table_ptr, int size, int start, int step, const ActivationFunction &func, float in_scale, float out_scale)
+{
+    for (int i = 0; i < size; i++) {
+        float temp = func((float)(start + i * step) * in_scale);
+        tool::truncate(table_ptr[i], tool::round(temp * out_scale));
+    }
+}
+} // namespace
+
+TensorBase *LUT::get_synthesized_table(const std::string &key,
+                                       const ActivationFunction &func,
+                                       int input_exponent,
+                                       int output_exponent,
+                                       quant_type_t quant_type)
+{
+    if (!func || (quant_type != QUANT_TYPE_SYMM_8BIT && quant_type != QUANT_TYPE_SYMM_16BIT)) {
+        return nullptr;
+    }
+
+    std::string id = key + "|" + std::to_string(input_exponent) + "|" + std::to_string(output_exponent) + "|" +
+        std::to_string(quant_type);
+    std::map<std::string, synthesized_table_t> &tables = synthesized_tables();
+    auto iter = tables.find(id);
+    if (iter != tables.end()) {
+        iter->second.refcount++;
+        return iter->second.table;
+    }
+
+    float in_scale = DL_SCALE(input_exponent);
+    float out_scale = DL_RESCALE(output_exponent);
+    TensorBase *table = nullptr;
+    if (quant_type == QUANT_TYPE_SYMM_8BIT) {
+        table = new TensorBase({256}, nullptr, output_exponent, DATA_TYPE_INT8);
+        if (table->data) {
+            fill_table((int8_t *)table->data, 256, DL_QUANT8_MIN, 1, func, in_scale, out_scale);
+        }
+    } else {
+        int size = 65536 / DL_LUT_SYNTHESIZED_INT16_STEP + 1;
+        table = new TensorBase({size}, nullptr, output_exponent, DATA_TYPE_INT16);
+        if (table->data) {
+            fill_table((int16_t *)table->data,
+                       size,
+                       DL_QUANT16_MIN,
+                       DL_LUT_SYNTHESIZED_INT16_STEP,
+                       func,
+                       in_scale,
+                       out_scale);
+        }
+    }
+    if (!table->data) {
+        ESP_LOGE(TAG, "Failed to synthesize table of %s.", key.c_str());
+        delete table;
+        return nullptr;
+    }
+
+    tables.emplace(id, synthesized_table_t{table, 1});
+    return table;
+}
+
+bool LUT::release_synthesized_table(TensorBase *table)
+{
+    std::map<std::string, synthesized_table_t> &tables = synthesized_tables();
+    for (auto iter = tables.begin(); iter != tables.end(); iter++) {
+        if (iter->second.table == table) {
+            if (--iter->second.refcount == 0) {
+                delete table;
+                tables.erase(iter);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace module
+} // namespace dl
@@ -30,8 +30,10 @@ typedef enum {
     DATA_TYPE_DOUBLE = 11,
     DATA_TYPE_UINT32 = 12,
     DATA_TYPE_UINT64 = 13,
+    DATA_TYPE_INT4 = 22, /*!< two elements per byte, element 2k in the low nibble. Filter of int8 Conv and Gemm
+                            built by hand only, the fbs loader doesn't support it. */
     DATA_TYPE_MIN = DATA_TYPE_UNDEFINED,
-    DATA_TYPE_MAX = DATA_TYPE_UINT64
+    DATA_TYPE_MAX = DATA_TYPE_INT4
 } dtype_t;
 
 /**
@@ -47,7 +49,7 @@ template <typename T, typename RT = float>
 RT dequantize(T input, float scale);
 
 /**
- * @brief Return the bytes of data type
+ * @brief Return the bytes of data type. It's 1 for DATA_TYPE_INT4, use TensorBase::get_bytes() for the packed size.
  */
 size_t dtype_sizeof(dtype_t dtype);
 
@@ -201,14 +203,21 @@ public:
      *
      * @return  the bytes of Tensor.
      */
-    int get_bytes() { return this->size * this->get_dtype_bytes(); }
+    int get_bytes()
+    {
+        return this->dtype == DATA_TYPE_INT4 ? (this->size + 1) / 2 : this->size * this->get_dtype_bytes();
+    }
 
     /**
      * @brief Get the bytes of Tensor.
      *
      * @return  the bytes of Tensor.
      */
-    int get_aligned_bytes() { return this->get_aligned_size() * this->get_dtype_bytes(); }
+    int get_aligned_bytes()
+    {
+        int aligned_size = this->get_aligned_size();
+        return this->dtype == DATA_TYPE_INT4 ? (aligned_size + 1) / 2 : aligned_size * this->get_dtype_bytes();
+    }
 
     /**
      * @brief Get data pointer. If cache(preload data pointer) is not null, return cache pointer, otherwise return
@@ -30,6 +30,16 @@ template float dequantize<int16_t, float>(int16_t input, float scale);
 template double dequantize<int8_t, double>(int8_t input, float scale);
 template double dequantize<int16_t, double>(int16_t input, float scale);
 
+template <typename RT, typename T>
+static void requantize(void *output, const void *input, int size, const tool::requant_t &requant)
+{
+    RT *output_ptr = static_cast<RT *>(output);
+    const T *input_ptr = static_cast<const T *>(input);
+    for (int i = 0; i < size; i++) {
+        output_ptr[i] = tool::requantize<RT>(input_ptr[i], requant);
+    }
+}
+
 size_t dtype_sizeof(dtype_t dtype)
 {
     switch (dtype) {
@@ -57,6 +67,8 @@ size_t dtype_sizeof(dtype_t dtype)
         return sizeof(double);
     case DATA_TYPE_FLOAT16:
         return 2;
+    case DATA_TYPE_INT4:
+        return 1;
     default:
         return 1;
     }
@@ -92,6 +104,8 @@ const char *dtype_to_string(dtype_t dtype)
         return "int64";
     case DATA_TYPE_UINT64:
         return "uint64";
+    case DATA_TYPE_INT4:
+        return "int4";
     case DATA_TYPE_UNDEFINED:
         return "undefined";
     default:
@@ -141,20 +155,19 @@ TensorBase::TensorBase(
     this->exponent = exponent;
     this->dtype = dtype;
     this->cache = nullptr;
-    size_t dtype_bytes = this->get_dtype_bytes();
-    size_t aligned_size = this->get_aligned_size();
+    size_t aligned_bytes = this->get_aligned_bytes();
     if (element) {
         if (deep) {
             this->auto_free = true;
-            this->data = tool::calloc_aligned(16, aligned_size, dtype_bytes, caps);
-            tool::copy_memory(this->data, const_cast<void *>(element), this->get_size() * dtype_bytes);
+            this->data = tool::calloc_aligned(16, aligned_bytes, 1, caps);
+            tool::copy_memory(this->data, const_cast<void *>(element), this->get_bytes());
         } else {
             this->auto_free = false;
             this->data = const_cast<void *>(element);
         }
     } else {
         this->auto_free = true;
-        this->data = tool::calloc_aligned(16, aligned_size, dtype_bytes, caps);
+        this->data = tool::calloc_aligned(16, aligned_bytes, 1, caps);
     }
     if ((!element || deep) && !this->data) {
         ESP_LOGE(
@@ -286,37 +299,17 @@ bool TensorBase::assign(TensorBase *tensor)
             }
 #endif
 
-            float src_scale = DL_SCALE(tensor->exponent);
-            float inv_scale = 1.0 / (DL_SCALE(this->exponent));
+            // integer only, bit-exact to quantize(dequantize()) as the rescale is a power of 2
+            tool::requant_t requant = tool::get_requant(DL_SCALE(tensor->exponent) * DL_RESCALE(this->exponent));
 
             if (this->dtype == DATA_TYPE_INT8 && tensor->dtype == DATA_TYPE_INT8) {
-                int8_t *src_data = static_cast<int8_t *>(tensor->data);
-                int8_t *data = static_cast<int8_t *>(this->data);
-                for (int i = 0; i < this->get_size(); i++) {
-                    float tmp = dequantize(src_data[i], src_scale);
-                    data[i] = quantize<int8_t>(tmp, inv_scale);
-                }
+                requantize<int8_t, int8_t>(this->data, tensor->data, this->get_size(), requant);
             } else if (this->dtype == DATA_TYPE_INT16 && tensor->dtype == DATA_TYPE_INT16) {
-                int16_t *src_data = static_cast<int16_t *>(tensor->data);
-                int16_t *data = static_cast<int16_t *>(this->data);
-                for (int i = 0; i < this->get_size(); i++) {
-                    float tmp = dequantize(src_data[i], src_scale);
-                    data[i] = quantize<int16_t>(tmp, inv_scale);
-                }
+                requantize<int16_t, int16_t>(this->data, tensor->data, this->get_size(), requant);
             } else if (this->dtype == DATA_TYPE_INT8 && tensor->dtype == DATA_TYPE_INT16) {
-                int16_t *src_data = static_cast<int16_t *>(tensor->data);
-                int8_t *data = static_cast<int8_t *>(this->data);
-                for (int i = 0; i < this->get_size(); i++) {
-                    float tmp = dequantize(src_data[i], src_scale);
-                    data[i] = quantize<int8_t>(tmp, inv_scale);
-                }
+                requantize<int8_t, int16_t>(this->data, tensor->data, this->get_size(), requant);
             } else if (this->dtype == DATA_TYPE_INT16 && tensor->dtype == DATA_TYPE_INT8) {
-                int8_t *src_data = static_cast<int8_t *>(tensor->data);
-                int16_t *data = static_cast<int16_t *>(this->data);
-                for (int i = 0; i < this->get_size(); i++) {
-                    float tmp = dequantize(src_data[i], src_scale);
-                    data[i] = quantize<int16_t>(tmp, inv_scale);
-                }
+                requantize<int16_t, int8_t>(this->data, tensor->data, this->get_size(), requant);
             } else {
                 return false;
             }
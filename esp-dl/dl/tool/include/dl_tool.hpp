@@ -251,6 +251,84 @@ void truncate(int64_t &output, T input)
 //     output = DL_CLIP(input, INT32_MIN, INT32_MAX);
 // }
 
+/**
+ * @brief Fixed-point form of a real rescale, scale = multiplier * 2^(-shift). Negative shift means left shift.
+ */
+typedef struct {
+    int32_t multiplier; ///< Odd or zero, at most 24 bits
+    int shift;          ///< Right shift, in [-31, 62]
+} requant_t;
+
+/**
+ * @brief Get the fixed-point form of scale for requantize(). The multiplier keeps all bits of the float mantissa, so
+ * requantize() is bit-exact to tool::round(x * scale) whenever x * scale is exact in float. That is always the case
+ * for a power of 2 scale, e.g. DL_SCALE(input_exponent) * DL_RESCALE(output_exponent).
+ * Call it once per module, not per element.
+ *
+ * @param scale  real rescale, may be negative
+ * @return requant_t
+ */
+requant_t get_requant(float scale);
+
+/**
+ * @brief Requantize an integer by the fixed-point scale, output = saturate(round(value * scale)). Round strategies
+ * is same as round(). No float operation.
+ *
+ * @tparam T       int8_t, int16_t or int32_t
+ * @param value    integer to be rescaled, |value| < 2^39
+ * @param requant  from get_requant()
+ * @return T
+ */
+template <typename T>
+inline T requantize(int64_t value, const requant_t &requant)
+{
+    int64_t product = value * requant.multiplier;
+    if (requant.shift > 0) {
+#if CONFIG_IDF_TARGET_ESP32P4
+        // rounding half to even
+        int64_t remainder = product & ((static_cast<int64_t>(1) << requant.shift) - 1);
+        int64_t half = static_cast<int64_t>(1) << (requant.shift - 1);
+        product >>= requant.shift;
+        if (remainder > half || (remainder == half && (product & 1))) {
+            product++;
+        }
+#else
+        // rounding half up
+        product = (product + (static_cast<int64_t>(1) << (requant.shift - 1))) >> requant.shift;
+#endif
+    } else {
+        product <<= -requant.shift;
+    }
+    T output;
+    truncate(output, product);
+    return output;
+}
+
+/**
+ * @brief Unpack one byte of DATA_TYPE_INT4 data, element 2k is in the low nibble and element 2k + 1 in the high one.
+ *
+ * @param packed  byte k of the data
+ * @param low     element 2k
+ * @param high    element 2k + 1
+ */
+inline void unpack_int4(uint8_t packed, int8_t &low, int8_t &high)
+{
+    low = (int8_t)(packed << 4) >> 4;
+    high = (int8_t)packed >> 4;
+}
+
+/**
+ * @brief Get element i of DATA_TYPE_INT4 data.
+ *
+ * @param data  packed data
+ * @param i     index of element
+ * @return int8_t in [-8, 7]
+ */
+inline int8_t get_int4(const uint8_t *data, int i)
+{
+    return i & 1 ? (int8_t)data[i >> 1] >> 4 : (int8_t)(data[i >> 1] << 4) >> 4;
+}
+
 /**
  * @brief Generate 8bit lut table
  *
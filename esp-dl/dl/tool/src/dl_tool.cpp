@@ -147,6 +147,35 @@ T shift_and_round(T value, int shift)
 template int32_t shift_and_round(int32_t value, int shift);
 template int64_t shift_and_round(int64_t value, int shift);
 
+requant_t get_requant(float scale)
+{
+    requant_t requant = {0, 0};
+    if (scale == 0 || !isfinite(scale)) {
+        return requant;
+    }
+
+    // scale = mantissa * 2^exponent, 0.5 <= |mantissa| < 1 has 24 significant bits
+    int exponent = 0;
+    float mantissa = frexpf(scale, &exponent);
+    int32_t multiplier = (int32_t)(mantissa * (1 << 24));
+    int shift = 24 - exponent;
+    while (!(multiplier & 1)) {
+        multiplier /= 2;
+        shift--;
+    }
+    // keep |value * multiplier| < 2^63 for |value| < 2^39, the dropped bits are below the output precision
+    while (shift > 62) {
+        multiplier = (multiplier + (multiplier > 0 ? 1 : -1)) / 2;
+        shift--;
+    }
+    if (shift < -31) {
+        shift = -31;
+    }
+    requant.multiplier = multiplier;
+    requant.shift = shift;
+    return requant;
+}
+
 void set_zero(void *ptr, const int n)
 {
 #if CONFIG_TIE728_BOOST
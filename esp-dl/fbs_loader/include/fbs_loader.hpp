@@ -100,9 +100,30 @@ public:
     const char *get_model_location_string();
 
 private:
-    void *m_mmap_handle;
+    /**
+     * @brief Parse the format and the model table of the flatbuffers once. The file or partition is read here without
+     * any mapping, instead of once for every packed model checked by load() or list_models().
+     */
+    void build_index();
+
+    /**
+     * @brief Read the flatbuffers at offset, f is the opened file for MODEL_LOCATION_IN_SDCARD.
+     */
+    esp_err_t read(FILE *f, size_t offset, void *dst, size_t size);
+
+    /**
+     * @brief Load the model at offset. For MODEL_LOCATION_IN_FLASH_PARTITION only the range of the model is mapped,
+     * and the mapping is shared with the other loaded models inside it.
+     */
+    FbsModel *load_by_offset(uint32_t offset, const uint8_t *key, bool param_copy);
+
     model_location_type_t m_location;
     const void *m_fbs_buf;
+    const esp_partition_t *m_partition;     /*!< The partition while location is MODEL_LOCATION_IN_FLASH_PARTITION */
+    std::vector<const void *> m_mappings;   /*!< Mapped ranges of partition used by the loaded models */
+    int m_format;                           /*!< Format of the flatbuffers file */
+    std::vector<uint32_t> m_model_offsets;  /*!< Offset of every packed model in file, in bytes */
+    std::vector<std::string> m_model_names; /*!< Name of every packed model */
 };
 
 } // namespace fbs
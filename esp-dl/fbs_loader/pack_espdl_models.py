@@ -56,7 +56,113 @@ def read_data(filename, format):
     return data
 
 
-def pack_models(model_path_or_dir, out_file="models.espdl"):
+COMPRESS_BLOCK_SIZE = 64 * 1024  # decompressed size of every block
+LZ4_RAW_BLOCK = 0x80000000  # flag of the block stored without compression
+MODE_LZ4 = 2  # mode of the compressed model in EDL2 header
+
+
+def lz4_compress_block(src):
+    """
+    Compress one block to LZ4 block format with a greedy hash match finder.
+    Runs of zeros in pruned weights become one literal and one match with offset 1.
+    """
+
+    def write_length(out, length):
+        while length >= 255:
+            out.append(255)
+            length -= 255
+        out.append(length)
+
+    n = len(src)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    # The last match starts at least 12 bytes before the end, and the last 5 bytes are literals.
+    while i < n - 12:
+        key = src[i : i + 4]
+        candidate = table.get(key)
+        table[key] = i
+        if candidate is None or i - candidate > 65535:
+            i += 1
+            continue
+
+        match_len = 4
+        max_len = n - 5 - i
+        while (
+            match_len + 64 <= max_len
+            and src[candidate + match_len : candidate + match_len + 64]
+            == src[i + match_len : i + match_len + 64]
+        ):
+            match_len += 64
+        while match_len < max_len and src[candidate + match_len] == src[i + match_len]:
+            match_len += 1
+
+        literal_len = i - anchor
+        out.append((min(literal_len, 15) << 4) | min(match_len - 4, 15))
+        if literal_len >= 15:
+            write_length(out, literal_len - 15)
+        out += src[anchor:i]
+        out += struct.pack("<H", i - candidate)
+        if match_len - 4 >= 15:
+            write_length(out, match_len - 4 - 15)
+        i += match_len
+        anchor = i
+
+    literal_len = n - anchor
+    out.append(min(literal_len, 15) << 4)
+    if literal_len >= 15:
+        write_length(out, literal_len - 15)
+    out += src[anchor:]
+    return bytes(out)
+
+
+def compress_model(data, name=""):
+    """
+    Compress the data of EDL2 model by independent LZ4 blocks, so that the model can be decompressed while reading.
+    {
+        "EDL2": char[4]
+        mode: uint32, MODE_LZ4
+        length of compressed data: uint32
+        length of decompressed data: uint32
+        block_size: uint32
+        length of block1: uint32, with LZ4_RAW_BLOCK set if block1 is stored without compression
+        block1
+        length of block2: uint32
+        block2
+        ...
+        zero padding
+    }
+    The model is kept as is if it's EDL1, encrypted or not smaller after compression.
+    """
+
+    format = data[0:4].decode("utf-8")
+    mode, size = struct.unpack("II", data[4:12])
+    if format != "EDL2" or mode != 0:
+        print(f"{name} is not compressed, only the EDL2 model without encryption can be compressed.")
+        return data
+
+    raw = data[16 : 16 + size]
+    payload = struct.pack("I", COMPRESS_BLOCK_SIZE)
+    for pos in range(0, size, COMPRESS_BLOCK_SIZE):
+        block = raw[pos : pos + COMPRESS_BLOCK_SIZE]
+        compressed = lz4_compress_block(block)
+        if len(compressed) < len(block):
+            payload += struct.pack("I", len(compressed)) + compressed
+        else:
+            payload += struct.pack("I", len(block) | LZ4_RAW_BLOCK) + block
+    if len(payload) >= size:
+        print(f"{name} is not compressed, the compressed size is not smaller.")
+        return data
+
+    print(f"{name} is compressed from {size} bytes to {len(payload)} bytes.")
+    out = struct_pack_string("EDL2", 4) + struct.pack("III", MODE_LZ4, len(payload), size) + payload
+    if len(out) % 16 != 0:
+        out += struct.pack("x") * (16 - len(out) % 16)
+    return out
+
+
+def pack_models(model_path_or_dir, out_file="models.espdl", compress=False):
     """
     Pack all models into one binary file by the following format:
     {
@@ -101,12 +207,19 @@ def pack_models(model_path_or_dir, out_file="models.espdl"):
 
     model_path: the path of models
     out_file: the output binary filename
+    compress: compress the EDL2 models, see compress_model()
     """
 
     if len(model_path_or_dir) == 1:
         model_path_or_dir = Path(model_path_or_dir[0])
         if model_path_or_dir.is_file():
-            shutil.copyfile(model_path_or_dir, out_file)
+            if compress:
+                Path(out_file).parent.mkdir(parents=True, exist_ok=True)
+                data = read_data(model_path_or_dir, get_model_format(model_path_or_dir))
+                with open(out_file, "wb") as f:
+                    f.write(compress_model(data, model_path_or_dir.name))
+            else:
+                shutil.copyfile(model_path_or_dir, out_file)
             return
         else:
             model_files = sorted(list(model_path_or_dir.glob("*.espdl")))
@@ -128,7 +241,10 @@ def pack_models(model_path_or_dir, out_file="models.espdl"):
     name_length = 0
     for model_file in model_files:
         model_names.append(model_file.name)
-        model_bins.append(read_data(model_file, format))
+        data = read_data(model_file, format)
+        if compress:
+            data = compress_model(data, model_file.name)
+        model_bins.append(data)
         name_length += len(model_file.name)
         print(model_file.name)
 
@@ -183,6 +299,12 @@ if __name__ == "__main__":
         default="models.espdl",
         help="the path of binary file",
     )
+    parser.add_argument(
+        "-c",
+        "--compress",
+        action="store_true",
+        help="compress the models by LZ4 blocks, they are decompressed to RAM while loading",
+    )
     args = parser.parse_args()
 
-    pack_models(args.model_path, out_file=args.out_file)
+    pack_models(args.model_path, out_file=args.out_file, compress=args.compress)
@@ -1,34 +1,205 @@
 #include "fbs_loader.hpp"
 #include "mbedtls/aes.h"
+#include <algorithm>
+#include <list>
+#include <mutex>
 
 static const char *TAG = "FbsLoader";
 
 namespace fbs {
 
+#define FBS_DECRYPT_CHUNK_SIZE (32 * 1024) /*!< Bytes read and decrypted at a time from sdcard */
+#define FBS_MODE_LZ4 2                      /*!< Mode of the model compressed by pack_espdl_models.py --compress */
+#define FBS_LZ4_RAW_BLOCK 0x80000000        /*!< Flag of the block stored without compression */
+
+/**
+ * @brief Add n to the 128-bit big-endian counter of AES CTR mode.
+ */
+static void fbs_aes_ctr_add(uint8_t *counter, size_t n)
+{
+    for (int i = 15; i >= 0 && n; i--) {
+        size_t sum = counter[i] + (n & 0xff);
+        counter[i] = sum & 0xff;
+        n = (n >> 8) + (sum >> 8);
+    }
+}
+
 /**
  * @brief This function is used to decrypt the AES 128-bit CTR mode encrypted data.
  * AES (Advanced Encryption Standard) is a widely-used symmetric encryption algorithm that provides strong security for
  * data protection CTR mode converts the block cipher into a stream cipher, allowing it to encrypt data of any length
- * without the need for padding
+ * without the need for padding. CTR mode is random access, so any range of the data can be decrypted alone.
  *
- * @param ciphertext   Input Fbs data encrypted by AES 128-bit CTR mode
- * @param plaintext    Decrypted data
- * @param size         Size of input data
- * @param key          128-bit AES key
+ * @param ciphertext     Input Fbs data encrypted by AES 128-bit CTR mode
+ * @param plaintext      Decrypted data, can be the same as ciphertext
+ * @param size           Size of input data
+ * @param key            128-bit AES key
+ * @param stream_offset  Offset of ciphertext from the start of the encrypted data, in bytes
  */
-void fbs_aes_crypt_ctr(const uint8_t *ciphertext, uint8_t *plaintext, size_t size, const uint8_t *key)
+void fbs_aes_crypt_ctr(
+    const uint8_t *ciphertext, uint8_t *plaintext, size_t size, const uint8_t *key, size_t stream_offset = 0)
 {
     mbedtls_aes_context aes_ctx;
-    size_t offset = 0;
+    size_t offset = stream_offset % 16;
     uint8_t nonce[16] = {
         0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F};
     uint8_t stream_block[16];
     mbedtls_aes_init(&aes_ctx);
     mbedtls_aes_setkey_enc(&aes_ctx, key, 128); // 128-bit key
+    fbs_aes_ctr_add(nonce, stream_offset / 16);
+    if (offset) {
+        // start in the middle of a block, its key stream is generated here and the counter moves to the next block
+        mbedtls_aes_crypt_ecb(&aes_ctx, MBEDTLS_AES_ENCRYPT, nonce, stream_block);
+        fbs_aes_ctr_add(nonce, 1);
+    }
     mbedtls_aes_crypt_ctr(&aes_ctx, size, &offset, nonce, stream_block, ciphertext, plaintext);
     mbedtls_aes_free(&aes_ctx);
 }
 
+/**
+ * @brief Decompress one block of LZ4 block format. Every offset and length is checked, so a corrupted block fails
+ * instead of writing out of dst.
+ *
+ * @param src       Compressed block
+ * @param src_size  Size of compressed block
+ * @param dst       Decompressed data
+ * @param dst_size  Size of decompressed data, the block must decompress to exactly this size
+ * @return esp_err_t
+ */
+static esp_err_t fbs_lz4_decompress_block(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_size)
+{
+    size_t ip = 0, op = 0;
+    while (ip < src_size) {
+        uint8_t token = src[ip++];
+        size_t len = token >> 4;
+        if (len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= src_size) {
+                    return ESP_FAIL;
+                }
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        if (len > src_size - ip || len > dst_size - op) {
+            return ESP_FAIL;
+        }
+        memcpy(dst + op, src + ip, len);
+        ip += len;
+        op += len;
+        if (ip == src_size) {
+            break; // the last sequence has only literals
+        }
+
+        if (src_size - ip < 2) {
+            return ESP_FAIL;
+        }
+        size_t match_offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        len = (token & 0xf) + 4;
+        if ((token & 0xf) == 15) {
+            uint8_t b;
+            do {
+                if (ip >= src_size) {
+                    return ESP_FAIL;
+                }
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        if (match_offset == 0 || match_offset > op || len > dst_size - op) {
+            return ESP_FAIL;
+        }
+        const uint8_t *match = dst + op - match_offset;
+        if (match_offset >= len) {
+            memcpy(dst + op, match, len);
+        } else {
+            // overlapped match, e.g. a run of zeros is one literal and a match with offset 1
+            for (size_t i = 0; i < len; i++) {
+                dst[op + i] = match[i];
+            }
+        }
+        op += len;
+    }
+    return op == dst_size ? ESP_OK : ESP_FAIL;
+}
+
+/**
+ * @brief Decompress the model data compressed by pack_espdl_models.py --compress, see FBS_FILE_FORMAT_EDL2.
+ * The data is read from payload, or from f block by block if payload is nullptr, so only the compressed bytes are
+ * read from flash or sdcard.
+ *
+ * @param payload   The compressed data, or nullptr to read it from f
+ * @param f         The opened model file at the start of compressed data
+ * @param size      Size of compressed data
+ * @param raw_size  Size of decompressed data
+ * @return The decompressed data aligned with 16 bytes, nullptr if it fails.
+ */
+static char *fbs_decompress_model(const char *payload, FILE *f, size_t size, size_t raw_size)
+{
+    char *model_buf = (char *)dl::tool::malloc_aligned(16, raw_size, MALLOC_CAP_DEFAULT);
+    if (!model_buf) {
+        ESP_LOGE(
+            TAG,
+            "Failed to alloc %.2fKB RAM, largest available PSRAM block size %.2fKB, internal RAM block size %.2fKB",
+            raw_size / 1024.f,
+            heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) / 1024.f,
+            heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024.f);
+        return nullptr;
+    }
+
+    std::vector<uint8_t> block;
+    size_t pos = 0;
+    auto fetch = [&](size_t len) -> const uint8_t * {
+        if (len > size - pos) {
+            return nullptr;
+        }
+        const uint8_t *ptr = (const uint8_t *)payload + pos;
+        if (!payload) {
+            block.resize(len);
+            if (fread(block.data(), 1, len, f) != len) {
+                return nullptr;
+            }
+            ptr = block.data();
+        }
+        pos += len;
+        return ptr;
+    };
+
+    uint32_t block_size = 0;
+    const uint8_t *src = fetch(4);
+    if (src) {
+        memcpy(&block_size, src, 4);
+    }
+    for (size_t out = 0; block_size > 0 && out < raw_size; out += block_size) {
+        size_t len = std::min((size_t)block_size, raw_size - out);
+        uint32_t stored = 0;
+        if (!(src = fetch(4))) {
+            break;
+        }
+        memcpy(&stored, src, 4);
+        size_t stored_size = stored & ~FBS_LZ4_RAW_BLOCK;
+        if (!(src = fetch(stored_size))) {
+            break;
+        }
+        if (stored & FBS_LZ4_RAW_BLOCK) {
+            if (stored_size != len) {
+                break;
+            }
+            memcpy(model_buf + out, src, len);
+        } else if (fbs_lz4_decompress_block(src, stored_size, (uint8_t *)model_buf + out, len) != ESP_OK) {
+            break;
+        }
+        if (out + len == raw_size) {
+            return model_buf;
+        }
+    }
+    ESP_LOGE(TAG, "Failed to decompress the model, the model file is corrupted!");
+    heap_caps_free(model_buf);
+    return nullptr;
+}
+
 /**
     FBS_FILE_FORMAT_EDL1:
     {
@@ -62,11 +233,21 @@ void fbs_aes_crypt_ctr(const uint8_t *ciphertext, uint8_t *plaintext, size_t siz
         char[4]: "EDL2",
         uint32:  the mode of entru
         uint32:  the length of data
-        uint32:  zero padding
+        uint32:  zero padding, or the length of decompressed data if mode is FBS_MODE_LZ4
         uint8[]:  the data
         zero padding
     }
 
+    The data of FBS_MODE_LZ4, independent blocks so that it can be decompressed while reading:
+    {
+        uint32:  block_size, the length of decompressed data of every block except the last one
+        uint32:  the length of block1, with FBS_LZ4_RAW_BLOCK set if block1 is stored without compression
+        uint8[]: block1, LZ4 block format
+        uint32:  the length of block2
+        uint8[]: block2
+        ...
+    }
+
     FBS_FILE_FORMAT_PDL2:
     {
         "PDL2": char[4]
@@ -95,121 +276,6 @@ typedef enum {
     FBS_FILE_FORMAT_PDL2 = 4
 } fbs_file_format_t;
 
-fbs_file_format_t get_model_format(const char *fbs_buf, model_location_type_t model_location)
-{
-    char str[5];
-    if (model_location != MODEL_LOCATION_IN_SDCARD) {
-        memcpy(str, fbs_buf, 4);
-        str[4] = '\0';
-    } else {
-        FILE *f = fopen(fbs_buf, "rb");
-        if (!f) {
-            ESP_LOGE(TAG, "Failed to open %s.", fbs_buf);
-            return FBS_FILE_FORMAT_UNK;
-        }
-        fread(str, 4, 1, f);
-        str[4] = '\0';
-        fclose(f);
-    }
-
-    if (strcmp(str, "EDL1") == 0) {
-        return FBS_FILE_FORMAT_EDL1;
-    } else if (strcmp(str, "PDL1") == 0) {
-        return FBS_FILE_FORMAT_PDL1;
-    } else if (strcmp(str, "EDL2") == 0) {
-        return FBS_FILE_FORMAT_EDL2;
-    } else if (strcmp(str, "PDL2") == 0) {
-        return FBS_FILE_FORMAT_PDL2;
-    } else {
-        return FBS_FILE_FORMAT_UNK;
-    }
-}
-
-esp_err_t get_model_offset_by_index(const char *fbs_buf,
-                                    model_location_type_t model_location,
-                                    uint32_t index,
-                                    uint32_t &offset)
-{
-    if (model_location != MODEL_LOCATION_IN_SDCARD) {
-        const uint32_t *header = (const uint32_t *)fbs_buf;
-        uint32_t model_num = header[1];
-        if (index >= model_num) {
-            ESP_LOGE(TAG, "The model index is out of range.");
-            return ESP_FAIL;
-        }
-        offset = header[2 + index * 3];
-        return ESP_OK;
-    } else {
-        FILE *f = fopen(fbs_buf, "rb");
-        if (!f) {
-            ESP_LOGE(TAG, "Failed to open %s.", fbs_buf);
-            return ESP_FAIL;
-        }
-        fseek(f, 4, SEEK_SET);
-        uint32_t model_num;
-        fread(&model_num, 4, 1, f);
-        if (index >= model_num) {
-            ESP_LOGE(TAG, "The model index is out of range.");
-            fclose(f);
-            return ESP_FAIL;
-        }
-        fseek(f, 4 * (2 + index * 3), SEEK_SET);
-        fread(&offset, 4, 1, f);
-        fclose(f);
-        return ESP_OK;
-    }
-}
-
-esp_err_t get_model_offset_by_name(const char *fbs_buf,
-                                   model_location_type_t model_location,
-                                   const char *name,
-                                   uint32_t &offset)
-{
-    if (model_location != MODEL_LOCATION_IN_SDCARD) {
-        const uint32_t *header = (const uint32_t *)fbs_buf;
-        uint32_t model_num = header[1];
-        uint32_t name_offset, name_length;
-        for (int i = 0; i < model_num; i++) {
-            name_offset = header[2 + 3 * i + 1];
-            name_length = header[2 + 3 * i + 2];
-            std::string model_name(fbs_buf + name_offset, name_length);
-            if (model_name == std::string(name)) {
-                offset = header[2 + 3 * i];
-                return ESP_OK;
-            }
-        }
-        ESP_LOGE(TAG, "Model %s is not found.", name);
-        return ESP_FAIL;
-    } else {
-        FILE *f = fopen(fbs_buf, "rb");
-        if (!f) {
-            ESP_LOGE(TAG, "Failed to open %s.", fbs_buf);
-            return ESP_FAIL;
-        }
-        fseek(f, 4, SEEK_SET);
-        uint32_t model_num;
-        fread(&model_num, 4, 1, f);
-        uint32_t name_offset, name_length;
-        for (int i = 0; i < model_num; i++) {
-            fseek(f, 4 * (2 + 3 * i + 1), SEEK_SET);
-            fread(&name_offset, 4, 1, f);
-            fread(&name_length, 4, 1, f);
-            std::string model_name(name_length, '\0');
-            fseek(f, name_offset, SEEK_SET);
-            fread(model_name.data(), name_length, 1, f);
-            if (model_name == std::string(name)) {
-                fseek(f, 4 * (2 + 3 * i), SEEK_SET);
-                fread(&offset, 4, 1, f);
-                fclose(f);
-                return ESP_OK;
-            }
-        }
-        ESP_LOGE(TAG, "Model %s is not found.", name);
-        fclose(f);
-        return ESP_FAIL;
-    }
-}
-
 FbsModel *create_fbs_model(const char *fbs_buf,
                            fbs_file_format_t format,
                            model_location_type_t model_location,
@@ -223,19 +289,22 @@ FbsModel *create_fbs_model(const char *fbs_buf,
     }
 
     char *model_buf;
-    uint32_t mode, size;
+    uint32_t mode, size, raw_size = 0;
+    FILE *f = nullptr;
+    bool edl1 = format == FBS_FILE_FORMAT_EDL1 || format == FBS_FILE_FORMAT_PDL1;
     if (model_location != MODEL_LOCATION_IN_SDCARD) {
         model_buf = const_cast<char *>(fbs_buf + offset);
         uint32_t *header = (uint32_t *)model_buf;
-        mode = header[1]; // cryptographic mode, 0: without encryption, 1: aes encryption
+        mode = header[1]; // 0: without encryption, 1: aes encryption, 2: lz4 compression
         size = header[2];
-        if (format == FBS_FILE_FORMAT_EDL1 || format == FBS_FILE_FORMAT_PDL1) {
+        if (edl1) {
             model_buf += 12;
         } else {
+            raw_size = header[3];
             model_buf += 16;
         }
     } else {
-        FILE *f = fopen(fbs_buf, "rb");
+        f = fopen(fbs_buf, "rb");
         if (!f) {
             ESP_LOGE(TAG, "Failed to open %s.", fbs_buf);
             return nullptr;
@@ -243,6 +312,29 @@ FbsModel *create_fbs_model(const char *fbs_buf,
         fseek(f, offset + 4, SEEK_SET);
         fread(&mode, 4, 1, f);
         fread(&size, 4, 1, f);
+        if (!edl1) {
+            fread(&raw_size, 4, 1, f);
+        }
+    }
+
+    if (mode == FBS_MODE_LZ4) {
+        // The decompressed model is in RAM like the one read from sdcard, the parameters are not copied again.
+        char *raw_buf = nullptr;
+        if (edl1) {
+            ESP_LOGE(TAG, "The compressed model should be EDL2 format.");
+        } else {
+            raw_buf = fbs_decompress_model(f ? nullptr : model_buf, f, size, raw_size);
+        }
+        if (f) {
+            fclose(f);
+        }
+        if (!raw_buf) {
+            return nullptr;
+        }
+        return new FbsModel(raw_buf, raw_size, MODEL_LOCATION_IN_SDCARD, false, false, true, false);
+    }
+
+    if (f) {
         model_buf = (char *)dl::tool::malloc_aligned(16, size, MALLOC_CAP_DEFAULT);
         if (!model_buf) {
             ESP_LOGE(
@@ -251,18 +343,28 @@ FbsModel *create_fbs_model(const char *fbs_buf,
                 size / 1024.f,
                 heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) / 1024.f,
                 heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024.f);
+            fclose(f);
             return nullptr;
         }
-        if (format == FBS_FILE_FORMAT_EDL2 || format == FBS_FILE_FORMAT_PDL2) {
-            fseek(f, 4, SEEK_CUR);
+        if (mode != 0 && key) {
+            // Decrypt every chunk in place right after it's read, while it's still in cache.
+            for (size_t pos = 0; pos < size; pos += FBS_DECRYPT_CHUNK_SIZE) {
+                size_t len = std::min((size_t)FBS_DECRYPT_CHUNK_SIZE, size - pos);
+                fread(model_buf + pos, len, 1, f);
+                fbs_aes_crypt_ctr((const uint8_t *)model_buf + pos, (uint8_t *)model_buf + pos, len, key, pos);
+            }
+        } else {
+            fread(model_buf, size, 1, f);
         }
-        fread(model_buf, size, 1, f);
         fclose(f);
     }
 
     assert(mode == 0 || mode == 1);
     if (mode != 0 && key == NULL) {
         ESP_LOGE(TAG, "This is a cryptographic model, please enter the secret key!");
+        if (model_location == MODEL_LOCATION_IN_SDCARD) {
+            heap_caps_free(model_buf);
+        }
         return nullptr;
     }
 
@@ -293,11 +395,9 @@ FbsModel *create_fbs_model(const char *fbs_buf,
     } else { // 128-bit AES encryption
         auto_free = true;
         param_copy = (format == FBS_FILE_FORMAT_EDL1 || format == FBS_FILE_FORMAT_PDL1) ? true : false;
-        uint8_t *model_buf_decrypt;
-        if (model_location == MODEL_LOCATION_IN_SDCARD) {
-            model_buf_decrypt = (uint8_t *)model_buf;
-        } else {
-            model_buf_decrypt = (uint8_t *)dl::tool::malloc_aligned(16, size, MALLOC_CAP_DEFAULT);
+        // The model in sdcard has been decrypted while reading.
+        if (model_location != MODEL_LOCATION_IN_SDCARD) {
+            uint8_t *model_buf_decrypt = (uint8_t *)dl::tool::malloc_aligned(16, size, MALLOC_CAP_DEFAULT);
             if (!model_buf_decrypt) {
                 ESP_LOGE(TAG,
                          "Failed to alloc %.2fKB RAM, largest available PSRAM block size %.2fKB, internal RAM block "
@@ -307,16 +407,80 @@ FbsModel *create_fbs_model(const char *fbs_buf,
                          heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024.f);
                 return nullptr;
             }
+            fbs_aes_crypt_ctr((const uint8_t *)model_buf, model_buf_decrypt, size, key);
+            model_buf = (char *)model_buf_decrypt;
         }
-        fbs_aes_crypt_ctr((const uint8_t *)model_buf, model_buf_decrypt, size, key);
-        model_buf = (char *)model_buf_decrypt;
     }
 
     return new FbsModel(model_buf, size, model_location, mode, rodata_move, auto_free, param_copy);
 }
 
+namespace {
+/**
+ * @brief A mapped range of a partition, shared by all loaded models inside it.
+ */
+typedef struct {
+    const esp_partition_t *partition;
+    size_t offset;
+    size_t size;
+    esp_partition_mmap_handle_t handle;
+    const char *ptr;
+    int refcount;
+} fbs_mapping_t;
+
+std::mutex g_mapping_mutex;
+std::list<fbs_mapping_t> g_mappings;
+
+const void *acquire_mapping(const esp_partition_t *partition, size_t offset, size_t size)
+{
+    std::lock_guard<std::mutex> lock(g_mapping_mutex);
+    for (fbs_mapping_t &mapping : g_mappings) {
+        if (mapping.partition == partition && mapping.offset <= offset &&
+            offset + size <= mapping.offset + mapping.size) {
+            mapping.refcount++;
+            return mapping.ptr + (offset - mapping.offset);
+        }
+    }
+
+    uint32_t storage_size = spi_flash_mmap_get_free_pages(SPI_FLASH_MMAP_DATA) * 64 * 1024; // Byte
+    if (storage_size < size) {
+        ESP_LOGE(TAG,
+                 "The storage free size(%ld KB) of this board is less than the model size(%d KB) in %s partition",
+                 storage_size / 1024,
+                 (int)(size / 1024),
+                 partition->label);
+    }
+    // esp_partition_mmap maps the whole MMU pages and returns the address of offset, so the model keeps the alignment
+    // it has in the partition.
+    fbs_mapping_t mapping = {partition, offset, size, 0, nullptr, 1};
+    const void *ptr = nullptr;
+    esp_err_t ret = esp_partition_mmap(partition, offset, size, ESP_PARTITION_MMAP_DATA, &ptr, &mapping.handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to mmap %s partition: %s", partition->label, esp_err_to_name(ret));
+        return nullptr;
+    }
+    mapping.ptr = (const char *)ptr;
+    g_mappings.push_back(mapping);
+    return ptr;
+}
+
+void release_mapping(const void *ptr)
+{
+    std::lock_guard<std::mutex> lock(g_mapping_mutex);
+    for (auto iter = g_mappings.begin(); iter != g_mappings.end(); iter++) {
+        if (iter->ptr <= (const char *)ptr && (const char *)ptr < iter->ptr + iter->size) {
+            if (--iter->refcount == 0) {
+                esp_partition_munmap(iter->handle);
+                g_mappings.erase(iter);
+            }
+            return;
+        }
+    }
+}
+} // namespace
+
 FbsLoader::FbsLoader(const char *name, model_location_type_t location) :
-    m_mmap_handle(nullptr), m_location(location), m_fbs_buf(nullptr)
+    m_location(location), m_fbs_buf(nullptr), m_partition(nullptr), m_format(FBS_FILE_FORMAT_UNK)
 {
     if (name == nullptr) {
         return;
@@ -325,56 +489,143 @@ FbsLoader::FbsLoader(const char *name, model_location_type_t location) :
     if (m_location == MODEL_LOCATION_IN_FLASH_RODATA || m_location == MODEL_LOCATION_IN_SDCARD) {
         m_fbs_buf = (const void *)name;
     } else if (m_location == MODEL_LOCATION_IN_FLASH_PARTITION) {
-        const esp_partition_t *partition =
-            esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, name);
-        if (partition) {
-            int free_pages = spi_flash_mmap_get_free_pages(SPI_FLASH_MMAP_DATA);
-            uint32_t storage_size = free_pages * 64 * 1024; // Byte
-            ESP_LOGI(TAG, "The storage free size is %ld KB", storage_size / 1024);
-            ESP_LOGI(TAG, "The partition size is %ld KB", partition->size / 1024);
-            if (storage_size < partition->size) {
-                ESP_LOGE(TAG,
-                         "The storage free size of this board is less than %s partition required size",
-                         partition->label);
-            }
-            this->m_mmap_handle = (esp_partition_mmap_handle_t *)malloc(sizeof(esp_partition_mmap_handle_t));
-            ESP_ERROR_CHECK(esp_partition_mmap(partition,
-                                               0,
-                                               partition->size,
-                                               ESP_PARTITION_MMAP_DATA,
-                                               &this->m_fbs_buf,
-                                               static_cast<esp_partition_mmap_handle_t *>(this->m_mmap_handle)));
+        // Only the header is read here, the loaded model is mapped by load().
+        m_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, name);
+        if (m_partition) {
+            ESP_LOGI(TAG, "The partition size is %ld KB", m_partition->size / 1024);
         } else {
             ESP_LOGE(TAG, "Can not find %s in partition table", name);
         }
     }
+    if (m_fbs_buf || m_partition) {
+        this->build_index();
+    }
 }
 
-FbsLoader::~FbsLoader()
+esp_err_t FbsLoader::read(FILE *f, size_t offset, void *dst, size_t size)
+{
+    if (m_location == MODEL_LOCATION_IN_SDCARD) {
+        if (fseek(f, offset, SEEK_SET) != 0 || fread(dst, 1, size, f) != size) {
+            return ESP_FAIL;
+        }
+        return ESP_OK;
+    } else if (m_location == MODEL_LOCATION_IN_FLASH_PARTITION) {
+        return esp_partition_read(m_partition, offset, dst, size);
+    }
+    memcpy(dst, (const char *)m_fbs_buf + offset, size);
+    return ESP_OK;
+}
+
+void FbsLoader::build_index()
 {
-    if (m_location == MODEL_LOCATION_IN_FLASH_PARTITION) {
-        esp_partition_munmap(*static_cast<esp_partition_mmap_handle_t *>(this->m_mmap_handle)); // support esp-idf v5
-        if (this->m_mmap_handle) {
-            free(this->m_mmap_handle);
-            this->m_mmap_handle = nullptr;
+    char magic[5] = {0};
+    uint32_t model_num = 0;
+    std::vector<uint32_t> table;
+    std::vector<char> names;
+    uint32_t names_begin = UINT32_MAX, names_end = 0;
+    FILE *f = nullptr;
+
+    // Read the header, the model table and the model names once, and keep them for all loads.
+    if (m_location == MODEL_LOCATION_IN_SDCARD) {
+        f = fopen((const char *)m_fbs_buf, "rb");
+        if (!f) {
+            ESP_LOGE(TAG, "Failed to open %s.", (const char *)m_fbs_buf);
+            return;
+        }
+    }
+    if (this->read(f, 0, magic, 4) == ESP_OK && (strcmp(magic, "PDL1") == 0 || strcmp(magic, "PDL2") == 0) &&
+        this->read(f, 4, &model_num, 4) == ESP_OK) {
+        table.resize(3 * model_num);
+        if (this->read(f, 8, table.data(), table.size() * 4) == ESP_OK) {
+            for (int i = 0; i < model_num; i++) {
+                names_begin = std::min(names_begin, table[3 * i + 1]);
+                names_end = std::max(names_end, table[3 * i + 1] + table[3 * i + 2]);
+            }
+            if (model_num > 0) {
+                names.resize(names_end - names_begin);
+                this->read(f, names_begin, names.data(), names.size());
+            }
+            for (int i = 0; i < model_num; i++) {
+                m_model_offsets.push_back(table[3 * i]);
+                m_model_names.emplace_back(names.data() + table[3 * i + 1] - names_begin, table[3 * i + 2]);
+            }
+        } else {
+            model_num = 0;
         }
     }
+    if (f) {
+        fclose(f);
+    }
+
+    if (strcmp(magic, "EDL1") == 0) {
+        m_format = FBS_FILE_FORMAT_EDL1;
+    } else if (strcmp(magic, "PDL1") == 0 && m_model_offsets.size() == model_num) {
+        m_format = FBS_FILE_FORMAT_PDL1;
+    } else if (strcmp(magic, "EDL2") == 0) {
+        m_format = FBS_FILE_FORMAT_EDL2;
+    } else if (strcmp(magic, "PDL2") == 0 && m_model_offsets.size() == model_num) {
+        m_format = FBS_FILE_FORMAT_PDL2;
+    } else {
+        m_format = FBS_FILE_FORMAT_UNK;
+    }
+}
+
+FbsLoader::~FbsLoader()
+{
+    for (const void *mapping : m_mappings) {
+        release_mapping(mapping);
+    }
+}
+
+FbsModel *FbsLoader::load_by_offset(uint32_t offset, const uint8_t *key, bool param_copy)
+{
+    fbs_file_format_t format = (fbs_file_format_t)m_format;
+    if (m_location != MODEL_LOCATION_IN_FLASH_PARTITION) {
+        return create_fbs_model((const char *)m_fbs_buf, format, m_location, offset, key, param_copy);
+    }
+
+    // Map [offset, offset + header + data) of the model instead of the whole partition.
+    uint32_t header[3];
+    if (this->read(nullptr, offset, header, sizeof(header)) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read %s partition.", m_partition->label);
+        return nullptr;
+    }
+    size_t header_size = (format == FBS_FILE_FORMAT_EDL1 || format == FBS_FILE_FORMAT_PDL1) ? 12 : 16;
+    size_t size = header_size + header[2];
+    if (offset + size > m_partition->size) {
+        ESP_LOGE(TAG, "The model is out of %s partition, or the model file is corrupted!", m_partition->label);
+        return nullptr;
+    }
+    const void *fbs_buf = acquire_mapping(m_partition, offset, size);
+    if (!fbs_buf) {
+        return nullptr;
+    }
+    FbsModel *fbs_model = create_fbs_model((const char *)fbs_buf, format, m_location, 0, key, param_copy);
+    if (fbs_model && header[1] != FBS_MODE_LZ4) {
+        m_mappings.push_back(fbs_buf);
+    } else {
+        // The compressed model has been decompressed to RAM, its mapping is not used anymore.
+        release_mapping(fbs_buf);
+    }
+    return fbs_model;
 }
 
 FbsModel *FbsLoader::load(const int model_index, const uint8_t *key, bool param_copy)
 {
-    if (this->m_fbs_buf == nullptr) {
+    if (this->m_fbs_buf == nullptr && this->m_partition == nullptr) {
         ESP_LOGE(TAG, "Model's flatbuffers is empty.");
         return nullptr;
     }
 
     uint32_t offset = 0;
-    fbs_file_format_t format = get_model_format((const char *)m_fbs_buf, m_location);
+    fbs_file_format_t format = (fbs_file_format_t)m_format;
     if (format == FBS_FILE_FORMAT_PDL1 || format == FBS_FILE_FORMAT_PDL2) {
         // packed multiple espdl models
-        if (get_model_offset_by_index((const char *)m_fbs_buf, m_location, model_index, offset) != ESP_OK) {
+        if (model_index < 0 || model_index >= m_model_offsets.size()) {
+            ESP_LOGE(TAG, "The model index is out of range.");
             return nullptr;
         }
+        offset = m_model_offsets[model_index];
     } else if (format == FBS_FILE_FORMAT_EDL1 || format == FBS_FILE_FORMAT_EDL2) {
         // single espdl model
         if (model_index > 0) {
@@ -385,7 +636,7 @@ FbsModel *FbsLoader::load(const int model_index, const uint8_t *key, bool param_
         ESP_LOGE(TAG, "Unsupported format, or the model file is corrupted!");
         return nullptr;
     }
-    return create_fbs_model((const char *)m_fbs_buf, format, m_location, offset, key, param_copy);
+    return this->load_by_offset(offset, key, param_copy);
 }
 
 FbsModel *FbsLoader::load(const uint8_t *key, bool param_copy)
@@ -395,18 +646,21 @@ FbsModel *FbsLoader::load(const uint8_t *key, bool param_copy)
 
 FbsModel *FbsLoader::load(const char *model_name, const uint8_t *key, bool param_copy)
 {
-    if (this->m_fbs_buf == nullptr) {
+    if (this->m_fbs_buf == nullptr && this->m_partition == nullptr) {
         ESP_LOGE(TAG, "Model's flatbuffers is empty.");
         return nullptr;
     }
 
     uint32_t offset = 0;
-    fbs_file_format_t format = get_model_format((const char *)m_fbs_buf, m_location);
+    fbs_file_format_t format = (fbs_file_format_t)m_format;
     if (format == FBS_FILE_FORMAT_PDL1 || format == FBS_FILE_FORMAT_PDL2) {
         // packed multiple espdl models
-        if (get_model_offset_by_name((const char *)m_fbs_buf, m_location, model_name, offset) != ESP_OK) {
+        auto iter = std::find(m_model_names.begin(), m_model_names.end(), model_name ? model_name : "");
+        if (iter == m_model_names.end()) {
+            ESP_LOGE(TAG, "Model %s is not found.", model_name);
             return nullptr;
         }
+        offset = m_model_offsets[iter - m_model_names.begin()];
     } else if (format == FBS_FILE_FORMAT_EDL1 || format == FBS_FILE_FORMAT_EDL2) {
         // single espdl model
         if (model_name) {
@@ -417,33 +671,19 @@ FbsModel *FbsLoader::load(const char *model_name, const uint8_t *key, bool param
         ESP_LOGE(TAG, "Unsupported format, or the model file is corrupted!");
         return nullptr;
     }
-    return create_fbs_model((const char *)m_fbs_buf, format, m_location, offset, key, param_copy);
+    return this->load_by_offset(offset, key, param_copy);
 }
 
 int FbsLoader::get_model_num()
 {
-    if (this->m_fbs_buf == nullptr) {
+    if (this->m_fbs_buf == nullptr && this->m_partition == nullptr) {
         return 0;
     }
 
-    fbs_file_format_t format = get_model_format((const char *)m_fbs_buf, m_location);
+    fbs_file_format_t format = (fbs_file_format_t)m_format;
     if (format == FBS_FILE_FORMAT_PDL1 || format == FBS_FILE_FORMAT_PDL2) {
         // packed multiple espdl models
-        uint32_t model_num;
-        if (m_location != MODEL_LOCATION_IN_SDCARD) {
-            uint32_t *header = (uint32_t *)m_fbs_buf;
-            model_num = header[1];
-        } else {
-            FILE *f = fopen((const char *)m_fbs_buf, "rb");
-            if (!f) {
-                ESP_LOGE(TAG, "Failed to open %s.", (const char *)m_fbs_buf);
-                return 0;
-            }
-            fseek(f, 4, SEEK_SET);
-            fread(&model_num, 4, 1, f);
-            fclose(f);
-        }
-        return model_num;
+        return m_model_offsets.size();
     } else if (format == FBS_FILE_FORMAT_EDL1 || format == FBS_FILE_FORMAT_EDL2) {
         // single espdl model
         return 1;
@@ -457,43 +697,16 @@ int FbsLoader::get_model_num()
 
 void FbsLoader::list_models()
 {
-    if (this->m_fbs_buf == nullptr) {
+    if (this->m_fbs_buf == nullptr && this->m_partition == nullptr) {
         ESP_LOGE(TAG, "Model's flatbuffers is empty.");
         return;
     }
 
-    fbs_file_format_t format = get_model_format((const char *)m_fbs_buf, m_location);
+    fbs_file_format_t format = (fbs_file_format_t)m_format;
     if (format == FBS_FILE_FORMAT_PDL1 || format == FBS_FILE_FORMAT_PDL2) {
         // packed multiple espdl models
-        if (m_location != MODEL_LOCATION_IN_SDCARD) {
-            uint32_t *header = (uint32_t *)m_fbs_buf;
-            uint32_t model_num = header[1];
-            for (int i = 0; i < model_num; i++) {
-                uint32_t name_offset = header[2 + 3 * i + 1];
-                uint32_t name_length = header[2 + 3 * i + 2];
-                std::string name((const char *)m_fbs_buf + name_offset, name_length);
-                ESP_LOGI(TAG, "model name: %s, index:%d", name.c_str(), i);
-            }
-        } else {
-            FILE *f = fopen((const char *)m_fbs_buf, "rb");
-            if (!f) {
-                ESP_LOGE(TAG, "Failed to open %s.", (const char *)m_fbs_buf);
-                return;
-            }
-            fseek(f, 4, SEEK_SET);
-            uint32_t model_num;
-            fread(&model_num, 4, 1, f);
-            uint32_t name_offset, name_length;
-            for (int i = 0; i < model_num; i++) {
-                fseek(f, 4 * (2 + 3 * i + 1), SEEK_SET);
-                fread(&name_offset, 4, 1, f);
-                fread(&name_length, 4, 1, f);
-                std::string name(name_length, '\0');
-                fseek(f, name_offset, SEEK_SET);
-                fread(name.data(), name_length, 1, f);
-                ESP_LOGI(TAG, "model name: %s, index:%d", name.c_str(), i);
-            }
-            fclose(f);
+        for (int i = 0; i < m_model_names.size(); i++) {
+            ESP_LOGI(TAG, "model name: %s, index:%d", m_model_names[i].c_str(), i);
         }
     } else if (format == FBS_FILE_FORMAT_EDL1 || format == FBS_FILE_FORMAT_EDL2) {
         ESP_LOGI(TAG, "There is only one model in the flatbuffers without model name.");
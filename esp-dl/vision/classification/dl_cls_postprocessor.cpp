@@ -11,6 +11,7 @@ ClsPostprocessor::ClsPostprocessor(
     m_output = new dl::TensorBase(m_model_output->shape, nullptr, 0, dl::DATA_TYPE_FLOAT);
     if (need_softmax) {
         m_softmax_module = new dl::module::Softmax(nullptr, -1, dl::MODULE_NON_INPLACE, dl::QUANT_TYPE_SYMM_8BIT);
+        m_softmax_module->bind({m_model_output}, {m_output});
     }
 }
 
@@ -23,7 +24,7 @@ ClsPostprocessor::~ClsPostprocessor()
 std::vector<dl::cls::result_t> &ClsPostprocessor::postprocess()
 {
     if (m_need_softmax) {
-        m_softmax_module->run(m_model_output, m_output);
+        m_softmax_module->run();
     } else {
         m_output->assign(m_model_output);
     }
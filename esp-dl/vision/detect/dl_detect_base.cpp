@@ -2,6 +2,14 @@
 
 namespace dl {
 namespace detect {
+static const char *TAG = "dl::detect";
+
+Detect &Detect::set_temporal_mode(int refresh_interval, int tile_size, float tile_diff_thr, float max_changed_ratio)
+{
+    ESP_LOGW(TAG, "Temporal mode is not supported by this detector.");
+    return *this;
+}
+
 DetectWrapper::~DetectWrapper()
 {
     delete m_model;
@@ -46,11 +54,101 @@ dl::Model *DetectWrapper::get_raw_model(int idx)
     return m_model->get_raw_model(idx);
 }
 
+Detect &DetectWrapper::set_temporal_mode(int refresh_interval,
+                                         int tile_size,
+                                         float tile_diff_thr,
+                                         float max_changed_ratio)
+{
+    if (!m_model) {
+        load_model();
+    }
+    m_model->set_temporal_mode(refresh_interval, tile_size, tile_diff_thr, max_changed_ratio);
+    return *this;
+}
+
 DetectImpl::~DetectImpl()
 {
     delete m_model;
     delete m_image_preprocessor;
     delete m_postprocessor;
+    delete m_last_input;
+}
+
+/**
+ * @brief Ratio of tiles whose mean absolute difference is larger than diff_thr, input in sequence [H, W, C].
+ */
+template <typename T>
+static float get_changed_tile_ratio(
+    const T *input, const T *last_input, int height, int width, int channel, int tile_size, float diff_thr)
+{
+    int changed_tiles = 0;
+    int tiles = 0;
+    for (int y0 = 0; y0 < height; y0 += tile_size) {
+        int y1 = DL_MIN(y0 + tile_size, height);
+        for (int x0 = 0; x0 < width; x0 += tile_size) {
+            int x1 = DL_MIN(x0 + tile_size, width);
+            int64_t diff = 0;
+            for (int y = y0; y < y1; y++) {
+                int begin = (y * width + x0) * channel;
+                int end = (y * width + x1) * channel;
+                for (int i = begin; i < end; i++) {
+                    diff += DL_ABS(input[i] - last_input[i]);
+                }
+            }
+            changed_tiles += diff > diff_thr * (y1 - y0) * (x1 - x0) * channel;
+            tiles++;
+        }
+    }
+    return tiles ? (float)changed_tiles / tiles : 0.f;
+}
+
+bool DetectImpl::skip_model()
+{
+    if (m_refresh_interval <= 0) {
+        return false;
+    }
+    TensorBase *input = m_model->get_input();
+    bool skip = m_last_input && m_last_input->shape == input->shape && m_last_input->dtype == input->dtype &&
+        m_last_input->exponent == input->exponent && m_skipped_frames + 1 < m_refresh_interval;
+    if (skip) {
+        // [N, H, W, C] is compared in tiles of H and W, other inputs as a single row of [W, C].
+        int channel = input->shape.back();
+        int height = input->shape.size() == 4 ? input->shape[1] : 1;
+        int width = input->get_size() / channel / height;
+        float ratio = 1.f;
+        if (input->dtype == DATA_TYPE_INT8) {
+            ratio = get_changed_tile_ratio((int8_t *)input->data,
+                                           (int8_t *)m_last_input->data,
+                                           height,
+                                           width,
+                                           channel,
+                                           m_tile_size,
+                                           m_tile_diff_thr);
+        } else if (input->dtype == DATA_TYPE_INT16) {
+            ratio = get_changed_tile_ratio((int16_t *)input->data,
+                                           (int16_t *)m_last_input->data,
+                                           height,
+                                           width,
+                                           channel,
+                                           m_tile_size,
+                                           m_tile_diff_thr);
+        }
+        skip = ratio <= m_max_changed_ratio;
+    }
+
+    if (skip) {
+        m_skipped_frames++;
+    } else {
+        // the next frames are compared with the input of this run, so slow changes are accumulated
+        if (!m_last_input || m_last_input->shape != input->shape || m_last_input->dtype != input->dtype) {
+            delete m_last_input;
+            m_last_input = new TensorBase(input->shape, nullptr, input->exponent, input->dtype);
+        }
+        m_last_input->exponent = input->exponent;
+        memcpy(m_last_input->data, input->data, input->get_bytes());
+        m_skipped_frames = 0;
+    }
+    return skip;
 }
 
 std::list<dl::detect::result_t> &DetectImpl::run(const dl::image::img_t &img)
@@ -60,6 +158,20 @@ std::list<dl::detect::result_t> &DetectImpl::run(const dl::image::img_t &img)
     m_image_preprocessor->preprocess(img);
     DL_LOG_INFER_LATENCY_END_PRINT("detect", "pre");
 
+    return run_preprocessed(img.width, img.height);
+}
+
+std::list<dl::detect::result_t> &DetectImpl::run_preprocessed(int width, int height)
+{
+    DL_LOG_INFER_LATENCY_INIT();
+    if (skip_model()) {
+        for (result_t &res : m_last_result) {
+            res.limit_box(width, height);
+            res.limit_keypoint(width, height);
+        }
+        return m_last_result;
+    }
+
     DL_LOG_INFER_LATENCY_START();
     m_model->run();
     DL_LOG_INFER_LATENCY_END_PRINT("detect", "model");
@@ -67,21 +179,29 @@ std::list<dl::detect::result_t> &DetectImpl::run(const dl::image::img_t &img)
     DL_LOG_INFER_LATENCY_START();
     m_postprocessor->clear_result();
     m_postprocessor->postprocess();
-    std::list<dl::detect::result_t> &result = m_postprocessor->get_result(img.width, img.height);
+    std::list<dl::detect::result_t> &result = m_postprocessor->get_result(width, height);
     DL_LOG_INFER_LATENCY_END_PRINT("detect", "post");
 
+    if (m_refresh_interval > 0) {
+        m_last_result = result;
+    }
     return result;
 }
 
 Detect &DetectImpl::set_score_thr(float score_thr, int idx)
 {
     m_postprocessor->set_score_thr(score_thr);
+    // the cached results of temporal mode are filtered by the old threshold, run the model for the next frame
+    delete m_last_input;
+    m_last_input = nullptr;
     return *this;
 }
 
 Detect &DetectImpl::set_nms_thr(float nms_thr, int idx)
 {
     m_postprocessor->set_nms_thr(nms_thr);
+    delete m_last_input;
+    m_last_input = nullptr;
     return *this;
 }
 
@@ -89,5 +209,18 @@ dl::Model *DetectImpl::get_raw_model(int idx)
 {
     return m_model;
 }
+
+Detect &DetectImpl::set_temporal_mode(int refresh_interval, int tile_size, float tile_diff_thr, float max_changed_ratio)
+{
+    m_refresh_interval = DL_MAX(refresh_interval, 0);
+    m_tile_size = DL_MAX(tile_size, 1);
+    m_tile_diff_thr = tile_diff_thr;
+    m_max_changed_ratio = max_changed_ratio;
+    m_skipped_frames = 0;
+    m_last_result.clear();
+    delete m_last_input;
+    m_last_input = nullptr;
+    return *this;
+}
 } // namespace detect
 } // namespace dl
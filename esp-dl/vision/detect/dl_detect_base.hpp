@@ -13,6 +13,29 @@ public:
     virtual Detect &set_score_thr(float score_thr, int idx) = 0;
     virtual Detect &set_nms_thr(float nms_thr, int idx) = 0;
     virtual dl::Model *get_raw_model(int idx) = 0;
+
+    /**
+     * @brief Skip the model for frames whose preprocessed input is nearly the same as the one of the last model run,
+     * such as frames of a static camera, and return a copy of the results of the last run. The input is compared in
+     * tiles, a tile changes if the mean absolute difference of its elements is larger than tile_diff_thr.
+     * @note Not supported by default, only by detectors of a single model.
+     * @note A frame is either skipped as a whole or run as a whole, the changed tiles are not recomputed alone. With
+     * the default max_changed_ratio 0, any changed tile runs the full model, so only static frames save latency.
+     * @warning A nonzero max_changed_ratio trades missed detections for latency. The results of a skipped frame are
+     * the ones of the last run, so an object that appears or moves in the changed tiles is missed until the model
+     * runs again, up to refresh_interval - 1 frames later.
+     *
+     * @param refresh_interval   The model runs at least once every refresh_interval frames, 0 disables temporal mode.
+     * @param tile_size          Size of the square tiles, in pixels of the model input.
+     * @param tile_diff_thr      Threshold of the mean absolute difference of a tile, in quantized input values.
+     * @param max_changed_ratio  The model is skipped if the ratio of changed tiles is not larger than it. 0 runs the
+     * model if any tile changes and never misses a change larger than tile_diff_thr.
+     * @return Detect&
+     */
+    virtual Detect &set_temporal_mode(int refresh_interval,
+                                      int tile_size = 16,
+                                      float tile_diff_thr = 2.f,
+                                      float max_changed_ratio = 0.f);
 };
 
 class DetectWrapper : public Detect {
@@ -29,6 +52,10 @@ public:
     Detect &set_score_thr(float score_thr, int idx = 0) override;
     Detect &set_nms_thr(float nms_thr, int idx = 0) override;
     dl::Model *get_raw_model(int idx = 0) override;
+    Detect &set_temporal_mode(int refresh_interval,
+                              int tile_size = 16,
+                              float tile_diff_thr = 2.f,
+                              float max_changed_ratio = 0.f) override;
 };
 
 class DetectImpl : public Detect {
@@ -36,6 +63,32 @@ protected:
     dl::Model *m_model;
     dl::image::ImagePreprocessor *m_image_preprocessor;
     dl::detect::DetectPostprocessor *m_postprocessor;
+    TensorBase *m_last_input = nullptr; /*!< model input of the last model run in temporal mode */
+    int m_refresh_interval = 0;         /*!< max frames between two model runs, 0 if temporal mode is disabled */
+    int m_tile_size = 16;               /*!< tile size of temporal mode */
+    float m_tile_diff_thr = 2.f;        /*!< mean absolute difference threshold of a changed tile */
+    float m_max_changed_ratio = 0.f;    /*!< max ratio of changed tiles to skip the model */
+    int m_skipped_frames = 0;           /*!< frames skipped since the last model run */
+    std::list<result_t> m_last_result;  /*!< results of the last model run, returned for skipped frames */
+
+    /**
+     * @brief Whether the model can be skipped for the preprocessed input in temporal mode. The input is kept for the
+     * next frames if the model is not skipped.
+     *
+     * @return true if skip.
+     */
+    bool skip_model();
+
+    /**
+     * @brief Run the model and the postprocessor on the preprocessed model input. In temporal mode, a skipped frame
+     * returns a copy of the results of the last model run. The model outputs are not read then, the memory planner
+     * may have reused them, e.g. for the model input.
+     *
+     * @param width   Width of the image, to clip the boxes.
+     * @param height  Height of the image, to clip the boxes.
+     * @return Detection results.
+     */
+    std::list<dl::detect::result_t> &run_preprocessed(int width, int height);
 
 public:
     ~DetectImpl();
@@ -43,6 +96,10 @@ public:
     Detect &set_score_thr(float score_thr, int idx = 0) override;
     Detect &set_nms_thr(float nms_thr, int idx = 0) override;
     dl::Model *get_raw_model(int idx = 0) override;
+    Detect &set_temporal_mode(int refresh_interval,
+                              int tile_size = 16,
+                              float tile_diff_thr = 2.f,
+                              float max_changed_ratio = 0.f) override;
 };
 } // namespace detect
 } // namespace dl
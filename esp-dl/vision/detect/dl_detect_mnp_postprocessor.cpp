@@ -95,9 +95,12 @@ void MNPPostprocessor::parse_stage(TensorBase *score, TensorBase *box, TensorBas
 
 void MNPPostprocessor::postprocess()
 {
-    TensorBase *score = m_model->get_output("score");
-    TensorBase *bbox = m_model->get_output("box");
-    TensorBase *landmark = m_model->get_output("landmark");
+    if (resolve_outputs({"score", "box", "landmark"}) != ESP_OK) {
+        return;
+    }
+    TensorBase *score = m_model->get_tensor(m_output_handles[0]);
+    TensorBase *bbox = m_model->get_tensor(m_output_handles[1]);
+    TensorBase *landmark = m_model->get_tensor(m_output_handles[2]);
     if (score->dtype == DATA_TYPE_INT8) {
         parse_stage<int8_t>(score, bbox, landmark, 0);
     } else {
@@ -72,10 +72,13 @@ template void MSRPostprocessor::parse_stage<int16_t>(TensorBase *score, TensorBa
 
 void MSRPostprocessor::postprocess()
 {
-    TensorBase *score0 = m_model->get_output("score0");
-    TensorBase *bbox0 = m_model->get_output("box0");
-    TensorBase *score1 = m_model->get_output("score1");
-    TensorBase *bbox1 = m_model->get_output("box1");
+    if (resolve_outputs({"score0", "box0", "score1", "box1"}) != ESP_OK) {
+        return;
+    }
+    TensorBase *score0 = m_model->get_tensor(m_output_handles[0]);
+    TensorBase *bbox0 = m_model->get_tensor(m_output_handles[1]);
+    TensorBase *score1 = m_model->get_tensor(m_output_handles[2]);
+    TensorBase *bbox1 = m_model->get_tensor(m_output_handles[3]);
 
     if (score0->dtype == DATA_TYPE_INT8) {
         parse_stage<int8_t>(score0, bbox0, 0);
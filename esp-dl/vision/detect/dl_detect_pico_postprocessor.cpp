@@ -65,12 +65,15 @@ template void PicoPostprocessor::parse_stage<int16_t>(TensorBase *score, TensorB
 
 void PicoPostprocessor::postprocess()
 {
-    TensorBase *score0 = m_model->get_output("score0");
-    TensorBase *bbox0 = m_model->get_output("bbox0");
-    TensorBase *score1 = m_model->get_output("score1");
-    TensorBase *bbox1 = m_model->get_output("bbox1");
-    TensorBase *score2 = m_model->get_output("score2");
-    TensorBase *bbox2 = m_model->get_output("bbox2");
+    if (resolve_outputs({"score0", "bbox0", "score1", "bbox1", "score2", "bbox2"}) != ESP_OK) {
+        return;
+    }
+    TensorBase *score0 = m_model->get_tensor(m_output_handles[0]);
+    TensorBase *bbox0 = m_model->get_tensor(m_output_handles[1]);
+    TensorBase *score1 = m_model->get_tensor(m_output_handles[2]);
+    TensorBase *bbox1 = m_model->get_tensor(m_output_handles[3]);
+    TensorBase *score2 = m_model->get_tensor(m_output_handles[4]);
+    TensorBase *bbox2 = m_model->get_tensor(m_output_handles[5]);
 
     if (score0->dtype == DATA_TYPE_INT8) {
         parse_stage<int8_t>(score0, bbox0, 0);
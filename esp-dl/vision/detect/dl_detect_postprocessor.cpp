@@ -1,7 +1,26 @@
 #include "dl_detect_postprocessor.hpp"
 
+static const char *TAG = "dl::detect::DetectPostprocessor";
+
 namespace dl {
 namespace detect {
+esp_err_t DetectPostprocessor::resolve_outputs(std::initializer_list<const char *> names)
+{
+    if (!m_output_handles.empty()) {
+        return ESP_OK;
+    }
+    for (const char *name : names) {
+        int handle = m_model->get_tensor_handle(name);
+        if (handle < 0) {
+            ESP_LOGE(TAG, "Model output %s not found.", name);
+            m_output_handles.clear();
+            return ESP_FAIL;
+        }
+        m_output_handles.push_back(handle);
+    }
+    return ESP_OK;
+}
+
 void DetectPostprocessor::nms()
 {
     int kept_number = 0;
@@ -12,10 +12,22 @@ class DetectPostprocessor {
 protected:
     Model *m_model;
     image::ImagePreprocessor *m_image_preprocessor;
-    float m_score_thr;              /*!< Candidate box with lower score than score_thr will be filtered */
-    float m_nms_thr;                /*!< Candidate box with higher IoU than nms_thr will be filtered */
-    int m_top_k;                    /*!< Keep top_k number of candidate boxes */
-    std::list<result_t> m_box_list; /*!< Detected box list */
+    float m_score_thr;                 /*!< Candidate box with lower score than score_thr will be filtered */
+    float m_nms_thr;                   /*!< Candidate box with higher IoU than nms_thr will be filtered */
+    int m_top_k;                       /*!< Keep top_k number of candidate boxes */
+    std::list<result_t> m_box_list;    /*!< Detected box list */
+    std::vector<int> m_output_handles; /*!< Handles of model outputs used by postprocess(), see resolve_outputs() */
+
+    /**
+     * @brief Resolve the names of model outputs to handles. Only the first call does the string lookup, then
+     * m_model->get_tensor(m_output_handles[i]) is used every frame. It works after Model::minimize().
+     *
+     * @param names Names of model outputs, in the order of m_output_handles.
+     * @return
+     *      - ESP_OK    Success
+     *      - ESP_FAIL  A name is not an output of model, postprocess() should return without result.
+     */
+    esp_err_t resolve_outputs(std::initializer_list<const char *> names);
 
 public:
     DetectPostprocessor(Model *model,
@@ -110,18 +110,21 @@ template void yolo11posePostProcessor::parse_stage<int16_t>(TensorBase *score,
 
 void yolo11posePostProcessor::postprocess()
 {
-    TensorBase *bbox0 = m_model->get_output("box0");
-    TensorBase *score0 = m_model->get_output("score0");
+    if (resolve_outputs({"box0", "score0", "box1", "score1", "box2", "score2", "kpt0", "kpt1", "kpt2"}) != ESP_OK) {
+        return;
+    }
+    TensorBase *bbox0 = m_model->get_tensor(m_output_handles[0]);
+    TensorBase *score0 = m_model->get_tensor(m_output_handles[1]);
 
-    TensorBase *bbox1 = m_model->get_output("box1");
-    TensorBase *score1 = m_model->get_output("score1");
+    TensorBase *bbox1 = m_model->get_tensor(m_output_handles[2]);
+    TensorBase *score1 = m_model->get_tensor(m_output_handles[3]);
 
-    TensorBase *bbox2 = m_model->get_output("box2");
-    TensorBase *score2 = m_model->get_output("score2");
+    TensorBase *bbox2 = m_model->get_tensor(m_output_handles[4]);
+    TensorBase *score2 = m_model->get_tensor(m_output_handles[5]);
 
-    TensorBase *kpt0 = m_model->get_output("kpt0");
-    TensorBase *kpt1 = m_model->get_output("kpt1");
-    TensorBase *kpt2 = m_model->get_output("kpt2");
+    TensorBase *kpt0 = m_model->get_tensor(m_output_handles[6]);
+    TensorBase *kpt1 = m_model->get_tensor(m_output_handles[7]);
+    TensorBase *kpt2 = m_model->get_tensor(m_output_handles[8]);
 
     if (bbox0->dtype == DATA_TYPE_INT8) {
         parse_stage<int8_t>(score0, bbox0, kpt0, 0);
@@ -1,17 +1,110 @@
 #include "dl_recognition_database.hpp"
 #include <sys/stat.h>
+#if CONFIG_IDF_TARGET_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 static const char *TAG = "dl::recognition::DataBase";
 
 namespace dl {
 namespace recognition {
-DataBase::DataBase(const std::string &db_path, int feat_len) : m_db_path(db_path)
+static inline size_t align_up(size_t size, size_t align)
 {
-    struct stat st;
-    if (stat(db_path.c_str(), &st) == 0) {
+    return (size + align - 1) / align * align;
+}
+
+static uint32_t crc32(const uint8_t *data, size_t size)
+{
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Replace dst by src. Some filesystems, such as SPIFFS and FATFS, can not rename over an existing file, then dst
+ * is removed first. If the power is lost between them, the constructor of DataBase recovers dst from src.
+ */
+static esp_err_t replace_file(const std::string &src, const std::string &dst)
+{
+    if (rename(src.c_str(), dst.c_str()) == 0) {
+        return ESP_OK;
+    }
+    if (remove(dst.c_str()) != 0 || rename(src.c_str(), dst.c_str()) != 0) {
+        ESP_LOGE(TAG, "Failed to replace %s with %s.", dst.c_str(), src.c_str());
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Read the header of the meta slot of partition at offset, check its format and the CRC32 of the whole slot.
+ */
+static bool read_meta_slot(const esp_partition_t *partition, size_t offset, database_header_t &header)
+{
+    if (esp_partition_read(partition, offset, &header, sizeof(database_header_t)) != ESP_OK ||
+        memcmp(header.magic, DB_MAGIC, 4) != 0 || header.version != DB_VERSION ||
+        header.bitmap_offset != DB_HEADER_SIZE || header.capacity == 0 || header.capacity > DB_MAX_FEATS) {
+        return false;
+    }
+    size_t meta_size = align_up(header.bitmap_offset + (header.capacity + 7) / 8, DB_META_ALIGN);
+    if ((offset != 0 && offset != meta_size) || header.records_offset != 2 * meta_size) {
+        return false;
+    }
+    uint8_t *meta = (uint8_t *)malloc(meta_size);
+    if (!meta) {
+        return false;
+    }
+    bool valid = esp_partition_read(partition, offset, meta, meta_size) == ESP_OK;
+    if (valid) {
+        ((database_header_t *)meta)->crc = 0;
+        valid = crc32(meta, meta_size) == header.crc;
+    }
+    free(meta);
+    return valid;
+}
+
+DataBase::DataBase(const std::string &db_path, int feat_len, database_storage_t storage, int max_feats) :
+    m_db_path(db_path),
+    m_storage(storage),
+    m_header{},
+    m_bitmap(nullptr),
+    m_records(nullptr),
+    m_records_buf_size(0),
+    m_partition(nullptr),
+    m_mmap_handle(0),
+    m_mmap_ptr(nullptr),
+    m_mmap_size(0),
+    m_meta_slot(0)
+{
+    bool exist = false;
+    if (m_storage == DB_STORAGE_PARTITION) {
+        m_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, db_path.c_str());
+        if (!m_partition) {
+            ESP_LOGE(TAG, "Can not find %s in partition table", db_path.c_str());
+            return;
+        }
+        exist = (read_partition_header() == ESP_OK);
+    } else {
+        struct stat st;
+        exist = (stat(db_path.c_str(), &st) == 0);
+        // the power was lost after the old db was removed by replace_file(), the new one is complete.
+        std::string tmp_path = db_path + ".tmp";
+        if (!exist && stat(tmp_path.c_str(), &st) == 0) {
+            ESP_LOGW(TAG, "Recover db %s from %s.", db_path.c_str(), tmp_path.c_str());
+            exist = (rename(tmp_path.c_str(), db_path.c_str()) == 0);
+        }
+    }
+    if (exist) {
         load_database_from_storage(feat_len);
     } else {
-        create_empty_database_in_storage(feat_len);
+        create_empty_database_in_storage(feat_len, max_feats);
     }
 }
 
@@ -20,20 +113,64 @@ DataBase::~DataBase()
     clear_all_feats_in_memory();
 }
 
-esp_err_t DataBase::create_empty_database_in_storage(int feat_len)
+void DataBase::init_header(int feat_len, int max_feats)
+{
+    m_header = {};
+    memcpy(m_header.magic, DB_MAGIC, 4);
+    m_header.version = DB_VERSION;
+    m_header.feat_len = feat_len;
+    m_header.stride = align_up(feat_len * sizeof(float), DB_RECORD_ALIGN);
+    max_feats = std::min(std::max(max_feats, 1), DB_MAX_FEATS);
+    m_header.bitmap_offset = DB_HEADER_SIZE;
+    m_header.records_offset = align_up(DB_HEADER_SIZE + (max_feats + 7) / 8, DB_META_ALIGN);
+    if (m_partition) {
+        // two meta slots
+        m_header.records_offset *= 2;
+        size_t records_size = (m_partition->size > m_header.records_offset)
+            ? m_partition->size - m_header.records_offset
+            : 0;
+        max_feats = std::min<size_t>(max_feats, records_size / m_header.stride);
+    }
+    m_header.capacity = max_feats;
+}
+
+size_t DataBase::get_meta_size()
 {
-    FILE *f = fopen(m_db_path.c_str(), "wb");
-    size_t size = 0;
+    return align_up(m_header.bitmap_offset + (m_header.capacity + 7) / 8, DB_META_ALIGN);
+}
+
+esp_err_t DataBase::read_partition_header()
+{
+    database_header_t headers[2];
+    bool valid[2] = {read_meta_slot(m_partition, 0, headers[0]), false};
+    if (valid[0]) {
+        valid[1] = read_meta_slot(m_partition, headers[0].records_offset / 2, headers[1]);
+    } else {
+        // slot 0 is broken, so the meta size is unknown. Slot 1 is at one of the possible meta sizes.
+        size_t max_meta_size = align_up(DB_HEADER_SIZE + (DB_MAX_FEATS + 7) / 8, DB_META_ALIGN);
+        for (size_t offset = DB_META_ALIGN; offset <= max_meta_size && !valid[1]; offset += DB_META_ALIGN) {
+            valid[1] = read_meta_slot(m_partition, offset, headers[1]);
+        }
+    }
+    if (!valid[0] && !valid[1]) {
+        return ESP_FAIL;
+    }
+    m_meta_slot = (valid[1] && (!valid[0] || (int32_t)(headers[1].sequence - headers[0].sequence) > 0)) ? 1 : 0;
+    m_header = headers[m_meta_slot];
+    return ESP_OK;
+}
+
+esp_err_t DataBase::read_storage(size_t offset, void *dst, size_t size)
+{
+    if (m_storage == DB_STORAGE_PARTITION) {
+        return esp_partition_read(m_partition, offset, dst, size);
+    }
+    FILE *f = fopen(m_db_path.c_str(), "rb");
     if (!f) {
         ESP_LOGE(TAG, "Failed to open db.");
         return ESP_FAIL;
     }
-    m_meta.num_feats_total = 0;
-    m_meta.num_feats_valid = 0;
-    m_meta.feat_len = feat_len;
-    size = fwrite(&m_meta, sizeof(database_meta), 1, f);
-    if (size != 1) {
-        ESP_LOGE(TAG, "Failed to write db meta data.");
+    if (fseek(f, offset, SEEK_SET) != 0 || fread(dst, size, 1, f) != 1) {
         fclose(f);
         return ESP_FAIL;
     }
@@ -41,200 +178,591 @@ esp_err_t DataBase::create_empty_database_in_storage(int feat_len)
     return ESP_OK;
 }
 
-esp_err_t DataBase::clear_all_feats()
+esp_err_t DataBase::create_empty_database_in_storage(int feat_len, int max_feats)
 {
-    if (remove(m_db_path.c_str()) == -1) {
-        ESP_LOGE(TAG, "Failed to remove db.");
+    clear_all_feats_in_memory();
+    init_header(feat_len, max_feats);
+    if (m_header.capacity == 0) {
+        ESP_LOGE(TAG, "The partition is too small to hold a feature.");
         return ESP_FAIL;
     }
+    m_bitmap = (uint8_t *)calloc((m_header.capacity + 7) / 8, 1);
+
+    if (m_storage == DB_STORAGE_PARTITION) {
+        // erase both slots, so an old meta with a larger sequence is not loaded. The first write goes to slot 0.
+        ESP_RETURN_ON_ERROR(esp_partition_erase_range(m_partition, 0, m_header.records_offset),
+                            TAG,
+                            "Failed to erase db partition.");
+        m_meta_slot = 1;
+        ESP_RETURN_ON_ERROR(write_meta(), TAG, "Failed to write db meta data.");
+    } else {
+        FILE *f = fopen(m_db_path.c_str(), "wb");
+        if (!f) {
+            ESP_LOGE(TAG, "Failed to open db.");
+            return ESP_FAIL;
+        }
+        // header + empty tombstone bitmap + zero padding, records are appended after it.
+        uint8_t *meta = (uint8_t *)calloc(m_header.records_offset, 1);
+        memcpy(meta, &m_header, sizeof(database_header_t));
+        size_t size = fwrite(meta, m_header.records_offset, 1, f);
+        free(meta);
+        fclose(f);
+        if (size != 1) {
+            ESP_LOGE(TAG, "Failed to write db meta data.");
+            return ESP_FAIL;
+        }
+    }
+    return map_records();
+}
+
+esp_err_t DataBase::clear_all_feats()
+{
+    int feat_len = m_header.feat_len;
+    int capacity = m_header.capacity;
+    if (m_storage == DB_STORAGE_PARTITION) {
+        size_t erase_size = align_up((size_t)m_header.num_feats_total * m_header.stride, DB_META_ALIGN);
+        if (erase_size > 0) {
+            ESP_RETURN_ON_ERROR(esp_partition_erase_range(m_partition, m_header.records_offset, erase_size),
+                                TAG,
+                                "Failed to erase db partition.");
+        }
+    } else {
+        unmap_records();
+        if (remove(m_db_path.c_str()) == -1) {
+            ESP_LOGE(TAG, "Failed to remove db.");
+            return ESP_FAIL;
+        }
+    }
     ESP_RETURN_ON_ERROR(
-        create_empty_database_in_storage(m_meta.feat_len), TAG, "Failed to create empty db in storage.");
-    clear_all_feats_in_memory();
+        create_empty_database_in_storage(feat_len, capacity), TAG, "Failed to create empty db in storage.");
     return ESP_OK;
 }
 
 void DataBase::clear_all_feats_in_memory()
 {
-    for (auto it = m_feats.begin(); it != m_feats.end(); it++) {
-        heap_caps_free(it->feat);
+    unmap_records();
+    if (m_bitmap) {
+        free(m_bitmap);
+        m_bitmap = nullptr;
+    }
+    m_header.num_feats_total = 0;
+    m_header.num_feats_valid = 0;
+}
+
+esp_err_t DataBase::map_records()
+{
+    unmap_records();
+    size_t used_size = (size_t)m_header.num_feats_total * m_header.stride;
+    if (m_storage == DB_STORAGE_PARTITION) {
+        // Only map what is used, the MMU pages are precious.
+        m_mmap_size = m_header.records_offset + used_size;
+        ESP_RETURN_ON_ERROR(esp_partition_mmap(
+                                m_partition, 0, m_mmap_size, ESP_PARTITION_MMAP_DATA, &m_mmap_ptr, &m_mmap_handle),
+                            TAG,
+                            "Failed to mmap db partition.");
+        m_records = (uint8_t *)m_mmap_ptr + m_header.records_offset;
+        return ESP_OK;
+    }
+#if CONFIG_IDF_TARGET_LINUX
+    int fd = open(m_db_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ESP_LOGE(TAG, "Failed to open db.");
+        return ESP_FAIL;
+    }
+    m_mmap_size = m_header.records_offset + used_size;
+    void *ptr = mmap(nullptr, m_mmap_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        ESP_LOGE(TAG, "Failed to mmap db.");
+        m_mmap_size = 0;
+        return ESP_FAIL;
+    }
+    m_mmap_ptr = ptr;
+    m_records = (uint8_t *)ptr + m_header.records_offset;
+    return ESP_OK;
+#else
+    // No mmap for files on chip, read the whole record region with one fread into one buffer.
+    m_records_buf_size = std::max(used_size, (size_t)m_header.stride * 8);
+    m_records = (uint8_t *)heap_caps_malloc(m_records_buf_size, MALLOC_CAP_SPIRAM);
+    if (!m_records) {
+        ESP_LOGE(TAG,
+                 "Failed to alloc %.2fKB PSRAM, largest available PSRAM block size %.2fKB",
+                 m_records_buf_size / 1024.f,
+                 heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) / 1024.f);
+        m_records_buf_size = 0;
+        return ESP_FAIL;
+    }
+    if (used_size > 0) {
+        ESP_RETURN_ON_ERROR(
+            read_storage(m_header.records_offset, m_records, used_size), TAG, "Failed to read feature data.");
+    }
+    return ESP_OK;
+#endif
+}
+
+void DataBase::unmap_records()
+{
+    if (m_mmap_ptr) {
+        if (m_storage == DB_STORAGE_PARTITION) {
+            esp_partition_munmap(m_mmap_handle);
+        }
+#if CONFIG_IDF_TARGET_LINUX
+        else {
+            munmap(const_cast<void *>(m_mmap_ptr), m_mmap_size);
+        }
+#endif
+    } else if (m_records) {
+        heap_caps_free(m_records);
     }
-    m_feats.clear();
-    m_meta.num_feats_total = 0;
-    m_meta.num_feats_valid = 0;
+    m_mmap_handle = 0;
+    m_mmap_ptr = nullptr;
+    m_mmap_size = 0;
+    m_records = nullptr;
+    m_records_buf_size = 0;
 }
 
 esp_err_t DataBase::load_database_from_storage(int feat_len)
 {
     clear_all_feats_in_memory();
+    size_t meta_offset = 0;
+    if (m_storage == DB_STORAGE_PARTITION) {
+        if (read_partition_header() != ESP_OK) {
+            ESP_LOGE(TAG, "Unknown database format.");
+            return ESP_FAIL;
+        }
+        meta_offset = m_meta_slot * get_meta_size();
+    } else {
+        char magic[4];
+        ESP_RETURN_ON_ERROR(read_storage(0, magic, 4), TAG, "Failed to read database meta.");
+        if (memcmp(magic, DB_MAGIC, 4) != 0) {
+            return migrate_legacy_database(feat_len);
+        }
+        ESP_RETURN_ON_ERROR(
+            read_storage(0, &m_header, sizeof(database_header_t)), TAG, "Failed to read database meta.");
+    }
+    if (m_header.version != DB_VERSION) {
+        ESP_LOGE(TAG, "Unsupported database version %ld.", m_header.version);
+        return ESP_FAIL;
+    }
+    if (feat_len != m_header.feat_len) {
+        ESP_LOGE(TAG, "Feature len in storage does not match feature len in db.");
+        return ESP_FAIL;
+    }
+    m_bitmap = (uint8_t *)calloc((m_header.capacity + 7) / 8, 1);
+    ESP_RETURN_ON_ERROR(read_storage(meta_offset + m_header.bitmap_offset, m_bitmap, (m_header.capacity + 7) / 8),
+                        TAG,
+                        "Failed to read tombstone bitmap.");
+    uint32_t num_feats_valid = 0;
+    for (uint32_t i = 0; i < m_header.num_feats_total; i++) {
+        num_feats_valid += !is_deleted(i);
+    }
+    if (num_feats_valid != m_header.num_feats_valid) {
+        // the power is lost after the tombstone bit is written and before the header
+        ESP_LOGW(TAG, "Valid feature num in header is stale, rebuild it from the tombstone bitmap.");
+        m_header.num_feats_valid = num_feats_valid;
+    }
+    return map_records();
+}
+
+esp_err_t DataBase::migrate_legacy_database(int feat_len)
+{
     FILE *f = fopen(m_db_path.c_str(), "rb");
-    size_t size = 0;
     if (!f) {
         ESP_LOGE(TAG, "Failed to open db.");
         return ESP_FAIL;
     }
-    size = fread(&m_meta, sizeof(database_meta), 1, f);
-    if (size != 1) {
+    database_meta meta;
+    if (fread(&meta, sizeof(database_meta), 1, f) != 1) {
         ESP_LOGE(TAG, "Failed to read database meta.");
         fclose(f);
         return ESP_FAIL;
     }
-    if (feat_len != m_meta.feat_len) {
+    if (feat_len != meta.feat_len) {
         ESP_LOGE(TAG, "Feature len in storage does not match feature len in db.");
         fclose(f);
         return ESP_FAIL;
     }
-    uint16_t id;
-    for (int i = 0; i < m_meta.num_feats_total; i++) {
-        size = fread(&id, sizeof(uint16_t), 1, f);
-        if (size != 1) {
-            ESP_LOGE(TAG, "Failed to read feature id.");
-            fclose(f);
-            return ESP_FAIL;
-        }
+    // legacy record: {uint16_t id, float feat[feat_len]}, id 0 means deleted.
+    size_t record_size = sizeof(uint16_t) + sizeof(float) * meta.feat_len;
+    size_t feat_size = sizeof(float) * meta.feat_len;
+    uint8_t *legacy = (uint8_t *)heap_caps_malloc(std::max(record_size * meta.num_feats_total, (size_t)1),
+                                                  MALLOC_CAP_SPIRAM);
+    if (!legacy) {
+        ESP_LOGE(TAG, "Failed to alloc memory to migrate legacy db.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    if (meta.num_feats_total > 0 && fread(legacy, record_size, meta.num_feats_total, f) != meta.num_feats_total) {
+        ESP_LOGE(TAG, "Failed to read feature data.");
+        heap_caps_free(legacy);
+        fclose(f);
+        return ESP_FAIL;
+    }
+    fclose(f);
+
+    // Pack valid features to the front of the buffer, the floats are not 4 bytes aligned in legacy records.
+    std::vector<const float *> feats;
+    for (int i = 0; i < meta.num_feats_total; i++) {
+        uint16_t id;
+        memcpy(&id, legacy + i * record_size, sizeof(uint16_t));
         if (id == 0) {
-            if (fseek(f, sizeof(float) * m_meta.feat_len, SEEK_CUR) != 0) {
-                ESP_LOGE(TAG, "Failed to seek db file.");
-                fclose(f);
-                return ESP_FAIL;
-            }
             continue;
         }
-        float *feat = (float *)heap_caps_malloc(m_meta.feat_len * sizeof(float), MALLOC_CAP_SPIRAM);
-        size = fread(feat, sizeof(float), m_meta.feat_len, f);
-        if (size != m_meta.feat_len) {
-            ESP_LOGE(TAG, "Failed to read feature data.");
-            fclose(f);
-            return ESP_FAIL;
-        }
-        m_feats.emplace_back(id, feat);
+        uint8_t *dst = legacy + feats.size() * feat_size;
+        memmove(dst, legacy + i * record_size + sizeof(uint16_t), feat_size);
+        feats.push_back((const float *)dst);
     }
-    if (m_feats.size() != m_meta.num_feats_valid) {
+    if (feats.size() != meta.num_feats_valid) {
         ESP_LOGE(TAG, "Incorrect valid feature num.");
-        fclose(f);
+        heap_caps_free(legacy);
         return ESP_FAIL;
     }
-    fclose(f);
-    return ESP_OK;
-}
 
-esp_err_t DataBase::enroll_feat(TensorBase *feat)
-{
-    if (feat->dtype != DATA_TYPE_FLOAT) {
-        ESP_LOGE(TAG, "Only support float feature.");
-        return ESP_FAIL;
+    // Write the new db to a temporary file, the legacy one is only replaced after it is complete.
+    ESP_LOGW(TAG, "Migrate legacy db %s to the current format, feature ids are renumbered.", m_db_path.c_str());
+    std::string db_path = m_db_path;
+    m_db_path = db_path + ".tmp";
+    esp_err_t ret = create_empty_database_in_storage(feat_len, DB_MAX_FEATS);
+    if (ret == ESP_OK && !feats.empty()) {
+        ret = append_records(feats);
     }
-    if (feat->size != m_meta.feat_len) {
-        ESP_LOGE(TAG, "Feature len to enroll does not match feature len in db.");
-        return ESP_FAIL;
+    heap_caps_free(legacy);
+    unmap_records();
+    m_db_path = db_path;
+    std::string tmp_path = db_path + ".tmp";
+    if (ret == ESP_OK) {
+        ret = replace_file(tmp_path, db_path);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to migrate legacy db, it is kept.");
+        remove(tmp_path.c_str());
+        clear_all_feats_in_memory();
+        return ret;
     }
-    float *feat_copy = (float *)heap_caps_malloc(m_meta.feat_len * sizeof(float), MALLOC_CAP_SPIRAM);
-    memcpy(feat_copy, feat->data, feat->get_bytes());
+    return map_records();
+}
 
-    m_feats.emplace_back(m_meta.num_feats_total + 1, feat_copy);
-    m_meta.num_feats_total++;
-    m_meta.num_feats_valid++;
+esp_err_t DataBase::write_meta(int dirty_index)
+{
+    if (m_storage == DB_STORAGE_PARTITION) {
+        // Flash can only be rewritten after erasing. Rewrite the meta slot not in use, the one in use stays valid
+        // until the new one is complete, and every slot is only erased by every second write.
+        size_t meta_size = get_meta_size();
+        uint8_t *meta = (uint8_t *)calloc(meta_size, 1);
+        if (!meta) {
+            ESP_LOGE(TAG, "Failed to alloc memory to write db meta data.");
+            return ESP_FAIL;
+        }
+        int slot = 1 - m_meta_slot;
+        m_header.sequence++;
+        m_header.crc = 0;
+        memcpy(meta, &m_header, sizeof(database_header_t));
+        memcpy(meta + m_header.bitmap_offset, m_bitmap, (m_header.capacity + 7) / 8);
+        m_header.crc = crc32(meta, meta_size);
+        memcpy(meta, &m_header, sizeof(database_header_t));
+        esp_err_t ret = esp_partition_erase_range(m_partition, slot * meta_size, meta_size);
+        if (ret == ESP_OK) {
+            ret = esp_partition_write(m_partition, slot * meta_size, meta, meta_size);
+        }
+        if (ret == ESP_OK) {
+            m_meta_slot = slot;
+        }
+        free(meta);
+        return ret;
+    }
 
-    size_t size = 0;
     FILE *f = fopen(m_db_path.c_str(), "rb+");
     if (!f) {
         ESP_LOGE(TAG, "Failed to open db.");
         return ESP_FAIL;
     }
-    size = fwrite(&m_meta, sizeof(database_meta), 1, f);
-    if (size != 1) {
-        ESP_LOGE(TAG, "Failed to write database meta.");
+    if (dirty_index >= 0) {
+        // Only the bitmap byte holding the changed tombstone bit. It commits the deletion, so it's written before the
+        // header, whose num_feats_valid is rebuilt from the bitmap on load.
+        if (fseek(f, m_header.bitmap_offset + (dirty_index >> 3), SEEK_SET) != 0 ||
+            fwrite(&m_bitmap[dirty_index >> 3], 1, 1, f) != 1 || fflush(f) != 0) {
+            ESP_LOGE(TAG, "Failed to write tombstone bitmap.");
+            fclose(f);
+            return ESP_FAIL;
+        }
+        if (fseek(f, 0, SEEK_SET) != 0 || fwrite(&m_header, sizeof(database_header_t), 1, f) != 1) {
+            ESP_LOGW(TAG, "Failed to write database meta, the deletion is committed by the tombstone bitmap.");
+        }
         fclose(f);
-        return ESP_FAIL;
+        return ESP_OK;
     }
-    if (fseek(f, 0, SEEK_END) != 0) {
-        ESP_LOGE(TAG, "Failed to seek db file.");
+    if (fwrite(&m_header, sizeof(database_header_t), 1, f) != 1) {
+        ESP_LOGE(TAG, "Failed to write database meta.");
         fclose(f);
         return ESP_FAIL;
     }
-    size = fwrite(&m_feats.back().id, sizeof(uint16_t), 1, f);
-    if (size != 1) {
-        ESP_LOGE(TAG, "Failed to write feature id.");
-        fclose(f);
+    fclose(f);
+    return ESP_OK;
+}
+
+esp_err_t DataBase::prepare_partial_sector(size_t start, size_t end)
+{
+    // records written before a power loss, but not committed by the meta, are left in the tail
+    uint8_t *tail = (uint8_t *)malloc(end - start);
+    if (!tail) {
+        ESP_LOGE(TAG, "Failed to alloc memory to enroll features.");
         return ESP_FAIL;
     }
-    size = fwrite(m_feats.back().feat, sizeof(float), m_meta.feat_len, f);
-    if (size != m_meta.feat_len) {
-        ESP_LOGE(TAG, "Failed to write feature.");
-        fclose(f);
+    esp_err_t ret = esp_partition_read(m_partition, start, tail, end - start);
+    bool erased = true;
+    for (size_t i = 0; i < end - start && erased; i++) {
+        erased = tail[i] == 0xff;
+    }
+    free(tail);
+    if (ret != ESP_OK || erased) {
+        return ret;
+    }
+
+    // erase the sector and write back the committed records before start
+    size_t sector = end - DB_META_ALIGN;
+    uint8_t *head = (uint8_t *)malloc(start - sector);
+    if (!head) {
+        ESP_LOGE(TAG, "Failed to alloc memory to enroll features.");
         return ESP_FAIL;
     }
-    fclose(f);
-    return ESP_OK;
+    ret = esp_partition_read(m_partition, sector, head, start - sector);
+    if (ret == ESP_OK) {
+        ret = esp_partition_erase_range(m_partition, sector, DB_META_ALIGN);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_partition_write(m_partition, sector, head, start - sector);
+    }
+    free(head);
+    return ret;
 }
 
-esp_err_t DataBase::delete_feat(uint16_t id)
+esp_err_t DataBase::append_records(const std::vector<const float *> &feats)
 {
-    bool invalid_id = true;
-    for (auto it = m_feats.begin(); it != m_feats.end();) {
-        if (it->id != id) {
-            it++;
+    if (!m_bitmap) {
+        ESP_LOGE(TAG, "Database is not initialized.");
+        return ESP_FAIL;
+    }
+    if (m_header.num_feats_total + feats.size() > m_header.capacity) {
+        ESP_LOGE(TAG, "Database is full, compact it or create it with a larger max_feats.");
+        return ESP_FAIL;
+    }
+    size_t offset = (size_t)m_header.num_feats_total * m_header.stride;
+    size_t size = feats.size() * m_header.stride;
+    size_t feat_size = m_header.feat_len * sizeof(float);
+
+    // Pack records into the heap buffer directly, or into a temporary buffer when the storage is mmapped.
+    uint8_t *batch = nullptr;
+    if (!m_mmap_ptr) {
+        if (offset + size > m_records_buf_size) {
+            size_t buf_size = std::max(offset + size, m_records_buf_size * 2);
+            uint8_t *records = (uint8_t *)heap_caps_realloc(m_records, buf_size, MALLOC_CAP_SPIRAM);
+            if (!records) {
+                ESP_LOGE(TAG, "Failed to alloc %.2fKB PSRAM.", buf_size / 1024.f);
+                return ESP_FAIL;
+            }
+            m_records = records;
+            m_records_buf_size = buf_size;
+        }
+        batch = m_records + offset;
+    } else {
+        batch = (uint8_t *)malloc(size);
+        if (!batch) {
+            ESP_LOGE(TAG, "Failed to alloc memory to enroll features.");
+            return ESP_FAIL;
+        }
+    }
+    for (int i = 0; i < feats.size(); i++) {
+        uint8_t *record = batch + i * m_header.stride;
+        memcpy(record, feats[i], feat_size);
+        memset(record + feat_size, 0, m_header.stride - feat_size);
+    }
+
+    esp_err_t ret = ESP_OK;
+    if (m_storage == DB_STORAGE_PARTITION) {
+        // The tail of the last written sector is still erased, only erase the sectors touched for the first time.
+        size_t start = m_header.records_offset + offset;
+        size_t erase_start = align_up(start, DB_META_ALIGN);
+        size_t erase_end = align_up(start + size, DB_META_ALIGN);
+        if (erase_start > start) {
+            ret = prepare_partial_sector(start, erase_start);
+        }
+        if (ret == ESP_OK && erase_end > erase_start) {
+            ret = esp_partition_erase_range(m_partition, erase_start, erase_end - erase_start);
+        }
+        if (ret == ESP_OK) {
+            ret = esp_partition_write(m_partition, start, batch, size);
+        }
+    } else {
+        FILE *f = fopen(m_db_path.c_str(), "rb+");
+        if (!f) {
+            ESP_LOGE(TAG, "Failed to open db.");
+            ret = ESP_FAIL;
         } else {
-            heap_caps_free(it->feat);
-            it = m_feats.erase(it);
-            m_meta.num_feats_valid--;
-            invalid_id = false;
-            break;
+            if (fseek(f, m_header.records_offset + offset, SEEK_SET) != 0 || fwrite(batch, size, 1, f) != 1) {
+                ESP_LOGE(TAG, "Failed to write feature.");
+                ret = ESP_FAIL;
+            }
+            fclose(f);
         }
     }
-    if (invalid_id) {
-        ESP_LOGW(TAG, "Invalid id to delete.");
-        return ESP_FAIL;
+    if (m_mmap_ptr) {
+        free(batch);
     }
-    size_t size = 0;
-    FILE *f = fopen(m_db_path.c_str(), "rb+");
-    if (!f) {
-        ESP_LOGE(TAG, "Failed to open db.");
+    ESP_RETURN_ON_ERROR(ret, TAG, "Failed to append features.");
+
+    m_header.num_feats_total += feats.size();
+    m_header.num_feats_valid += feats.size();
+    if (write_meta() != ESP_OK) {
+        // the records are not committed, keep the memory the same as the storage
+        m_header.num_feats_total -= feats.size();
+        m_header.num_feats_valid -= feats.size();
+        ESP_LOGE(TAG, "Failed to write database meta.");
         return ESP_FAIL;
     }
-    long int offset = sizeof(database_meta) + (sizeof(uint16_t) + sizeof(float) * m_meta.feat_len) * (id - 1);
-    uint16_t id_invalid = 0;
-    if (fseek(f, offset, SEEK_SET) != 0) {
-        ESP_LOGE(TAG, "Failed to seek db file.");
-        fclose(f);
-        return ESP_FAIL;
+    if (m_mmap_ptr) {
+        return map_records();
     }
-    size = fwrite(&id_invalid, sizeof(uint16_t), 1, f);
-    if (size != 1) {
-        ESP_LOGE(TAG, "Failed to write feature id.");
-        fclose(f);
-        return ESP_FAIL;
+    return ESP_OK;
+}
+
+esp_err_t DataBase::enroll_feat(TensorBase *feat)
+{
+    return enroll_feats({feat});
+}
+
+esp_err_t DataBase::enroll_feats(const std::vector<TensorBase *> &feats)
+{
+    std::vector<const float *> feats_data;
+    feats_data.reserve(feats.size());
+    for (TensorBase *feat : feats) {
+        if (feat->dtype != DATA_TYPE_FLOAT) {
+            ESP_LOGE(TAG, "Only support float feature.");
+            return ESP_FAIL;
+        }
+        if (feat->size != m_header.feat_len) {
+            ESP_LOGE(TAG, "Feature len to enroll does not match feature len in db.");
+            return ESP_FAIL;
+        }
+        feats_data.push_back((const float *)feat->data);
+    }
+    if (feats_data.empty()) {
+        return ESP_OK;
     }
+    return append_records(feats_data);
+}
 
-    offset = sizeof(uint16_t);
-    if (fseek(f, offset, SEEK_SET) != 0) {
-        ESP_LOGE(TAG, "Failed to seek db file.");
-        fclose(f);
+esp_err_t DataBase::delete_feat(uint16_t id)
+{
+    if (id == 0 || id > m_header.num_feats_total || is_deleted(id - 1)) {
+        ESP_LOGW(TAG, "Invalid id to delete.");
         return ESP_FAIL;
     }
-    size = fwrite(&m_meta.num_feats_valid, sizeof(uint16_t), 1, f);
-    if (size != 1) {
-        ESP_LOGE(TAG, "Failed to write valid feature num.");
-        fclose(f);
+    int index = id - 1;
+    m_bitmap[index >> 3] |= 1 << (index & 7);
+    m_header.num_feats_valid--;
+    if (write_meta(index) != ESP_OK) {
+        // the deletion is not committed, keep the memory the same as the storage
+        m_bitmap[index >> 3] &= ~(1 << (index & 7));
+        m_header.num_feats_valid++;
+        ESP_LOGE(TAG, "Failed to delete feature %d.", id);
         return ESP_FAIL;
     }
-    fclose(f);
     return ESP_OK;
 }
 
 esp_err_t DataBase::delete_last_feat()
 {
-    if (m_feats.empty()) {
-        ESP_LOGW(TAG, "Empty db, nothing to delete");
-        return ESP_FAIL;
+    for (int i = (int)m_header.num_feats_total - 1; i >= 0; i--) {
+        if (!is_deleted(i)) {
+            return delete_feat(i + 1);
+        }
+    }
+    ESP_LOGW(TAG, "Empty db, nothing to delete");
+    return ESP_FAIL;
+}
+
+esp_err_t DataBase::compact()
+{
+    if (m_header.num_feats_valid == m_header.num_feats_total) {
+        return ESP_OK;
+    }
+    size_t old_used_size = (size_t)m_header.num_feats_total * m_header.stride;
+
+    // Gather the valid records, in place when they are in a heap buffer.
+    uint8_t *records = m_records;
+    if (m_mmap_ptr) {
+        records = (uint8_t *)heap_caps_malloc(std::max((size_t)m_header.num_feats_valid * m_header.stride, (size_t)1),
+                                              MALLOC_CAP_SPIRAM);
+        if (!records) {
+            ESP_LOGE(TAG, "Failed to alloc memory to compact db.");
+            return ESP_FAIL;
+        }
+    }
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < m_header.num_feats_total; i++) {
+        if (is_deleted(i)) {
+            continue;
+        }
+        if (records != m_records || n != i) {
+            memmove(records + (size_t)n * m_header.stride, get_record(i), m_header.stride);
+        }
+        n++;
+    }
+    m_header.num_feats_total = n;
+    memset(m_bitmap, 0, (m_header.capacity + 7) / 8);
+
+    esp_err_t ret = ESP_OK;
+    size_t used_size = (size_t)n * m_header.stride;
+    if (m_storage == DB_STORAGE_PARTITION) {
+        unmap_records();
+        ret = esp_partition_erase_range(m_partition, m_header.records_offset, align_up(old_used_size, DB_META_ALIGN));
+        if (ret == ESP_OK && used_size > 0) {
+            ret = esp_partition_write(m_partition, m_header.records_offset, records, used_size);
+        }
+        if (ret == ESP_OK) {
+            ret = write_meta();
+        }
+    } else {
+        // Write the compacted db to a new file, then replace the old one.
+        std::string tmp_path = m_db_path + ".tmp";
+        FILE *f = fopen(tmp_path.c_str(), "wb");
+        uint8_t *meta = (uint8_t *)calloc(m_header.records_offset, 1);
+        if (!f || !meta) {
+            ESP_LOGE(TAG, "Failed to create compacted db.");
+            ret = ESP_FAIL;
+        } else {
+            memcpy(meta, &m_header, sizeof(database_header_t));
+            if (fwrite(meta, m_header.records_offset, 1, f) != 1 ||
+                (used_size > 0 && fwrite(records, used_size, 1, f) != 1)) {
+                ESP_LOGE(TAG, "Failed to write compacted db.");
+                ret = ESP_FAIL;
+            }
+        }
+        if (f) {
+            fclose(f);
+        }
+        free(meta);
+        if (m_mmap_ptr) {
+            unmap_records();
+        }
+        if (ret == ESP_OK) {
+            ret = replace_file(tmp_path, m_db_path);
+        }
+    }
+    if (records != m_records) {
+        heap_caps_free(records);
     }
-    uint16_t id = m_feats.back().id;
-    return delete_feat(id);
+    ESP_RETURN_ON_ERROR(ret, TAG, "Failed to compact db.");
+    if (!m_records) {
+        return map_records();
+    }
+    return ESP_OK;
 }
 
 float DataBase::cal_similarity(float *feat1, float *feat2)
 {
     float sum = 0;
-    for (int i = 0; i < m_meta.feat_len; i++) {
+    for (int i = 0; i < m_header.feat_len; i++) {
         sum += feat1[i] * feat2[i];
     }
     return sum;
@@ -246,16 +774,22 @@ std::vector<result_t> DataBase::query_feat(TensorBase *feat, float thr, int top_
         ESP_LOGW(TAG, "Top_k should be greater than 0.");
         return {};
     }
+    if (!m_records) {
+        ESP_LOGE(TAG, "Database is not loaded.");
+        return {};
+    }
     std::vector<result_t> results;
     float sim;
     int i = 1;
-    for (auto it = m_feats.begin(); it != m_feats.end(); it++, i++) {
-        sim = cal_similarity(it->feat, (float *)feat->data);
-        if (sim <= thr) {
+    for (uint32_t index = 0; index < m_header.num_feats_total; index++) {
+        if (is_deleted(index)) {
             continue;
         }
-        // results.emplace_back(it->id, sim);
-        results.emplace_back(i, sim);
+        sim = cal_similarity(get_record(index), (float *)feat->data);
+        if (sim > thr) {
+            results.emplace_back(i, sim);
+        }
+        i++;
     }
     std::sort(results.begin(), results.end(), [](const result_t &a, const result_t &b) -> bool {
         return a.similarity > b.similarity;
@@ -269,15 +803,20 @@ std::vector<result_t> DataBase::query_feat(TensorBase *feat, float thr, int top_
 void DataBase::print()
 {
     printf("\n");
-    printf("[db meta]\nnum_feats_total: %d, num_feats_valid: %d, feat_len: %d\n",
-           m_meta.num_feats_total,
-           m_meta.num_feats_valid,
-           m_meta.feat_len);
+    printf("[db meta]\nnum_feats_total: %ld, num_feats_valid: %ld, feat_len: %ld, capacity: %ld\n",
+           m_header.num_feats_total,
+           m_header.num_feats_valid,
+           m_header.feat_len,
+           m_header.capacity);
     printf("[feats]\n");
-    for (auto it : m_feats) {
-        printf("id: %d feat: ", it.id);
-        for (int i = 0; i < m_meta.feat_len; i++) {
-            printf("%f, ", it.feat[i]);
+    for (uint32_t index = 0; index < m_header.num_feats_total; index++) {
+        if (is_deleted(index)) {
+            continue;
+        }
+        float *feat = get_record(index);
+        printf("id: %ld feat: ", index + 1);
+        for (int i = 0; i < m_header.feat_len; i++) {
+            printf("%f, ", feat[i]);
         }
         printf("\n");
     }
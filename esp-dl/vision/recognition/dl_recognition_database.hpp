@@ -2,6 +2,7 @@
 #include "dl_recognition_define.hpp"
 #include "dl_tensor_base.hpp"
 #include "esp_check.h"
+#include "esp_partition.h"
 #include "esp_system.h"
 #include <algorithm>
 #include <list>
@@ -10,24 +11,78 @@ namespace dl {
 namespace recognition {
 class DataBase {
 public:
-    DataBase(const std::string &db_path, int feat_len);
+    /**
+     * @brief Construct a new DataBase object. Load the database if it exists, otherwise create an empty one.
+     *
+     * @param db_path    The path of database file when storage is DB_STORAGE_FILE.
+     *                   The label of data partition when storage is DB_STORAGE_PARTITION.
+     * @param feat_len   The length of feature.
+     * @param storage    The storage type of database.
+     * @param max_feats  Max number of records, only takes effect when creating a new database.
+     */
+    DataBase(const std::string &db_path,
+             int feat_len,
+             database_storage_t storage = DB_STORAGE_FILE,
+             int max_feats = DB_MAX_FEATS);
     virtual ~DataBase();
     esp_err_t clear_all_feats();
     esp_err_t enroll_feat(TensorBase *feat);
+    /**
+     * @brief Enroll several features with one record region write and one meta write.
+     *
+     * @param feats  Float features, the size of every feature should be the feat_len of database.
+     * @return esp_err_t
+     */
+    esp_err_t enroll_feats(const std::vector<TensorBase *> &feats);
     esp_err_t delete_feat(uint16_t id);
     esp_err_t delete_last_feat();
+    /**
+     * @brief Drop the deleted records from storage and renumber the remaining ones from 1.
+     *
+     * @return esp_err_t
+     */
+    esp_err_t compact();
     std::vector<result_t> query_feat(TensorBase *feat, float thr, int top_k);
     void print();
-    int get_num_feats() { return m_meta.num_feats_valid; }
+    int get_num_feats() { return m_header.num_feats_valid; }
 
 private:
     std::string m_db_path;
-    std::list<database_feat> m_feats;
-    database_meta m_meta;
+    database_storage_t m_storage;
+    database_header_t m_header;
+    uint8_t *m_bitmap;                         /*!< RAM copy of tombstone bitmap */
+    uint8_t *m_records;                        /*!< Record region, heap buffer or mmapped storage */
+    size_t m_records_buf_size;                 /*!< In bytes, size of heap buffer. 0 if m_records is mmapped */
+    const esp_partition_t *m_partition;        /*!< Data partition when storage is DB_STORAGE_PARTITION */
+    esp_partition_mmap_handle_t m_mmap_handle; /*!< Mmap handle when storage is DB_STORAGE_PARTITION */
+    const void *m_mmap_ptr;                    /*!< Start address of mapped storage, nullptr if not mapped */
+    size_t m_mmap_size;                        /*!< In bytes, size of mapped storage */
+    int m_meta_slot;                           /*!< Meta slot of partition written last, 0 or 1 */
 
-    esp_err_t create_empty_database_in_storage(int feat_len);
+    void init_header(int feat_len, int max_feats);
+    esp_err_t create_empty_database_in_storage(int feat_len, int max_feats);
     esp_err_t load_database_from_storage(int feat_len);
+    esp_err_t migrate_legacy_database(int feat_len);
+    esp_err_t read_storage(size_t offset, void *dst, size_t size);
+    /**
+     * @brief Find the valid meta slot of partition with the larger sequence and read its header.
+     *
+     * @return ESP_OK if a valid slot is found.
+     */
+    esp_err_t read_partition_header();
+    esp_err_t write_meta(int dirty_index = -1);
+    size_t get_meta_size();
+    /**
+     * @brief Make [start, end) of the last record sector of partition writable. It is erased, unless the records of
+     * an enroll interrupted by a power loss are left there.
+     */
+    esp_err_t prepare_partial_sector(size_t start, size_t end);
+    esp_err_t append_records(const std::vector<const float *> &feats);
+    esp_err_t map_records();
+    void unmap_records();
     void clear_all_feats_in_memory();
+    bool is_deleted(uint32_t index) { return m_bitmap[index >> 3] & (1 << (index & 7)); }
+    float *get_record(uint32_t index) { return (float *)(m_records + (size_t)index * m_header.stride); }
     float cal_similarity(float *feat1, float *feat2);
 };
 } // namespace recognition
@@ -3,17 +3,61 @@
 
 namespace dl {
 namespace recognition {
+#define DB_MAGIC "EDB2"        /*!< Magic of the database file/partition */
+#define DB_VERSION 1           /*!< Version of the database format */
+#define DB_HEADER_SIZE 64      /*!< Size of database_header_t in bytes */
+#define DB_RECORD_ALIGN 16     /*!< Every record starts at a 16 bytes aligned offset */
+#define DB_META_ALIGN 4096     /*!< Header + tombstone bitmap are padded to a flash sector */
+#define DB_MAX_FEATS 0xffff    /*!< Feature id is uint16_t, 0 is reserved */
+
+typedef enum {
+    DB_STORAGE_FILE = 0,      /*!< The database is a file in a filesystem(SPIFFS, FATFS, SDCard) */
+    DB_STORAGE_PARTITION = 1, /*!< The database is a raw data partition, read through mmap */
+} database_storage_t;
+
+/**
+ * On-disk layout:
+ * {
+ *     database_header_t                            [0, 64)
+ *     tombstone bitmap, bit i set = record i deleted [bitmap_offset, bitmap_offset + ceil(capacity / 8))
+ *     zero padding to DB_META_ALIGN, the size of meta
+ *     DB_STORAGE_PARTITION only: the second meta slot, same layout as above [meta size, 2 * meta size)
+ *     record 0, feat_len floats + zero padding      [records_offset, records_offset + stride)
+ *     record 1, ...                                  [records_offset + stride, records_offset + 2 * stride)
+ *     ...
+ * }
+ * The id of record i is i + 1. Records are only appended, deletion only sets the tombstone bit, compact() drops the
+ * deleted records and renumbers the remaining ones.
+ * A partition alternates the meta writes between the two slots, so a power loss while a slot is erased or written
+ * leaves the other one valid. The valid slot with the larger sequence is loaded.
+ * A file commits a deletion with the tombstone bit, written before the header. num_feats_valid is rebuilt from the
+ * tombstone bitmap on load, so a power loss between the two writes keeps the database valid.
+ */
+typedef struct {
+    char magic[4];            /*!< DB_MAGIC */
+    uint32_t version;         /*!< DB_VERSION */
+    uint32_t feat_len;        /*!< Number of floats in one feature */
+    uint32_t stride;          /*!< In bytes, size of one record, aligned to DB_RECORD_ALIGN */
+    uint32_t capacity;        /*!< Max number of records, size of tombstone bitmap in bits */
+    uint32_t num_feats_total; /*!< Number of records, including deleted ones */
+    uint32_t num_feats_valid; /*!< Number of records not deleted */
+    uint32_t bitmap_offset;   /*!< In bytes, offset of tombstone bitmap */
+    uint32_t records_offset;  /*!< In bytes, offset of record region, aligned to DB_META_ALIGN */
+    uint32_t sequence;        /*!< DB_STORAGE_PARTITION only, incremented by every meta write */
+    uint32_t crc;             /*!< DB_STORAGE_PARTITION only, CRC32 of the meta slot with crc = 0 */
+    uint32_t reserved[5];
+} database_header_t;
+static_assert(sizeof(database_header_t) == DB_HEADER_SIZE, "database_header_t must be 64 bytes");
+
+/**
+ * Meta data of the legacy database format. Only used to migrate legacy database to the current format.
+ */
 typedef struct {
     uint16_t num_feats_total;
     uint16_t num_feats_valid;
     uint16_t feat_len;
 } database_meta;
 
-typedef struct {
-    uint16_t id;
-    float *feat;
-} database_feat;
-
 typedef struct {
     uint16_t id;
     float similarity;
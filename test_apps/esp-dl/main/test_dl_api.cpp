@@ -1,8 +1,24 @@
+#include "dl_base_conv2d_sparse.hpp"
+#include "dl_base_conv2d_winograd.hpp"
+#include "dl_base_dotprod.hpp"
+#include "dl_detect_base.hpp"
+#include "dl_detect_yolo11_postprocessor.hpp"
+#include "dl_math.hpp"
 #include "dl_model_base.hpp"
+#include "dl_model_scheduler.hpp"
 #include "dl_module_add.hpp"
+#include "dl_module_conv.hpp"
 #include "dl_module_creator.hpp"
+#include "dl_module_gru.hpp"
+#include "dl_module_lut.hpp"
+#include "dl_module_lstm.hpp"
 #include "dl_module_relu.hpp"
+#include "dl_module_resize.hpp"
+#include "dl_module_sigmoid.hpp"
+#include "dl_module_streaming_cache.hpp"
+#include "dl_recognition_database.hpp"
 #include "esp_log.h"
+#include "esp_spiffs.h"
 #include "esp_timer.h"
 #include "unity.h"
 #include <type_traits>
@@ -85,6 +101,341 @@ TEST_CASE("Test dl model API: run()", "[api]")
     TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
 }
 
+TEST_CASE("Test dl model API: get_tensor_handle()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl model API: get_tensor_handle()");
+    Model *model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+
+    std::map<std::string, TensorBase *> &outputs = model->get_outputs();
+    std::vector<int> handles;
+    for (auto &output : outputs) {
+        int handle = model->get_tensor_handle(output.first);
+        TEST_ASSERT_EQUAL(true, handle >= 0);
+        TEST_ASSERT_EQUAL(true, model->get_tensor(handle) == output.second);
+        handles.push_back(handle);
+    }
+    TEST_ASSERT_EQUAL(-1, model->get_tensor_handle("not_a_tensor_name"));
+
+    // handles keep valid after the name map is released.
+    model->minimize();
+    int i = 0;
+    for (auto &output : outputs) {
+        TEST_ASSERT_EQUAL(true, model->get_tensor(handles[i++]) == output.second);
+    }
+    delete model;
+}
+
+class OutputPostprocessor : public detect::DetectPostprocessor {
+public:
+    std::string m_name;
+    TensorBase *m_tensor = nullptr;
+
+    OutputPostprocessor(Model *model, const std::string &name) :
+        detect::DetectPostprocessor(model, nullptr, 0.5, 0.5, 10), m_name(name) {};
+    void postprocess() override
+    {
+        if (resolve_outputs({m_name.c_str()}) != ESP_OK) {
+            return;
+        }
+        m_tensor = m_model->get_tensor(m_output_handles[0]);
+    }
+};
+
+TEST_CASE("Test dl detect API: postprocess() after minimize()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl detect API: postprocess() after minimize()");
+    Model *model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    // the detectors minimize the model before the first postprocess(), when the outputs are resolved
+    model->minimize();
+    model->run();
+    for (auto &output : model->get_outputs()) {
+        OutputPostprocessor postprocessor(model, output.first);
+        postprocessor.postprocess();
+        TEST_ASSERT_EQUAL(true, postprocessor.m_tensor == output.second);
+    }
+
+    // a model without the expected outputs gives no result instead of crashing
+    detect::yolo11PostProcessor yolo11(model, nullptr, 0.25, 0.7, 10, {{8, 8, 4, 4}});
+    yolo11.postprocess();
+    TEST_ASSERT_EQUAL(0, yolo11.get_result(100, 100).size());
+    delete model;
+}
+
+class SumPostprocessor : public detect::DetectPostprocessor {
+public:
+    SumPostprocessor(Model *model) : detect::DetectPostprocessor(model, nullptr, 0.5, 0.5, 10) {};
+    void postprocess() override
+    {
+        TensorBase *output = m_model->get_outputs().begin()->second;
+        int8_t *output_ptr = (int8_t *)output->get_element_ptr();
+        int sum = 0;
+        for (int i = 0; i < output->get_size(); i++) {
+            sum += output_ptr[i];
+        }
+        m_box_list.push_back({0, (float)sum, {0, 0, 1, 1}, {}});
+    }
+};
+
+class TemporalDetect : public detect::DetectImpl {
+public:
+    TemporalDetect(Model *model)
+    {
+        m_model = model;
+        m_image_preprocessor = nullptr;
+        m_postprocessor = new SumPostprocessor(model);
+    }
+    using detect::DetectImpl::run_preprocessed;
+};
+
+TEST_CASE("Test dl detect API: set_temporal_mode()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl detect API: set_temporal_mode()");
+    Model *model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    model->minimize();
+    TensorBase *input = model->get_input();
+    TensorBase *output = model->get_outputs().begin()->second;
+    int8_t *input_ptr = (int8_t *)input->get_element_ptr();
+    for (int i = 0; i < input->get_bytes(); i++) {
+        input_ptr[i] = i % 61 - 30;
+    }
+    TemporalDetect *detect = new TemporalDetect(model);
+    detect->set_temporal_mode(3);
+
+    std::list<detect::result_t> result = detect->run_preprocessed(8, 8);
+    TEST_ASSERT_EQUAL(1, result.size());
+    TensorBase *expected = new TensorBase(output->get_shape(), nullptr, output->get_exponent(), output->get_dtype());
+    expected->assign(output);
+
+    // the planner may reuse the memory of the outputs, e.g. for the input of the next frame. Overwrite them, the
+    // skipped frames must return the cached results instead of reading them.
+    memset(output->get_element_ptr(), 0x55, output->get_bytes());
+    for (int frame = 0; frame < 2; frame++) {
+        std::list<detect::result_t> &skipped = detect->run_preprocessed(8, 8);
+        TEST_ASSERT_EQUAL(1, skipped.size());
+        TEST_ASSERT_EQUAL(true, skipped.front().score == result.front().score);
+        TEST_ASSERT_EQUAL(0x55, ((uint8_t *)output->get_element_ptr())[0]);
+    }
+
+    // refresh after refresh_interval frames
+    std::list<detect::result_t> &refreshed = detect->run_preprocessed(8, 8);
+    TEST_ASSERT_EQUAL(true, refreshed.front().score == result.front().score);
+    TEST_ASSERT_EQUAL(true, output->equal(expected, 0, true));
+
+    // a changed input runs the model
+    memset(output->get_element_ptr(), 0x55, output->get_bytes());
+    for (int i = 0; i < input->get_bytes(); i++) {
+        input_ptr[i] = -input_ptr[i];
+    }
+    std::list<detect::result_t> &changed = detect->run_preprocessed(8, 8);
+    int8_t *output_ptr = (int8_t *)output->get_element_ptr();
+    int sum = 0;
+    for (int i = 0; i < output->get_size(); i++) {
+        sum += output_ptr[i];
+    }
+    TEST_ASSERT_EQUAL(true, sum != 0x55 * output->get_size());
+    TEST_ASSERT_EQUAL(true, changed.front().score == sum);
+
+    delete expected;
+    delete detect;
+}
+
+TEST_CASE("Test dl model API: set_input_shapes()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl model API: set_input_shapes()");
+    Model *model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    delete model;
+
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    std::map<std::string, std::vector<int>> input_shapes;
+    for (auto &input : model->get_inputs()) {
+        input_shapes.emplace(input.first, input.second->get_shape());
+    }
+    TEST_ASSERT_EQUAL(ESP_FAIL, model->set_input_shapes({{"not_a_tensor_name", {1}}}));
+
+    // the plan of the current shapes is the same as the one of build()
+    model->run();
+    TensorBase *output = model->get_outputs().begin()->second;
+    TensorBase *expected = new TensorBase(output->get_shape(), nullptr, output->get_exponent(), output->get_dtype());
+    expected->assign(output);
+    model->set_memory_plan_cache_size(1);
+    TEST_ASSERT_EQUAL(ESP_OK, model->plan_input_shapes(input_shapes));
+    TEST_ASSERT_EQUAL(ESP_OK, model->set_input_shapes(input_shapes));
+    model->run();
+    TEST_ASSERT_EQUAL(true, output->equal(expected, 0, true));
+
+    // a plan whose arena can not be allocated leaves the current plan and arena in use
+    std::map<std::string, std::vector<int>> huge_shapes = input_shapes;
+    for (auto &shape : huge_shapes) {
+        shape.second[0] *= 1 << 22;
+    }
+    TEST_ASSERT_EQUAL(ESP_FAIL, model->plan_input_shapes(huge_shapes));
+    TEST_ASSERT_EQUAL(ESP_FAIL, model->set_input_shapes(huge_shapes));
+    model->run();
+    TEST_ASSERT_EQUAL(true, output->equal(expected, 0, true));
+    delete expected;
+    delete model;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+TEST_CASE("Test dl model API: run_step()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl model API: run_step()");
+    Model *model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    delete model;
+
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    Model *ref_model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    for (Model *m : {model, ref_model}) {
+        for (auto &input : m->get_inputs()) {
+            int8_t *input_ptr = (int8_t *)input.second->get_element_ptr();
+            for (int i = 0; i < input.second->get_bytes(); i++) {
+                input_ptr[i] = i % 61 - 30;
+            }
+        }
+    }
+    ref_model->run();
+
+    int module_num = model->get_module_num();
+    TEST_ASSERT_EQUAL(true, model->run_done());
+    TEST_ASSERT_EQUAL(0, model->run_step());
+    model->run_begin();
+    TEST_ASSERT_EQUAL(false, model->run_done());
+    TEST_ASSERT_EQUAL(module_num - 1, model->run_step());
+    // 1 us budget runs exactly one module
+    TEST_ASSERT_EQUAL(DL_MAX(module_num - 2, 0), model->run_step(0, 1));
+    while (model->run_step(2, 10000) > 0) {
+        // other work of the application between the steps
+    }
+    TEST_ASSERT_EQUAL(true, model->run_done());
+    for (auto &output : model->get_outputs()) {
+        TEST_ASSERT_EQUAL(true, output.second->equal(ref_model->get_output(output.first), 0, true));
+    }
+
+    // the layer range API gives the same result
+    int half = module_num / 2;
+    TEST_ASSERT_EQUAL(ESP_OK, model->run_range(0, half));
+    TEST_ASSERT_EQUAL(ESP_OK, model->run_range(half, module_num));
+    for (auto &output : model->get_outputs()) {
+        TEST_ASSERT_EQUAL(true, output.second->equal(ref_model->get_output(output.first), 0, true));
+    }
+    delete model;
+    delete ref_model;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+TEST_CASE("Test dl model API: set_exit_gate()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl model API: set_exit_gate()");
+    Model *model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    delete model;
+
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    Model *ref_model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    for (Model *m : {model, ref_model}) {
+        for (auto &input : m->get_inputs()) {
+            int8_t *input_ptr = (int8_t *)input.second->get_element_ptr();
+            for (int i = 0; i < input.second->get_bytes(); i++) {
+                input_ptr[i] = i % 61 - 30;
+            }
+        }
+    }
+    ref_model->run();
+
+    // the test model declares no exit point, the gate is never called and the outputs stay valid
+    std::vector<std::string> exit_points = model->get_exit_points();
+    int gate_calls = 0;
+    model->set_exit_gate([&](const std::string &name, TensorBase *tensor) {
+        gate_calls++;
+        return true;
+    });
+    model->run();
+    TEST_ASSERT_EQUAL(exit_points.empty() ? 0 : 1, gate_calls);
+    TEST_ASSERT_EQUAL(exit_points.empty(), model->is_output_valid());
+    if (exit_points.empty()) {
+        TEST_ASSERT_EQUAL(true, model->get_exit_point().empty());
+        for (auto &output : model->get_outputs()) {
+            TEST_ASSERT_EQUAL(true, output.second->equal(ref_model->get_output(output.first), 0, true));
+        }
+    } else {
+        TEST_ASSERT_EQUAL(true, model->get_exit_point() == exit_points[0]);
+    }
+
+    // without gate the model always runs to the end
+    model->set_exit_gate(nullptr);
+    model->run();
+    TEST_ASSERT_EQUAL(true, model->is_output_valid());
+    for (auto &output : model->get_outputs()) {
+        TEST_ASSERT_EQUAL(true, output.second->equal(ref_model->get_output(output.first), 0, true));
+    }
+    delete model;
+    delete ref_model;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+TEST_CASE("Test dl model API: ModelScheduler", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl model API: ModelScheduler");
+    Model *model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    delete model;
+
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    Model *low_model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    Model *high_model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    Model *ref_model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    for (Model *m : {low_model, high_model, ref_model}) {
+        for (auto &input : m->get_inputs()) {
+            int8_t *input_ptr = (int8_t *)input.second->get_element_ptr();
+            for (int i = 0; i < input.second->get_bytes(); i++) {
+                input_ptr[i] = i % 61 - 30;
+            }
+        }
+    }
+    ref_model->run();
+    int module_num = low_model->get_module_num();
+    TEST_ASSERT_EQUAL(ESP_FAIL, low_model->run_range(0, module_num + 1));
+
+    ModelScheduler scheduler(1);
+    int low = scheduler.add_model(low_model, 0);
+    int high = scheduler.add_model(high_model, 1, 1000000);
+    TEST_ASSERT_EQUAL(ESP_OK, scheduler.submit(low));
+    TEST_ASSERT_EQUAL(ESP_FAIL, scheduler.submit(low));
+    TEST_ASSERT_EQUAL(low, scheduler.step());
+
+    // the high priority model preempts the low one between modules
+    TEST_ASSERT_EQUAL(ESP_OK, scheduler.submit(high));
+    for (int i = 0; i < module_num; i++) {
+        TEST_ASSERT_EQUAL(high, scheduler.step());
+    }
+    TEST_ASSERT_EQUAL(false, scheduler.is_pending(high));
+    TEST_ASSERT_EQUAL(module_num > 1, scheduler.is_pending(low));
+    scheduler.run_until_idle();
+    TEST_ASSERT_EQUAL(-1, scheduler.step());
+    TEST_ASSERT_EQUAL(1, scheduler.get_stats(low).runs);
+    TEST_ASSERT_EQUAL(1, scheduler.get_stats(high).runs);
+    scheduler.print_stats();
+
+    for (Model *m : {low_model, high_model}) {
+        for (auto &output : m->get_outputs()) {
+            TEST_ASSERT_EQUAL(true, output.second->equal(ref_model->get_output(output.first), 0, true));
+        }
+    }
+    delete low_model;
+    delete high_model;
+    delete ref_model;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
 TEST_CASE("Test dl module API: run()", "[api]")
 {
     ESP_LOGI(TAG, "Test dl module API: run()");
@@ -127,3 +478,955 @@ TEST_CASE("Test dl module API: run()", "[api]")
     int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
     TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
 }
+
+TEST_CASE("Test dl module API: bind()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: bind()");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    TensorBase *input1 = new TensorBase({1, 3, 64, 64}, nullptr, 0, DATA_TYPE_INT8);
+    TensorBase *input2 = new TensorBase({1, 1, 1, 64}, nullptr, 0, DATA_TYPE_INT8);
+    TensorBase *relu_output = new TensorBase({1, 3, 64, 64}, nullptr, 0, DATA_TYPE_INT8);
+    TensorBase *output = new TensorBase({1, 3, 64, 64}, nullptr, 0, DATA_TYPE_INT8);
+
+    // chain standalone modules: add(relu(input1), input2)
+    module::Module *relu_op = new module::Relu("relu", MODULE_NON_INPLACE, QUANT_TYPE_SYMM_8BIT);
+    module::Module *add_op = new module::Add("add", MODULE_NON_INPLACE, QUANT_TYPE_SYMM_8BIT);
+    relu_op->bind({input1}, {relu_output});
+    add_op->bind({relu_output, input2}, {output});
+    relu_op->run();
+    add_op->run();
+
+    // bound modules and repeated run(input, output) do not allocate
+    int ram_size_bound = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    for (int i = 0; i < 10; i++) {
+        relu_op->run();
+        add_op->run();
+        relu_op->run(input1, relu_output);
+    }
+    TEST_ASSERT_EQUAL(true, ram_size_bound == heap_caps_get_free_size(MALLOC_CAP_8BIT));
+    TEST_ASSERT_EQUAL(1, relu_op->m_inputs_index.size());
+    TEST_ASSERT_EQUAL(1, relu_op->m_outputs_index.size());
+    TEST_ASSERT_EQUAL(2, add_op->m_inputs_index.size());
+    TEST_ASSERT_EQUAL(1, add_op->m_outputs_index.size());
+
+    for (int i = 0; i < output->get_size(); i++) {
+        int8_t in1 = input1->get_element<int8_t>(i);
+        int8_t in2 = input2->get_element<int8_t>(i % 64);
+        int8_t out = output->get_element<int8_t>(i);
+        TEST_ASSERT_EQUAL(true, (in1 > 0 ? in1 : 0) + in2 == out);
+    }
+
+    delete input1;
+    delete input2;
+    delete relu_output;
+    delete output;
+    delete relu_op;
+    delete add_op;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+TEST_CASE("Test dl module API: LUT::get_synthesized_table()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: LUT::get_synthesized_table()");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    TensorBase *input = new TensorBase({1, 256}, nullptr, -4, DATA_TYPE_INT8);
+    TensorBase *sigmoid_output = new TensorBase({1, 256}, nullptr, -7, DATA_TYPE_INT8);
+    TensorBase *lut_output = new TensorBase({1, 256}, nullptr, -7, DATA_TYPE_INT8);
+    int8_t *input_ptr = (int8_t *)input->get_element_ptr();
+    for (int i = 0; i < 256; i++) {
+        input_ptr[i] = i - 128;
+    }
+
+    module::Module *sigmoid_op = new module::Sigmoid("sigmoid", MODULE_NON_INPLACE, QUANT_TYPE_SYMM_8BIT);
+    std::string key;
+    ActivationFunction func = sigmoid_op->get_lut_function(key);
+    TEST_ASSERT_EQUAL(true, func != nullptr);
+    TensorBase *table = module::LUT::get_synthesized_table(key, func, -4, -7, QUANT_TYPE_SYMM_8BIT);
+    // the same key and exponents share one table
+    TEST_ASSERT_EQUAL(true, table == module::LUT::get_synthesized_table(key, func, -4, -7, QUANT_TYPE_SYMM_8BIT));
+    TEST_ASSERT_EQUAL(true, module::LUT::release_synthesized_table(table));
+
+    module::Module *lut_op = new module::LUT("lut", table, MODULE_NON_INPLACE, QUANT_TYPE_SYMM_8BIT);
+    sigmoid_op->run(input, sigmoid_output);
+    lut_op->run(input, lut_output);
+    for (int i = 0; i < 256; i++) {
+        TEST_ASSERT_EQUAL(sigmoid_output->get_element<int8_t>(i), lut_output->get_element<int8_t>(i));
+    }
+
+    delete input;
+    delete sigmoid_output;
+    delete lut_output;
+    delete sigmoid_op;
+    delete lut_op; // release the last reference of table
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+static void fill_rnn_tensor(TensorBase *tensor, int step, int range)
+{
+    for (int i = 0; i < tensor->get_size(); i++) {
+        int value = (i * step) % (2 * range + 1) - range;
+        if (tensor->get_dtype() == DATA_TYPE_FLOAT) {
+            tensor->get_element_ptr<float>()[i] = value / 16.f;
+        } else if (tensor->get_dtype() == DATA_TYPE_INT16) {
+            tensor->get_element_ptr<int16_t>()[i] = value;
+        } else {
+            tensor->get_element_ptr<int8_t>()[i] = value;
+        }
+    }
+}
+
+// Run LSTM or GRU on 3 sequences at once and on every sequence alone, the outputs must be the same.
+template <typename T>
+static bool rnn_batch_equal_single(bool lstm, int layout, int direction_num)
+{
+    const int seq_length = 4;
+    const int batch_size = 3;
+    const int input_size = 5;
+    const int hidden_size = 6;
+    const int gate_exponent = -8;
+    int gate_size = (lstm ? 4 : 3) * hidden_size;
+    bool quant = std::is_same<T, int8_t>::value;
+    dtype_t dtype = quant ? DATA_TYPE_INT8 : DATA_TYPE_FLOAT;
+    dtype_t state_dtype = quant ? DATA_TYPE_INT16 : DATA_TYPE_FLOAT;
+    quant_type_t quant_type = quant ? QUANT_TYPE_SYMM_8BIT : QUANT_TYPE_FLOAT32;
+
+    auto x_shape = [&](int batch) {
+        return layout == 0 ? std::vector<int>{seq_length, batch, input_size}
+                           : std::vector<int>{batch, seq_length, input_size};
+    };
+    auto y_shape = [&](int batch) {
+        return layout == 0 ? std::vector<int>{seq_length, direction_num, batch, hidden_size}
+                           : std::vector<int>{batch, seq_length, direction_num, hidden_size};
+    };
+    auto state_shape = [&](int batch) {
+        return layout == 0 ? std::vector<int>{direction_num, batch, hidden_size}
+                           : std::vector<int>{batch, direction_num, hidden_size};
+    };
+
+    // h is at exponent -6, w_shift = -8 - (-4 + -6) = 2, r_shift = -8 - (-6 + -6) = 4
+    TensorBase *w = new TensorBase({direction_num, gate_size, input_size}, nullptr, -6, dtype);
+    TensorBase *r = new TensorBase({direction_num, gate_size, hidden_size}, nullptr, -6, dtype);
+    TensorBase *bias = new TensorBase({direction_num, 2 * gate_size}, nullptr, gate_exponent, state_dtype);
+    TensorBase *x = new TensorBase(x_shape(batch_size), nullptr, -4, dtype);
+    std::vector<TensorBase *> outputs = {new TensorBase(y_shape(batch_size), nullptr, -6, dtype),
+                                         new TensorBase(state_shape(batch_size), nullptr, -6, dtype)};
+    TensorBase *x_single = new TensorBase(x_shape(1), nullptr, -4, dtype);
+    std::vector<TensorBase *> outputs_single = {new TensorBase(y_shape(1), nullptr, -6, dtype),
+                                                new TensorBase(state_shape(1), nullptr, -6, dtype)};
+    if (lstm) {
+        outputs.push_back(new TensorBase(state_shape(batch_size), nullptr, gate_exponent, state_dtype));
+        outputs_single.push_back(new TensorBase(state_shape(1), nullptr, gate_exponent, state_dtype));
+    }
+    fill_rnn_tensor(w, 7, 12);
+    fill_rnn_tensor(r, 5, 12);
+    fill_rnn_tensor(bias, 3, 20);
+    fill_rnn_tensor(x, 11, 15);
+
+    module::Module *rnn_op = nullptr;
+    if (lstm) {
+        rnn_op = new module::LSTM(
+            "lstm", hidden_size, direction_num, layout, gate_exponent, MODULE_NON_INPLACE, quant_type);
+    } else {
+        rnn_op =
+            new module::GRU("gru", hidden_size, direction_num, layout, gate_exponent, MODULE_NON_INPLACE, quant_type);
+    }
+    rnn_op->run({x, w, r, bias}, outputs);
+
+    bool equal = true;
+    int bytes = x->get_dtype_bytes();
+    for (int b = 0; b < batch_size; b++) {
+        for (int seq = 0; seq < seq_length; seq++) {
+            int index = layout == 0 ? seq * batch_size + b : b * seq_length + seq;
+            memcpy(x_single->get_element_ptr<int8_t>() + seq * input_size * bytes,
+                   x->get_element_ptr<int8_t>() + index * input_size * bytes,
+                   input_size * bytes);
+        }
+        rnn_op->run({x_single, w, r, bias}, outputs_single);
+
+        for (int seq = 0; seq < seq_length; seq++) {
+            for (int di = 0; di < direction_num; di++) {
+                int index = layout == 0 ? (seq * direction_num + di) * batch_size + b
+                                        : (b * seq_length + seq) * direction_num + di;
+                int single_index = seq * direction_num + di;
+                int8_t *y = outputs[0]->get_element_ptr<int8_t>() + index * hidden_size * bytes;
+                int8_t *y_single = outputs_single[0]->get_element_ptr<int8_t>() + single_index * hidden_size * bytes;
+                equal &= memcmp(y, y_single, hidden_size * bytes) == 0;
+            }
+        }
+        for (size_t i = 1; i < outputs.size(); i++) {
+            int state_bytes = outputs[i]->get_dtype_bytes();
+            for (int di = 0; di < direction_num; di++) {
+                int index = layout == 0 ? di * batch_size + b : b * direction_num + di;
+                int8_t *state = outputs[i]->get_element_ptr<int8_t>() + index * hidden_size * state_bytes;
+                int8_t *state_single = outputs_single[i]->get_element_ptr<int8_t>() + di * hidden_size * state_bytes;
+                equal &= memcmp(state, state_single, hidden_size * state_bytes) == 0;
+            }
+        }
+    }
+
+    delete rnn_op;
+    delete w;
+    delete r;
+    delete bias;
+    delete x;
+    delete x_single;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        delete outputs[i];
+        delete outputs_single[i];
+    }
+    return equal;
+}
+
+TEST_CASE("Test dl module API: LSTM and GRU with batch > 1", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: LSTM and GRU with batch > 1");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    for (int layout = 0; layout < 2; layout++) {
+        for (int direction_num = 1; direction_num <= 2; direction_num++) {
+            TEST_ASSERT_EQUAL(true, rnn_batch_equal_single<int8_t>(true, layout, direction_num));
+            TEST_ASSERT_EQUAL(true, rnn_batch_equal_single<int8_t>(false, layout, direction_num));
+            TEST_ASSERT_EQUAL(true, rnn_batch_equal_single<float>(true, layout, direction_num));
+            TEST_ASSERT_EQUAL(true, rnn_batch_equal_single<float>(false, layout, direction_num));
+        }
+    }
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+// Feed a stream of frames to StreamingCache in copy mode and ring view mode for several wrap-arounds of the ring.
+// Every output must be the last frames of the stream, and the zero initialized cache before the stream.
+static bool streaming_cache_ring_equal_copy(int input_frames, int window_size)
+{
+    const int frame_size = 16; // int8, a frame is 16 bytes aligned as ring view mode requires
+    int output_frames = input_frames + window_size - 1;
+    TensorBase *input = new TensorBase({1, input_frames, frame_size}, nullptr, 0, DATA_TYPE_INT8);
+    // Copy mode: output owns its memory.
+    TensorBase *copy_output = new TensorBase({1, output_frames, frame_size}, nullptr, 0, DATA_TYPE_INT8);
+    // Ring view mode: output doesn't own its memory, like the tensors planned by the memory manager of Model.
+    void *ring_output_buffer = tool::malloc_aligned(16, output_frames * frame_size, MALLOC_CAP_DEFAULT);
+    TensorBase *ring_output =
+        new TensorBase({1, output_frames, frame_size}, ring_output_buffer, 0, DATA_TYPE_INT8, false);
+    void *copy_output_buffer = copy_output->get_element_ptr();
+    module::Module *copy_op = new module::StreamingCache("copy", window_size, 1);
+    module::Module *ring_op = new module::StreamingCache("ring", window_size, 1);
+
+    // The ring holds 2 windows and wraps every about output_frames / input_frames forwards.
+    int steps = 4 * output_frames / input_frames + 1;
+    bool equal = true;
+    for (int step = 0; step < steps; step++) {
+        for (int f = 0; f < input_frames; f++) {
+            int frame = step * input_frames + f;
+            memset(input->get_element_ptr<int8_t>() + f * frame_size, frame % 127 + 1, frame_size);
+        }
+        copy_op->run(input, copy_output);
+        ring_op->run(input, ring_output);
+
+        equal &= copy_output->get_element_ptr() == copy_output_buffer;
+        equal &= ring_output->get_element_ptr() != ring_output_buffer;
+        equal &= memcmp(copy_output->get_element_ptr(), ring_output->get_element_ptr(), copy_output->get_bytes()) == 0;
+        for (int i = 0; i < output_frames; i++) {
+            int frame = (step + 1) * input_frames - output_frames + i;
+            int8_t expected = frame < 0 ? 0 : frame % 127 + 1;
+            for (int j = 0; j < frame_size; j++) {
+                equal &= copy_output->get_element_ptr<int8_t>()[i * frame_size + j] == expected;
+            }
+        }
+    }
+
+    delete copy_op;
+    delete ring_op;
+    delete input;
+    delete copy_output;
+    delete ring_output;
+    heap_caps_free(ring_output_buffer);
+    return equal;
+}
+
+TEST_CASE("Test dl module API: StreamingCache ring view", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: StreamingCache ring view");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    TEST_ASSERT_EQUAL(true, streaming_cache_ring_equal_copy(1, 5));
+    TEST_ASSERT_EQUAL(true, streaming_cache_ring_equal_copy(2, 4));
+    TEST_ASSERT_EQUAL(true, streaming_cache_ring_equal_copy(3, 3));
+    TEST_ASSERT_EQUAL(true, streaming_cache_ring_equal_copy(4, 1));
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+TEST_CASE("Test dl module API: module_parallel_for()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: module_parallel_for()");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    TensorBase *input = new TensorBase({4, 1024}, nullptr, -4, DATA_TYPE_INT8);
+    TensorBase *single_core_output = new TensorBase({4, 1024}, nullptr, -7, DATA_TYPE_INT8);
+    TensorBase *multi_core_output = new TensorBase({4, 1024}, nullptr, -7, DATA_TYPE_INT8);
+    int8_t *input_ptr = (int8_t *)input->get_element_ptr();
+    for (int i = 0; i < input->get_size(); i++) {
+        input_ptr[i] = i % 256 - 128;
+    }
+
+    // every iteration runs exactly once
+    std::vector<int> counts(1001, 0);
+    module::module_parallel_for(counts.size(), RUNTIME_MODE_MULTI_CORE, [&](int start, int end) {
+        for (int i = start; i < end; i++) {
+            counts[i]++;
+        }
+    });
+    for (int i = 0; i < counts.size(); i++) {
+        TEST_ASSERT_EQUAL(1, counts[i]);
+    }
+
+    module::Module *sigmoid_op = new module::Sigmoid("sigmoid", MODULE_NON_INPLACE, QUANT_TYPE_SYMM_8BIT);
+    sigmoid_op->run(input, single_core_output, RUNTIME_MODE_SINGLE_CORE);
+    sigmoid_op->run(input, multi_core_output, RUNTIME_MODE_MULTI_CORE);
+    for (int i = 0; i < input->get_size(); i++) {
+        TEST_ASSERT_EQUAL(single_core_output->get_element<int8_t>(i), multi_core_output->get_element<int8_t>(i));
+    }
+
+    delete input;
+    delete single_core_output;
+    delete multi_core_output;
+    delete sigmoid_op;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+TEST_CASE("Test dl module API: Conv with 1 < group < C", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: Conv with 1 < group < C");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    // 2 groups, filter [3, 3, 4, 8] in sequence [N, H, W, C / group], pads 1
+    TensorBase *input = new TensorBase({1, 6, 6, 8}, nullptr, -4, DATA_TYPE_INT8);
+    TensorBase *filter = new TensorBase({3, 3, 4, 8}, nullptr, -6, DATA_TYPE_INT8);
+    TensorBase *output = new TensorBase({1, 6, 6, 8}, nullptr, -2, DATA_TYPE_INT8);
+    int8_t *input_ptr = (int8_t *)input->get_element_ptr();
+    int8_t *filter_ptr = (int8_t *)filter->get_element_ptr();
+    for (int i = 0; i < input->get_size(); i++) {
+        input_ptr[i] = i % 61 - 30;
+    }
+    for (int i = 0; i < filter->get_size(); i++) {
+        filter_ptr[i] = i % 37 - 18;
+    }
+
+    module::Module *conv_op = new module::Conv(Linear, {1, 1, 1, 1}, {1, 1}, {1, 1}, "conv", 2, QUANT_TYPE_SYMM_8BIT);
+    conv_op->run({input, filter}, {output}, RUNTIME_MODE_SINGLE_CORE);
+
+    // mac_shift = -2 - (-6) - (-4) = 8
+    for (int y = 0; y < 6; y++) {
+        for (int x = 0; x < 6; x++) {
+            for (int n = 0; n < 8; n++) {
+                int g = n / 4;
+                int32_t acc = 0;
+                for (int ky = 0; ky < 3; ky++) {
+                    for (int kx = 0; kx < 3; kx++) {
+                        int iy = y + ky - 1;
+                        int ix = x + kx - 1;
+                        if (iy < 0 || iy >= 6 || ix < 0 || ix >= 6) {
+                            continue;
+                        }
+                        int8_t *input_yx = input_ptr + (iy * 6 + ix) * 8 + g * 4;
+                        int8_t *filter_yx = filter_ptr + ((n * 3 + ky) * 3 + kx) * 4;
+                        for (int c = 0; c < 4; c++) {
+                            acc += input_yx[c] * filter_yx[c];
+                        }
+                    }
+                }
+                int8_t ref;
+                tool::truncate(ref, tool::shift_and_round(acc, 8));
+                TEST_ASSERT_EQUAL(ref, output->get_element<int8_t>((y * 6 + x) * 8 + n));
+            }
+        }
+    }
+
+    delete input;
+    delete filter;
+    delete output;
+    delete conv_op;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+#if !CONFIG_TIE728_BOOST && !CONFIG_ESP32P4_BOOST
+// conv2d() of ISA targets reads the filter in their own layout, conv2d_winograd() only runs on C/C++ targets
+template <typename T>
+static bool conv2d_winograd_equal_conv2d(
+    int height, int width, std::vector<int> pads, bool with_bias, activation_type_t activation)
+{
+    typedef typename std::conditional<std::is_same<T, int8_t>::value, int32_t, int64_t>::type buffer_t;
+    dtype_t dtype = std::is_same<T, int8_t>::value ? DATA_TYPE_INT8 : DATA_TYPE_INT16;
+    dtype_t bias_dtype = std::is_same<T, int8_t>::value ? DATA_TYPE_INT32 : DATA_TYPE_INT64;
+    int input_max = std::is_same<T, int8_t>::value ? 30 : 2000;
+    int filter_max = std::is_same<T, int8_t>::value ? 18 : 1000;
+    int input_channel = 5;
+    int output_channel = 6;
+    int output_height = height + pads[0] + pads[1] - 2;
+    int output_width = width + pads[2] + pads[3] - 2;
+
+    // filter [3, 3, 5, 6] in sequence [N, H, W, C], mac_shift = 12 for int16_t and 6 for int8_t
+    TensorBase *input = new TensorBase({1, height, width, input_channel}, nullptr, -8, dtype);
+    TensorBase *filter = new TensorBase({3, 3, input_channel, output_channel}, nullptr, -10, dtype);
+    TensorBase *bias = with_bias ? new TensorBase({output_channel}, nullptr, -18, bias_dtype) : nullptr;
+    int output_exponent = std::is_same<T, int8_t>::value ? -12 : -6;
+    TensorBase *output =
+        new TensorBase({1, output_height, output_width, output_channel}, nullptr, output_exponent, dtype);
+    TensorBase *winograd_output =
+        new TensorBase({1, output_height, output_width, output_channel}, nullptr, output_exponent, dtype);
+    T *input_ptr = (T *)input->get_element_ptr();
+    T *filter_ptr = (T *)filter->get_element_ptr();
+    for (int i = 0; i < input->get_size(); i++) {
+        input_ptr[i] = (i * 97) % (2 * input_max + 1) - input_max;
+    }
+    for (int i = 0; i < filter->get_size(); i++) {
+        filter_ptr[i] = (i * 31) % (2 * filter_max + 1) - filter_max;
+    }
+    if (bias) {
+        buffer_t *bias_ptr = (buffer_t *)bias->get_element_ptr();
+        for (int n = 0; n < output_channel; n++) {
+            bias_ptr[n] = (n - 3) * input_max * filter_max;
+        }
+    }
+
+    std::vector<int> strides = {1, 1};
+    std::vector<int> dilations = {1, 1};
+    std::vector<base::ArgsType<T>> args = base::get_conv_operation_args<T>(
+        output, input, pads, filter, strides, dilations, 1, bias, activation, nullptr, RUNTIME_MODE_SINGLE_CORE);
+    std::vector<base::ArgsType<T>> winograd_args = base::get_conv_operation_args<T>(winograd_output,
+                                                                                   input,
+                                                                                   pads,
+                                                                                   filter,
+                                                                                   strides,
+                                                                                   dilations,
+                                                                                   1,
+                                                                                   bias,
+                                                                                   activation,
+                                                                                   nullptr,
+                                                                                   RUNTIME_MODE_SINGLE_CORE);
+    void *winograd_filter =
+        base::conv2d_winograd_transform_filter<T>(filter_ptr, output_channel, input_channel, MALLOC_CAP_DEFAULT);
+    bool equal = winograd_filter != nullptr;
+    if (equal) {
+        winograd_args[0].winograd_filter_element = winograd_filter;
+        base::conv2d<T, int32_t, buffer_t>((void *)&args[0]);
+        base::conv2d_winograd<T, int32_t, buffer_t>((void *)&winograd_args[0]);
+        equal = memcmp(output->get_element_ptr(), winograd_output->get_element_ptr(), output->get_bytes()) == 0;
+    }
+
+    heap_caps_free(winograd_filter);
+    delete input;
+    delete filter;
+    delete bias;
+    delete output;
+    delete winograd_output;
+    return equal;
+}
+
+TEST_CASE("Test dl base API: conv2d_winograd()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl base API: conv2d_winograd()");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    // pads in [top, bottom, left, right], output 7x5, 4x7, 4x5, 4x4 and 1x1
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int8_t>(7, 5, {1, 1, 1, 1}, true, ReLU));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int8_t>(6, 9, {0, 0, 0, 0}, false, Linear));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int8_t>(5, 6, {0, 1, 1, 0}, true, Linear));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int8_t>(4, 4, {1, 1, 1, 1}, false, ReLU));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int8_t>(3, 3, {0, 0, 0, 0}, true, Linear));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int16_t>(7, 5, {1, 1, 1, 1}, true, ReLU));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int16_t>(6, 9, {0, 0, 0, 0}, false, Linear));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int16_t>(5, 6, {0, 1, 1, 0}, true, Linear));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int16_t>(4, 4, {1, 1, 1, 1}, false, ReLU));
+    TEST_ASSERT_EQUAL(true, conv2d_winograd_equal_conv2d<int16_t>(3, 3, {0, 0, 0, 0}, true, Linear));
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+#endif
+
+#if !CONFIG_TIE728_BOOST && !CONFIG_ESP32P4_BOOST
+// per-channel Conv and Gemm are only supported on C/C++ targets
+TEST_CASE("Test dl module API: Conv with per-channel quantization", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: Conv with per-channel quantization");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    // filter [3, 3, 8, 8] in sequence [N, H, W, C], pads 1, one exponent per output channel
+    std::vector<int> filter_exponents = {-6, -7, -5, -8, -6, -9, -5, -7};
+    TensorBase *input = new TensorBase({1, 5, 5, 8}, nullptr, -4, DATA_TYPE_INT8);
+    TensorBase *filter = new TensorBase({3, 3, 8, 8}, nullptr, -6, DATA_TYPE_INT8);
+    TensorBase *bias = new TensorBase({8}, nullptr, -10, DATA_TYPE_INT32);
+    TensorBase *output = new TensorBase({1, 5, 5, 8}, nullptr, -2, DATA_TYPE_INT8);
+    int8_t *input_ptr = (int8_t *)input->get_element_ptr();
+    int8_t *filter_ptr = (int8_t *)filter->get_element_ptr();
+    int32_t *bias_ptr = (int32_t *)bias->get_element_ptr();
+    for (int i = 0; i < input->get_size(); i++) {
+        input_ptr[i] = i % 61 - 30;
+    }
+    for (int i = 0; i < filter->get_size(); i++) {
+        filter_ptr[i] = i % 37 - 18;
+    }
+    for (int n = 0; n < 8; n++) {
+        bias_ptr[n] = (n - 4) * 1000; // exponent input + filter_exponents[n]
+    }
+
+    module::Module *conv_op = new module::Conv(
+        ReLU, {1, 1, 1, 1}, {1, 1}, {1, 1}, "conv", 1, QUANT_TYPE_SYMM_8BIT, filter_exponents);
+    conv_op->run({input, filter, bias}, {output}, RUNTIME_MODE_SINGLE_CORE);
+
+    for (int y = 0; y < 5; y++) {
+        for (int x = 0; x < 5; x++) {
+            for (int n = 0; n < 8; n++) {
+                int32_t acc = bias_ptr[n];
+                for (int ky = 0; ky < 3; ky++) {
+                    for (int kx = 0; kx < 3; kx++) {
+                        int iy = y + ky - 1;
+                        int ix = x + kx - 1;
+                        if (iy < 0 || iy >= 5 || ix < 0 || ix >= 5) {
+                            continue;
+                        }
+                        int8_t *input_yx = input_ptr + (iy * 5 + ix) * 8;
+                        int8_t *filter_yx = filter_ptr + ((n * 3 + ky) * 3 + kx) * 8;
+                        for (int c = 0; c < 8; c++) {
+                            acc += input_yx[c] * filter_yx[c];
+                        }
+                    }
+                }
+                // mac_shift of channel n = -2 - filter_exponents[n] - (-4)
+                acc = tool::shift_and_round(acc, 2 - filter_exponents[n]);
+                int8_t ref;
+                tool::truncate(ref, DL_MAX(acc, 0));
+                TEST_ASSERT_EQUAL(ref, output->get_element<int8_t>((y * 5 + x) * 8 + n));
+            }
+        }
+    }
+
+    delete input;
+    delete filter;
+    delete bias;
+    delete output;
+    delete conv_op;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+#endif
+
+TEST_CASE("Test dl model API: load() per-tensor Conv and Gemm", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl model API: load() per-tensor Conv and Gemm");
+    Model *model = new Model("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    delete model;
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    // The fbs loader only supports PER_TENSOR quantization, Conv and Gemm loaded from .espdl must run per-tensor.
+    fbs::FbsLoader *fbs_loader = new fbs::FbsLoader("model", fbs::MODEL_LOCATION_IN_FLASH_PARTITION);
+    int filter_num = 0;
+    for (int i = 0; i < fbs_loader->get_model_num(); i++) {
+        fbs::FbsModel *fbs_model = fbs_loader->load(i);
+        for (std::string &node_name : fbs_model->topological_sort()) {
+            std::string op_type = fbs_model->get_operation_type(node_name);
+            if (op_type != "Conv" && op_type != "Gemm") {
+                continue;
+            }
+            std::vector<std::string> inputs;
+            std::vector<std::string> outputs;
+            fbs_model->get_operation_inputs_and_outputs(node_name, inputs, outputs);
+            TEST_ASSERT_EQUAL(true, inputs.size() >= 2 && fbs_model->is_parameter(inputs[1]));
+            TEST_ASSERT_EQUAL(1, fbs_model->get_tensor_exponents(inputs[1]).size());
+            filter_num++;
+        }
+
+        model = new Model(fbs_model);
+        TEST_ASSERT_EQUAL(ESP_OK, model->test());
+        delete model;
+        delete fbs_model;
+    }
+    TEST_ASSERT_EQUAL(true, filter_num > 0);
+    delete fbs_loader;
+    module::ModuleCreator::get_instance()->clear();
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+TEST_CASE("Test dl module API: Conv and dotprod with int4 filter", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: Conv and dotprod with int4 filter");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    // 1x1 filter [1, 1, 7, 6] in sequence [N, 1, 1, C], C is odd so that every other filter starts in a high nibble
+    std::vector<int> filter_exponents = {-3, -4, -2, -3, -5, -4};
+    TensorBase *input = new TensorBase({1, 4, 4, 7}, nullptr, -4, DATA_TYPE_INT8);
+    TensorBase *filter4 = new TensorBase({1, 1, 7, 6}, nullptr, -3, DATA_TYPE_INT4);
+    TensorBase *filter8 = new TensorBase({1, 1, 7, 6}, nullptr, -3, DATA_TYPE_INT8);
+    TensorBase *bias = new TensorBase({6}, nullptr, -7, DATA_TYPE_INT32);
+    TensorBase *output4 = new TensorBase({1, 4, 4, 6}, nullptr, -3, DATA_TYPE_INT8);
+    TensorBase *output8 = new TensorBase({1, 4, 4, 6}, nullptr, -3, DATA_TYPE_INT8);
+    TEST_ASSERT_EQUAL(21, filter4->get_bytes());
+    int8_t *input_ptr = (int8_t *)input->get_element_ptr();
+    uint8_t *filter4_ptr = (uint8_t *)filter4->get_element_ptr();
+    int8_t *filter8_ptr = (int8_t *)filter8->get_element_ptr();
+    int32_t *bias_ptr = (int32_t *)bias->get_element_ptr();
+    for (int i = 0; i < input->get_size(); i++) {
+        input_ptr[i] = i % 61 - 30;
+    }
+    for (int i = 0; i < filter8->get_size(); i++) {
+        filter8_ptr[i] = i % 16 - 8;
+        filter4_ptr[i / 2] |= (filter8_ptr[i] & 0xf) << (i % 2 * 4);
+        TEST_ASSERT_EQUAL(filter8_ptr[i], tool::get_int4(filter4_ptr, i));
+    }
+    for (int n = 0; n < 6; n++) {
+        bias_ptr[n] = (n - 3) * 100;
+    }
+
+    // the unpacked int8 filter gives the reference
+    module::Module *conv4_op =
+        new module::Conv(ReLU, {0, 0, 0, 0}, {1, 1}, {1, 1}, "conv4", 1, QUANT_TYPE_SYMM_8BIT, filter_exponents);
+    module::Module *conv8_op =
+        new module::Conv(ReLU, {0, 0, 0, 0}, {1, 1}, {1, 1}, "conv8", 1, QUANT_TYPE_SYMM_8BIT, filter_exponents);
+    conv4_op->run({input, filter4, bias}, {output4}, RUNTIME_MODE_SINGLE_CORE);
+    conv8_op->run({input, filter8, bias}, {output8}, RUNTIME_MODE_SINGLE_CORE);
+    TEST_ASSERT_EQUAL(true, output4->equal(output8, 0));
+
+    for (int length = 6; length <= 7; length++) {
+        int16_t result4, result8;
+        base::dotprod_int4(filter4_ptr, input_ptr, &result4, length, 2);
+        base::dotprod(filter8_ptr, input_ptr, &result8, length, 2);
+        TEST_ASSERT_EQUAL(result8, result4);
+    }
+
+    delete input;
+    delete filter4;
+    delete filter8;
+    delete bias;
+    delete output4;
+    delete output8;
+    delete conv4_op;
+    delete conv8_op;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+#if !CONFIG_TIE728_BOOST && !CONFIG_ESP32P4_BOOST
+// ISA targets keep the dense 1x1 kernels, which read the filter and bias in their own layout
+TEST_CASE("Test dl module API: Conv with block-sparse filter", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: Conv with block-sparse filter");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    // 1x1 filter [1, 1, 40, 8] in sequence [N, 1, 1, C], 3 blocks of 16 channels per filter, the last one has 8
+    TensorBase *input = new TensorBase({1, 4, 4, 40}, nullptr, -4, DATA_TYPE_INT8);
+    TensorBase *filter = new TensorBase({1, 1, 40, 8}, nullptr, -6, DATA_TYPE_INT8);
+    TensorBase *bias = new TensorBase({8}, nullptr, -10, DATA_TYPE_INT32);
+    TensorBase *output = new TensorBase({1, 4, 4, 8}, nullptr, -2, DATA_TYPE_INT8);
+    int8_t *input_ptr = (int8_t *)input->get_element_ptr();
+    int8_t *filter_ptr = (int8_t *)filter->get_element_ptr();
+    int32_t *bias_ptr = (int32_t *)bias->get_element_ptr();
+    for (int i = 0; i < input->get_size(); i++) {
+        input_ptr[i] = i % 61 - 30;
+    }
+    // only block (n % 3) of filter n is nonzero, 16 of 24 blocks are zero
+    for (int i = 0; i < filter->get_size(); i++) {
+        filter_ptr[i] = (i % 40) / 16 == (i / 40) % 3 ? i % 37 - 18 : 0;
+    }
+    for (int n = 0; n < 8; n++) {
+        bias_ptr[n] = (n - 4) * 1000;
+    }
+
+    base::sparse_filter_t *sparse = base::conv2d_sparse_pack_filter<int8_t>(filter_ptr, 8, 40, 0.5f);
+    TEST_ASSERT_EQUAL(true, sparse != nullptr);
+    TEST_ASSERT_EQUAL(8, sparse->nonzero_blocks);
+    TEST_ASSERT_EQUAL(true, sparse->bitmap[5] == 1u << 2);
+    heap_caps_free(sparse);
+    TEST_ASSERT_EQUAL(true, base::conv2d_sparse_pack_filter<int8_t>(filter_ptr, 8, 40, 0.7f) == nullptr);
+
+    module::Module *conv_op = new module::Conv(ReLU, {0, 0, 0, 0}, {1, 1}, {1, 1}, "conv", 1, QUANT_TYPE_SYMM_8BIT);
+    conv_op->run({input, filter, bias}, {output}, RUNTIME_MODE_SINGLE_CORE);
+
+    // mac_shift = -2 - (-6) - (-4) = 8
+    for (int i = 0; i < 16; i++) {
+        for (int n = 0; n < 8; n++) {
+            int32_t acc = bias_ptr[n];
+            for (int c = 0; c < 40; c++) {
+                acc += input_ptr[i * 40 + c] * filter_ptr[n * 40 + c];
+            }
+            int8_t ref;
+            tool::truncate(ref, DL_MAX(tool::shift_and_round(acc, 8), 0));
+            TEST_ASSERT_EQUAL(ref, output->get_element<int8_t>(i * 8 + n));
+        }
+    }
+
+    delete input;
+    delete filter;
+    delete bias;
+    delete output;
+    delete conv_op;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+#endif
+
+TEST_CASE("Test dl module API: Resize int16", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl module API: Resize int16");
+    int total_ram_size_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    TensorBase *input = new TensorBase({1, 4, 5, 3}, nullptr, -8, DATA_TYPE_INT16);
+    TensorBase *output = new TensorBase({1, 8, 10, 3}, nullptr, -9, DATA_TYPE_INT16);
+    int16_t *input_ptr = (int16_t *)input->get_element_ptr();
+    for (int i = 0; i < input->get_size(); i++) {
+        input_ptr[i] = (i * 7919) % 32768 - 16384;
+    }
+
+    // half_pixel 2x bilinear, the weights of every axis are 1/4 and 3/4 with the border clamped
+    module::Module *resize_op =
+        new module::Resize("resize", RESIZE_LINEAR, {1, 1, 2, 2}, {}, false, QUANT_TYPE_SYMM_16BIT);
+    resize_op->run({input}, {output}, RUNTIME_MODE_SINGLE_CORE);
+    for (int y = 0; y < 8; y++) {
+        int y0 = y & 1 ? y / 2 : DL_MAX(y / 2 - 1, 0);
+        int y1 = y & 1 ? DL_MIN(y / 2 + 1, 3) : y / 2;
+        int wy0 = y & 1 ? 3 : 1;
+        for (int x = 0; x < 10; x++) {
+            int x0 = x & 1 ? x / 2 : DL_MAX(x / 2 - 1, 0);
+            int x1 = x & 1 ? DL_MIN(x / 2 + 1, 4) : x / 2;
+            int wx0 = x & 1 ? 3 : 1;
+            int16_t *row0 = input_ptr + y0 * 5 * 3;
+            int16_t *row1 = input_ptr + y1 * 5 * 3;
+            for (int c = 0; c < 3; c++) {
+                int32_t acc = wy0 * (wx0 * row0[x0 * 3 + c] + (4 - wx0) * row0[x1 * 3 + c]) +
+                    (4 - wy0) * (wx0 * row1[x0 * 3 + c] + (4 - wx0) * row1[x1 * 3 + c]);
+                // weights are in 1/16, output_exponent - input_exponent = -1
+                int16_t ref;
+                tool::truncate(ref, tool::shift_and_round(acc, 4 - 1));
+                TEST_ASSERT_EQUAL(ref, output->get_element<int16_t>((y * 10 + x) * 3 + c));
+            }
+        }
+    }
+    delete resize_op;
+    delete output;
+
+    // identity scale only requantizes
+    output = new TensorBase({1, 4, 5, 3}, nullptr, -7, DATA_TYPE_INT16);
+    resize_op = new module::Resize("resize", RESIZE_NEAREST, {1, 1, 1, 1}, {}, false, QUANT_TYPE_SYMM_16BIT);
+    resize_op->run({input}, {output}, RUNTIME_MODE_SINGLE_CORE);
+    for (int i = 0; i < input->get_size(); i++) {
+        TEST_ASSERT_INT_WITHIN(1, input_ptr[i] / 2, output->get_element<int16_t>(i));
+    }
+
+    delete input;
+    delete output;
+    delete resize_op;
+
+    int total_ram_size_end = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    TEST_ASSERT_EQUAL(true, total_ram_size_before == total_ram_size_end);
+}
+
+TEST_CASE("Test dl math API: exp_poly(), rsqrt(), softmax()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl math API: exp_poly(), rsqrt(), softmax()");
+    for (float x = -87.f; x < 88.f; x += 0.37f) {
+        float ref = expf(x);
+        TEST_ASSERT_FLOAT_WITHIN(ref * 1e-6f, ref, math::exp_poly(x));
+    }
+    for (float x = 1e-6f; x < 1e6f; x *= 1.7f) {
+        float ref = 1.f / sqrtf(x);
+        TEST_ASSERT_FLOAT_WITHIN(ref * 1e-6f, ref, math::rsqrt(x));
+    }
+
+    // 3 softmaxes of length 37, stride 3
+    int16_t input[37 * 3];
+    float output[37 * 3];
+    for (int i = 0; i < 37 * 3; i++) {
+        input[i] = (i * 977) % 4096 - 2048;
+    }
+    float scale = DL_SCALE(-8);
+    math::softmax(input, output, 37, 3, 3, scale);
+    for (int k = 0; k < 3; k++) {
+        float max = -INFINITY;
+        for (int i = 0; i < 37; i++) {
+            max = DL_MAX(max, input[i * 3 + k] * scale);
+        }
+        float sum = 0.f;
+        for (int i = 0; i < 37; i++) {
+            sum += expf(input[i * 3 + k] * scale - max);
+        }
+        for (int i = 0; i < 37; i++) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-6f, expf(input[i * 3 + k] * scale - max) / sum, output[i * 3 + k]);
+        }
+    }
+}
+
+TEST_CASE("Test dl tool API: requantize()", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl tool API: requantize()");
+    // power of 2 rescales of exponents are bit-exact to the float path
+    for (int shift = -8; shift <= 16; shift++) {
+        float scale = DL_RESCALE(shift);
+        tool::requant_t requant = tool::get_requant(scale);
+        for (int x = INT16_MIN; x <= INT16_MAX; x++) {
+            int16_t expected;
+            tool::truncate(expected, tool::round((float)x * scale));
+            TEST_ASSERT_EQUAL_INT16(expected, tool::requantize<int16_t>(x, requant));
+        }
+    }
+
+    // other rescales are rounded from the exact product, float may round the product to a tie before
+    for (float scale : {0.1f, 1.f / 3, 1.f / 9 / 64, 0.7071f, 3.3f, -0.25f, -0.01f}) {
+        tool::requant_t requant = tool::get_requant(scale);
+        for (int x = -100000; x <= 100000; x += 7) {
+            int32_t expected;
+            tool::truncate(expected, tool::round((double)x * scale));
+            TEST_ASSERT_EQUAL_INT32(expected, tool::requantize<int32_t>(x, requant));
+        }
+    }
+}
+
+static TensorBase *get_one_hot_feat(int feat_len, int k)
+{
+    TensorBase *feat = new TensorBase({feat_len}, nullptr, 0, DATA_TYPE_FLOAT);
+    memset(feat->data, 0, feat->get_bytes());
+    ((float *)feat->data)[k] = 1.f;
+    return feat;
+}
+
+static bool db_has_feat(recognition::DataBase &db, int feat_len, int k)
+{
+    TensorBase *feat = get_one_hot_feat(feat_len, k);
+    bool found = db.query_feat(feat, 0.5f, 1).size() == 1;
+    delete feat;
+    return found;
+}
+
+static void db_enroll_one_hot_feats(recognition::DataBase &db, int feat_len, std::vector<int> ks)
+{
+    std::vector<TensorBase *> feats;
+    for (int k : ks) {
+        feats.push_back(get_one_hot_feat(feat_len, k));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, db.enroll_feats(feats));
+    for (TensorBase *feat : feats) {
+        delete feat;
+    }
+}
+
+TEST_CASE("Test dl recognition API: DataBase in partition", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl recognition API: DataBase in partition");
+    const int feat_len = 32;
+    {
+        recognition::DataBase db("feat_db", feat_len, recognition::DB_STORAGE_PARTITION, 64);
+        TEST_ASSERT_EQUAL(ESP_OK, db.clear_all_feats());
+        db_enroll_one_hot_feats(db, feat_len, {0, 1, 2, 3, 4});
+        TEST_ASSERT_EQUAL(ESP_OK, db.delete_feat(2));
+        TEST_ASSERT_EQUAL(ESP_FAIL, db.delete_feat(2));
+    }
+    {
+        // the meta alternates between two slots, the one written last is loaded
+        recognition::DataBase db("feat_db", feat_len, recognition::DB_STORAGE_PARTITION);
+        TEST_ASSERT_EQUAL(4, db.get_num_feats());
+        TEST_ASSERT_EQUAL(false, db_has_feat(db, feat_len, 1));
+        TEST_ASSERT_EQUAL(true, db_has_feat(db, feat_len, 4));
+        TEST_ASSERT_EQUAL(ESP_OK, db.delete_last_feat());
+        db_enroll_one_hot_feats(db, feat_len, {5});
+        TEST_ASSERT_EQUAL(ESP_OK, db.compact());
+        TEST_ASSERT_EQUAL(4, db.get_num_feats());
+    }
+    {
+        recognition::DataBase db("feat_db", feat_len, recognition::DB_STORAGE_PARTITION);
+        TEST_ASSERT_EQUAL(4, db.get_num_feats());
+        for (int k : {0, 2, 3, 5}) {
+            TEST_ASSERT_EQUAL(true, db_has_feat(db, feat_len, k));
+        }
+        TEST_ASSERT_EQUAL(false, db_has_feat(db, feat_len, 4));
+        TEST_ASSERT_EQUAL(ESP_OK, db.clear_all_feats());
+    }
+    recognition::DataBase db("feat_db", feat_len, recognition::DB_STORAGE_PARTITION);
+    TEST_ASSERT_EQUAL(0, db.get_num_feats());
+}
+
+TEST_CASE("Test dl recognition API: DataBase in file", "[api]")
+{
+    ESP_LOGI(TAG, "Test dl recognition API: DataBase in file");
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = "/spiffs", .partition_label = "storage", .max_files = 4, .format_if_mount_failed = true};
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_spiffs_register(&conf));
+    const int feat_len = 32;
+    const char *db_path = "/spiffs/feat.db";
+    const char *tmp_path = "/spiffs/feat.db.tmp";
+    remove(db_path);
+    remove(tmp_path);
+
+    // legacy db: {num_feats_total, num_feats_valid, feat_len}, then {id, feat} records, id 0 is deleted
+    FILE *f = fopen(db_path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    recognition::database_meta meta = {3, 2, feat_len};
+    fwrite(&meta, sizeof(meta), 1, f);
+    for (int i = 0; i < 3; i++) {
+        uint16_t id = i == 1 ? 0 : i + 1;
+        TensorBase *feat = get_one_hot_feat(feat_len, i);
+        fwrite(&id, sizeof(uint16_t), 1, f);
+        fwrite(feat->data, feat->get_bytes(), 1, f);
+        delete feat;
+    }
+    fclose(f);
+    {
+        recognition::DataBase db(db_path, feat_len);
+        TEST_ASSERT_EQUAL(2, db.get_num_feats());
+        TEST_ASSERT_EQUAL(true, db_has_feat(db, feat_len, 0));
+        TEST_ASSERT_EQUAL(false, db_has_feat(db, feat_len, 1));
+        TEST_ASSERT_EQUAL(true, db_has_feat(db, feat_len, 2));
+        TEST_ASSERT_NULL(fopen(tmp_path, "rb"));
+        db_enroll_one_hot_feats(db, feat_len, {3, 4});
+        TEST_ASSERT_EQUAL(ESP_OK, db.delete_feat(1));
+        TEST_ASSERT_EQUAL(ESP_OK, db.compact());
+    }
+    {
+        recognition::DataBase db(db_path, feat_len);
+        TEST_ASSERT_EQUAL(3, db.get_num_feats());
+        TEST_ASSERT_EQUAL(false, db_has_feat(db, feat_len, 0));
+        TEST_ASSERT_EQUAL(true, db_has_feat(db, feat_len, 4));
+    }
+
+    // the power is lost after the tombstone bit of id 3 is written and before the header
+    f = fopen(db_path, "rb+");
+    TEST_ASSERT_NOT_NULL(f);
+    recognition::database_header_t header;
+    TEST_ASSERT_EQUAL(1, fread(&header, sizeof(header), 1, f));
+    uint8_t bitmap_byte = 1 << 2;
+    TEST_ASSERT_EQUAL(0, fseek(f, header.bitmap_offset, SEEK_SET));
+    TEST_ASSERT_EQUAL(1, fwrite(&bitmap_byte, 1, 1, f));
+    fclose(f);
+    {
+        recognition::DataBase db(db_path, feat_len);
+        TEST_ASSERT_EQUAL(2, db.get_num_feats());
+        TEST_ASSERT_EQUAL(false, db_has_feat(db, feat_len, 4));
+        TEST_ASSERT_EQUAL(ESP_FAIL, db.delete_feat(3));
+    }
+
+    // the power is lost after the old db is removed and before the new one is renamed
+    TEST_ASSERT_EQUAL(0, rename(db_path, tmp_path));
+    {
+        recognition::DataBase db(db_path, feat_len);
+        TEST_ASSERT_EQUAL(2, db.get_num_feats());
+        TEST_ASSERT_EQUAL(ESP_OK, db.clear_all_feats());
+        TEST_ASSERT_EQUAL(0, db.get_num_feats());
+    }
+    remove(db_path);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_spiffs_unregister("storage"));
+}